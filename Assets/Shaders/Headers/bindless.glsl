@@ -0,0 +1,28 @@
+#ifndef BINDLESS_GLSL
+#define BINDLESS_GLSL
+
+// Needs GL_EXT_nonuniform_qualifier enabled by the including shader
+
+#include <util.glsl>
+
+struct Material
+{
+    uint albedo;
+    uint normal;
+    uint orm;
+    uint emissive;
+};
+
+layout (set = TEXTURE_SET, binding = 0) uniform sampler2D uTextures[];
+
+layout (std430, set = TEXTURE_SET, binding = 1) readonly buffer Materials
+{
+    Material uMaterials[];
+};
+
+vec4 SampleTexture(uint index, vec2 uv)
+{
+    return texture(uTextures[nonuniformEXT(index)], uv);
+}
+
+#endif
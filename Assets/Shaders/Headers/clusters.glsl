@@ -0,0 +1,67 @@
+#ifndef CLUSTERS_GLSL
+#define CLUSTERS_GLSL
+
+#include <util.glsl>
+#include <uniform_lights.glsl>
+
+// Screen tiles times exponential depth slices
+const uint CLUSTER_COUNT_X = 16;
+const uint CLUSTER_COUNT_Y = 9;
+const uint CLUSTER_COUNT_Z = 24;
+const uint MAX_LIGHTS_PER_CLUSTER = 128;
+
+// cluster.comp builds the lists, shading only reads them
+#ifdef CLUSTER_BUILD
+    #define CLUSTER_ACCESS
+#else
+    #define CLUSTER_ACCESS readonly
+#endif
+
+layout(std430, set = UNIFORM_SET, binding = 4) readonly buffer LightList
+{
+    Light uLights[];
+};
+
+layout(std140, set = UNIFORM_SET, binding = 5) uniform ClusterData
+{
+    mat4 uInverseProjection;
+    vec2 uTileSize;
+    float uSliceScale;
+    float uSliceBias;
+    float uNear;
+    float uFar;
+    float uClusterPadding0;
+    float uClusterPadding1;
+};
+
+// Offset and count into the light indices per cluster
+layout(std430, set = UNIFORM_SET, binding = 6) CLUSTER_ACCESS buffer ClusterRanges
+{
+    uvec2 uClusterRanges[];
+};
+
+layout(std430, set = UNIFORM_SET, binding = 7) CLUSTER_ACCESS buffer ClusterLightIndices
+{
+    uint uClusterLightIndices[];
+};
+
+uint GetClusterIndex(uvec3 cluster)
+{
+    return (cluster.z * CLUSTER_COUNT_Y + cluster.y) * CLUSTER_COUNT_X + cluster.x;
+}
+
+// View space distance of a slice's near plane
+float GetSliceDepth(uint slice)
+{
+    return uNear * pow(uFar / uNear, float(slice) / float(CLUSTER_COUNT_Z));
+}
+
+// Light range of the cluster holding a fragment, viewDepth is the positive view space distance
+uvec2 GetClusterRange(vec2 fragCoord, float viewDepth)
+{
+    const uvec2 tile  = min(uvec2(fragCoord / uTileSize), uvec2(CLUSTER_COUNT_X - 1, CLUSTER_COUNT_Y - 1));
+    const uint  slice = uint(clamp(log(max(viewDepth, uNear)) * uSliceScale + uSliceBias, 0.0, float(CLUSTER_COUNT_Z - 1)));
+    return uClusterRanges[GetClusterIndex(uvec3(tile, slice))];
+}
+
+#endif
@@ -2,6 +2,7 @@
 #ifndef FXAA_GLSL
 #define FXAA_GLSL
 
+#ifndef FXAA_SPAN_MAX
 #define FXAA_SPAN_MAX         8.0
 #endif
 #ifndef FXAA_REDUCE_MUL
@@ -15,20 +16,26 @@
 #endif
 #ifndef FXAA_EDGE_THRESHOLD_MIN
 #define FXAA_EDGE_THRESHOLD_MIN (1.0/24.0)
+#endif
 
 float Luma(vec3 color)
 {
     return dot(color, vec3(0.299, 0.587, 0.114));
 }
 
-vec3 FXAA(sampler2D tex, vec2 uv, vec2 resolution)
+// Expects a tonemapped input, fragCoord is in pixels at the texel center
+// Only the top left resolution of tex is valid, the texture may be larger while the window shrinks
+vec3 FXAA(sampler2D tex, vec2 fragCoord, vec2 resolution)
 {
-    vec2 invRes = 1.0 / resolution.xy;
+    vec2 invRes = 1.0 / vec2(textureSize(tex, 0));
+    vec2 uvMin = 0.5 * invRes;
+    vec2 uvMax = (resolution - 0.5) * invRes;
+    vec2 uv = fragCoord * invRes;
     vec2 v_rgbM = uv;
-    vec2 v_rgbNW = (uv + vec2(-1.0f, -1.0f)) * invRes;
-    vec2 v_rgbNE = (uv + vec2(1.0f, -1.0f)) * invRes;
-    vec2 v_rgbSW = (uv + vec2(-1.0f, 1.0f)) * invRes;
-    vec2 v_rgbSE = (uv + vec2(1.0f, 1.0f)) * invRes;
+    vec2 v_rgbNW = clamp((fragCoord + vec2(-1.0f, -1.0f)) * invRes, uvMin, uvMax);
+    vec2 v_rgbNE = clamp((fragCoord + vec2(1.0f, -1.0f)) * invRes, uvMin, uvMax);
+    vec2 v_rgbSW = clamp((fragCoord + vec2(-1.0f, 1.0f)) * invRes, uvMin, uvMax);
+    vec2 v_rgbSE = clamp((fragCoord + vec2(1.0f, 1.0f)) * invRes, uvMin, uvMax);
 
     vec3 rgbM = texture(tex, v_rgbM).rgb;
     vec3 rgbNW = texture(tex, v_rgbNW).rgb;
@@ -63,14 +70,14 @@ vec3 FXAA(sampler2D tex, vec2 uv, vec2 resolution)
 
     // Two-tap blend A
     vec3 rgbA = 0.5 * (
-    texture(tex, uv + dir * (1.0/3.0 - 0.5)).rgb +
-    texture(tex, uv + dir * (2.0/3.0 - 0.5)).rgb
+    texture(tex, clamp(uv + dir * (1.0/3.0 - 0.5), uvMin, uvMax)).rgb +
+    texture(tex, clamp(uv + dir * (2.0/3.0 - 0.5), uvMin, uvMax)).rgb
     );
 
     // Four-tap blend B
     vec3 rgbB = rgbA * 0.5 + 0.25 * (
-    texture(tex, uv + dir * -0.5).rgb +
-    texture(tex, uv + dir *  0.5).rgb
+    texture(tex, clamp(uv + dir * -0.5, uvMin, uvMax)).rgb +
+    texture(tex, clamp(uv + dir *  0.5, uvMin, uvMax)).rgb
     );
 
     // Choose blend that keeps luma inside local min/max to avoid halos
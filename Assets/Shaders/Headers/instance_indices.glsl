@@ -0,0 +1,17 @@
+#ifndef INSTANCE_INDICES_GLSL
+#define INSTANCE_INDICES_GLSL
+
+#include <instances.glsl>
+
+// Instanced draws reach their instances through this indirection
+layout(std430, set = UNIFORM_SET, binding = 3) readonly buffer InstanceIndices
+{
+    uint uInstanceIndices[];
+};
+
+Instance GetInstance()
+{
+    return uInstances[uInstanceIndices[gl_InstanceIndex]];
+}
+
+#endif
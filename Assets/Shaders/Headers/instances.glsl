@@ -0,0 +1,23 @@
+#ifndef INSTANCES_GLSL
+#define INSTANCES_GLSL
+
+#include <util.glsl>
+
+struct Instance
+{
+    mat4 model;
+    // World space bounding sphere, center in xyz and radius in w
+    vec4 sphere;
+    uint batch;
+    // Index into the bindless material buffer
+    uint material;
+    uint padding1;
+    uint padding2;
+};
+
+layout(std430, set = UNIFORM_SET, binding = 2) readonly buffer Instances
+{
+    Instance uInstances[];
+};
+
+#endif
@@ -3,17 +3,34 @@
 
 #include <util.glsl>
 #include <uniform_lights.glsl>
+#include <clusters.glsl>
 
 
 
-layout (set = SHADOW_SET, binding = 0) uniform sampler2DShadow uShadowMap;
+layout (set = SHADOW_SET, binding = 0) uniform sampler2DArrayShadow uShadowMap;
+layout (set = SHADOW_SET, binding = 1) uniform sampler2DShadow uPointShadowAtlas;
+
+// Cube faces ordered +x, -x, +y, -y, +z, -z, rects hold the atlas uv offset in xy and scale in zw
+struct PointShadow {
+    mat4 faceMatrices[6];
+    vec4 faceRects[6];
+};
+
+layout (set = SHADOW_SET, binding = 2) readonly buffer PointShadows {
+    PointShadow uPointShadows[];
+};
+
+// Point shadow of each light, -1 when the light casts none
+layout (set = SHADOW_SET, binding = 3) readonly buffer LightShadows {
+    int uLightShadows[];
+};
 
 float CalculateBias(vec3 worldNormal, vec3 lightDir){
     vec3 L = -lightDir;
     float NdotL = clamp(dot(normalize(worldNormal), normalize(lightDir)), 0.0f, 1.0f);
     float slope = 1.0f - NdotL;
 
-    const vec2 texel = textureSize(uShadowMap, 0);
+    const vec2 texel = textureSize(uShadowMap, 0).xy;
     const float texelSize = 1.0f / min(texel.x, texel.y);
     const float bias = 0.05f;
     const float slopeFactor = 4.0f;
@@ -21,17 +38,17 @@ float CalculateBias(vec3 worldNormal, vec3 lightDir){
     return (bias + slopeFactor * slope) * texelSize;
 }
 
-float CalculatePCF(vec2 uv, float cmp, vec3 worldNormal)
+float CalculatePCF(vec2 uv, float cascade, float cmp, vec3 worldNormal)
 {
     float shadow = 0.0f;
     const float bias = CalculateBias(worldNormal, uLights[0].direction);
-    const vec2 texelSize = 1.0f / textureSize(uShadowMap, 0);
+    const vec2 texelSize = 1.0f / textureSize(uShadowMap, 0).xy;
 
     for (int x = -2; x < 2; ++x)
     {
         for (int y = -2; y < 2; ++y)
         {
-            shadow += texture(uShadowMap, vec3(uv + vec2(x, y) * texelSize, cmp - bias));
+            shadow += texture(uShadowMap, vec4(uv + vec2(x, y) * texelSize, cascade, cmp - bias));
         }
 
     }
@@ -39,8 +56,15 @@ float CalculatePCF(vec2 uv, float cmp, vec3 worldNormal)
     return shadow;
 }
 
-float ReadShadowMap(vec3 worldPosition, vec3 worldNormal){
-    vec4 lightSpacePos = uLightSpaceMatrix * vec4(worldPosition, 1.0);
+// viewDepth is the positive view space distance picking the cascade
+float ReadShadowMap(vec3 worldPosition, vec3 worldNormal, float viewDepth){
+    int cascade = 0;
+    while (cascade < CASCADE_COUNT - 1 && viewDepth > uCascadeSplits[cascade])
+    {
+        cascade++;
+    }
+
+    vec4 lightSpacePos = uCascadeMatrices[cascade] * vec4(worldPosition, 1.0);
     vec3 ndc = lightSpacePos.xyz / lightSpacePos.w;
     vec2 uv = ndc.xy * 0.5 + 0.5;
     uv = vec2(uv.x, uv.y);
@@ -50,7 +74,42 @@ float ReadShadowMap(vec3 worldPosition, vec3 worldNormal){
         return 1.0f;
     }
 
-    return CalculatePCF(uv, ndc.z, worldNormal);
+    return CalculatePCF(uv, float(cascade), ndc.z, worldNormal);
+}
+
+float ReadPointShadow(uint lightIndex, vec3 lightPosition, vec3 worldPosition){
+    const int shadowIndex = uLightShadows[lightIndex];
+    if (shadowIndex < 0)
+    {
+        return 0.0f;
+    }
+
+    // The major axis of the light to fragment vector picks the face
+    const vec3 toFragment = worldPosition - lightPosition;
+    const vec3 absolute = abs(toFragment);
+    int face;
+    if (absolute.x >= absolute.y && absolute.x >= absolute.z)
+    {
+        face = toFragment.x > 0.0f ? 0 : 1;
+    }
+    else if (absolute.y >= absolute.z)
+    {
+        face = toFragment.y > 0.0f ? 2 : 3;
+    }
+    else
+    {
+        face = toFragment.z > 0.0f ? 4 : 5;
+    }
+
+    const vec4 clipPos = uPointShadows[shadowIndex].faceMatrices[face] * vec4(worldPosition, 1.0f);
+    const vec3 ndc = clipPos.xyz / clipPos.w;
+    const vec4 rect = uPointShadows[shadowIndex].faceRects[face];
+
+    // Stay half a texel inside the tile so filtering never reads a neighbour
+    const vec2 halfTexel = 0.5f / textureSize(uPointShadowAtlas, 0);
+    const vec2 uv = clamp(rect.xy + (ndc.xy * 0.5f + 0.5f) * rect.zw, rect.xy + halfTexel, rect.xy + rect.zw - halfTexel);
+
+    return texture(uPointShadowAtlas, vec3(uv, ndc.z));
 }
 
 #endif
\ No newline at end of file
@@ -3,7 +3,7 @@
 
 #include <util.glsl>
 
-const int MAX_LIGHTS = 16;
+const int CASCADE_COUNT = 4;
 
 struct Light
 {
@@ -17,14 +17,16 @@ struct Light
     float intensity;
 };
 
+// The lights themselves live in the storage buffer of clusters.glsl
 layout(std140, set = UNIFORM_SET, binding = 1) uniform Lights
 {
     int uLightCount;
     int uPadding0;
     int uPadding1;
     int uPadding2;
-    mat4 uLightSpaceMatrix;
-    Light uLights[MAX_LIGHTS];
+    mat4 uCascadeMatrices[CASCADE_COUNT];
+    // Far view space distance of each cascade
+    vec4 uCascadeSplits;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,6 +1,7 @@
 #version 450
 
 #include <uniform_camera.glsl>
+#include <instance_indices.glsl>
 
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec3 inNormal;
@@ -10,14 +11,13 @@ layout (location = 3) in vec2 inTexcoord;
 layout (location = 0) out vec3 vWorldPosition;
 layout (location = 1) out mat3 vTBN;
 layout (location = 4) out vec2 vTexcoord;
-
-layout (push_constant) uniform PushConstantData
-{
-    mat4 inModel;
-};
+layout (location = 5) flat out uint vMaterial;
 
 void main()
 {
+    Instance instance = GetInstance();
+    mat4 inModel = instance.model;
+
     // Transform positon
     vWorldPosition = (inModel * vec4(inPosition, 1.0f)).xyz;
     gl_Position = uProjection * uView * vec4(vWorldPosition, 1.0f);
@@ -30,4 +30,5 @@ void main()
     vTBN = mat3(T, B, N);
 
     vTexcoord = inTexcoord;
+    vMaterial = instance.material;
 }
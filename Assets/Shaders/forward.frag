@@ -1,8 +1,12 @@
 #version 450
 
+#extension GL_EXT_nonuniform_qualifier : require
+
 #include <util.glsl>
+#include <bindless.glsl>
 #include <uniform_lights.glsl>
 #include <uniform_camera.glsl>
+#include <clusters.glsl>
 #include <pbr.glsl>
 #include <ibl.glsl>
 #include <shadow.glsl>
@@ -10,21 +14,19 @@
 layout (location = 0) in vec3 vWorldPosition;
 layout (location = 1) in mat3 vTBN;
 layout (location = 4) in vec2 vTexcoord;
+layout (location = 5) flat in uint vMaterial;
 
 layout (location = 0) out vec4 outColor;
 
-layout (set = TEXTURE_SET, binding = 0) uniform sampler2D uAlbedo;
-layout (set = TEXTURE_SET, binding = 1) uniform sampler2D uNormal;
-layout (set = TEXTURE_SET, binding = 2) uniform sampler2D uORM;
-layout (set = TEXTURE_SET, binding = 3) uniform sampler2D uEmissive;
-
 void main()
 {
-    const vec3 albedo = texture(uAlbedo, vTexcoord).xyz;
-    const vec3 tNormal = texture(uNormal, vTexcoord).xyz * 2.0 - 1.0;
+    const Material material = uMaterials[vMaterial];
+
+    const vec3 albedo = SampleTexture(material.albedo, vTexcoord).xyz;
+    const vec3 tNormal = SampleTexture(material.normal, vTexcoord).xyz * 2.0 - 1.0;
     const vec3 worldNormal = normalize(vTBN * tNormal);
-    const vec3 orm = texture(uORM, vTexcoord).xyz;
-    const vec3 emissive = texture(uEmissive, vTexcoord).xyz;
+    const vec3 orm = SampleTexture(material.orm, vTexcoord).xyz;
+    const vec3 emissive = SampleTexture(material.emissive, vTexcoord).xyz;
 
     const float ao = orm.r;
     const float roughness = orm.g;
@@ -38,13 +40,20 @@ void main()
 
     // PBR
     vec3 Lo = vec3(0.0f);
-    for (int i = 1; i < uLightCount; ++i)
+    const float viewDepth = -(uView * vec4(vWorldPosition, 1.0f)).z;
+
+    // Only the lights binned into this fragment's cluster
+    const uvec2 range = GetClusterRange(gl_FragCoord.xy, viewDepth);
+    for (uint i = 0; i < range.y; ++i)
     {
-        Lo += CalculatePBRLight(uLights[i].position, uLights[i].direction, uLights[i].color, uLights[i].intensity,
-        uLights[i].range, uLights[i].type, N, V, vWorldPosition, albedo, roughness, metallic);
+        const uint lightIndex = uClusterLightIndices[range.x + i];
+        const Light light = uLights[lightIndex];
+        Lo += CalculatePBRLight(light.position, light.direction, light.color, light.intensity,
+        light.range, light.type, N, V, vWorldPosition, albedo, roughness, metallic) *
+        (1.0f - ReadPointShadow(lightIndex, light.position, vWorldPosition));
     }
 
-    const float shadow = ReadShadowMap(vWorldPosition, N);
+    const float shadow = ReadShadowMap(vWorldPosition, N, viewDepth);
     Lo += CalculatePBRLight(uLights[0].position, uLights[0].direction, uLights[0].color, uLights[0].intensity,
     uLights[0].range, uLights[0].type, N, V, vWorldPosition, albedo, roughness, metallic) * (1.0f - shadow);
 
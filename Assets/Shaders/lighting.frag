@@ -3,6 +3,7 @@
 #include <util.glsl>
 #include <uniform_lights.glsl>
 #include <uniform_camera.glsl>
+#include <clusters.glsl>
 #include <pbr.glsl>
 #include <ibl.glsl>
 #include <shadow.glsl>
@@ -18,10 +19,12 @@ layout (set = TEXTURE_SET, binding = 3) uniform sampler2D uEmissive;
 
 void main()
 {
-    const vec4 worldPositionMetallic = texture(uWorldPositionMetallic, vTexcoord);
-    const vec4 worldNormalRoughness = texture(uWorldNormalRoughness, vTexcoord);
-    const vec4 albedoAO = texture(uAlbedoAmbientOcclusion, vTexcoord);
-    const vec3 emissive = texture(uEmissive, vTexcoord).xyz;
+    // The G-buffer shares the viewport, which only covers part of it under dynamic resolution
+    const ivec2 texel = ivec2(gl_FragCoord.xy);
+    const vec4 worldPositionMetallic = texelFetch(uWorldPositionMetallic, texel, 0);
+    const vec4 worldNormalRoughness = texelFetch(uWorldNormalRoughness, texel, 0);
+    const vec4 albedoAO = texelFetch(uAlbedoAmbientOcclusion, texel, 0);
+    const vec3 emissive = texelFetch(uEmissive, texel, 0).xyz;
 
     const vec3 worldPosition = worldPositionMetallic.xyz;
     const vec3 worldNormal = worldNormalRoughness.xyz;
@@ -39,13 +42,20 @@ void main()
 
     // PBR
     vec3 Lo = vec3(0.0f);
-    for(int i = 1; i < uLightCount; ++i)
+    const float viewDepth = -(uView * vec4(worldPosition, 1.0f)).z;
+
+    // Only the lights binned into this fragment's cluster
+    const uvec2 range = GetClusterRange(gl_FragCoord.xy, viewDepth);
+    for (uint i = 0; i < range.y; ++i)
     {
-        Lo += CalculatePBRLight(uLights[i].position, uLights[i].direction, uLights[i].color, uLights[i].intensity,
-        uLights[i].range, uLights[i].type, N, V, worldPosition, albedo, roughness, metallic);
+        const uint lightIndex = uClusterLightIndices[range.x + i];
+        const Light light = uLights[lightIndex];
+        Lo += CalculatePBRLight(light.position, light.direction, light.color, light.intensity,
+        light.range, light.type, N, V, worldPosition, albedo, roughness, metallic) *
+        (1.0f - ReadPointShadow(lightIndex, light.position, worldPosition));
     }
 
-    const float shadow = ReadShadowMap(worldPosition, N);
+    const float shadow = ReadShadowMap(worldPosition, N, viewDepth);
     Lo += CalculatePBRLight(uLights[0].position, uLights[0].direction, uLights[0].color, uLights[0].intensity,
     uLights[0].range, uLights[0].type, N, V, worldPosition, albedo, roughness, metallic) * (1.0f - shadow);
 
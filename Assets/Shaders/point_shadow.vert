@@ -0,0 +1,18 @@
+#version 450
+
+#include <instance_indices.glsl>
+
+layout (location = 0) in vec3 inPositon;
+layout (location = 1) in vec3 inNormal;
+layout (location = 2) in vec2 inTexCoord;
+
+// View projection of the cube face being drawn
+layout (push_constant) uniform PointShadowFace {
+    mat4 uFaceMatrix;
+};
+
+void main()
+{
+    mat4 inModel = GetInstance().model;
+    gl_Position = uFaceMatrix * inModel * vec4(inPositon, 1.0f);
+}
@@ -1,18 +1,18 @@
 #version 450
 
+#extension GL_EXT_multiview : require
+
 #include <uniform_camera.glsl>
 #include <uniform_lights.glsl>
+#include <instance_indices.glsl>
 
 layout (location = 0) in vec3 inPositon;
 layout (location = 1) in vec3 inNormal;
 layout (location = 2) in vec2 inTexCoord;
 
-layout (push_constant) uniform PushConstantData
-{
-    mat4 inModel;
-};
-
 void main()
 {
-    gl_Position = uLightSpaceMatrix * inModel * vec4(inPositon, 1.0f);
+    mat4 inModel = GetInstance().model;
+    // One view per cascade layer
+    gl_Position = uCascadeMatrices[gl_ViewIndex] * inModel * vec4(inPositon, 1.0f);
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Milliseconds, lower is better
+struct BenchMetric {
+    std::string name;
+    double      value = 0.0;
+};
+
+// Results of one benchmark run, written as JSON so runs can be diffed and gated
+class BenchReport {
+public:
+    BenchReport() = default;
+
+    explicit BenchReport(std::string scene) : m_scene(std::move(scene)) {}
+
+    // Describes the run without being compared, like the instance count
+    void AddInfo(const std::string &name, uint64_t value) { m_info.emplace_back(name, value); }
+
+    void Add(const std::string &name, double value) { m_metrics.push_back({name, value}); }
+
+    // Adds the average, median and 95th percentile of per-frame samples, skipped when empty
+    void AddSeries(const std::string &name, std::vector<float> samples);
+
+    [[nodiscard]] const std::vector<BenchMetric> &GetMetrics() const { return m_metrics; }
+
+    [[nodiscard]] bool Write(const std::string &path) const;
+
+    // Reads a report written by Write, empty when the file is missing
+    static std::optional<BenchReport> Load(const std::string &path);
+
+    // Logs every metric slower than the baseline by more than tolerance, a ratio, plus slack in milliseconds
+    // Slack keeps passes of a few microseconds from failing on noise, returns false on any regression
+    [[nodiscard]] bool Compare(const BenchReport &baseline, double tolerance, double slack) const;
+
+private:
+    std::string                                   m_scene;
+    std::vector<std::pair<std::string, uint64_t>> m_info;
+    std::vector<BenchMetric>                      m_metrics;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <include/SceneDescription.h>
+
+class BenchReport;
+
+struct BenchConfig {
+    std::string sceneFile; // Scene description, the showcase scene when empty
+    uint32_t    width        = 1600;
+    uint32_t    height       = 900;
+    uint32_t    frameCount   = 300;
+    uint32_t    warmupFrames = 30;
+    std::string cameraPath   = "orbit";
+    std::string outputFile   = "bench_results.json";
+    std::string baselineFile; // Compared against when set
+    double      tolerance = 0.1;  // Allowed slowdown as a ratio of the baseline
+    double      slack     = 0.05; // Allowed slowdown in milliseconds on top of the tolerance
+
+    // [--scene FILE] [--frames N] [--warmup N] [--size WxH] [--camera PATH] [--out FILE] [--baseline FILE] [--tolerance PERCENT] [--slack MS]
+    static BenchConfig FromArgs(int argc, char *argv[]);
+};
+
+// Renders a scene headless along a scripted camera path and times startup, frames and every profiled pass
+// Owns the whole engine lifetime, so startup phases can be timed one at a time
+class BenchRunner {
+public:
+    BenchRunner() = delete;
+
+    explicit BenchRunner(BenchConfig config);
+
+    ~BenchRunner() = default;
+
+    BenchRunner(const BenchRunner &)            = delete;
+    BenchRunner(BenchRunner &&)                 = delete;
+    BenchRunner &operator=(const BenchRunner &) = delete;
+    BenchRunner &operator=(BenchRunner &&)      = delete;
+
+    // Returns false when the results could not be written or regressed against the baseline
+    bool Run();
+
+private:
+    BenchConfig      m_config;
+    SceneDescription m_scene;
+
+    void Startup(BenchReport &report);
+    void Measure(BenchReport &report);
+    void Shutdown();
+};
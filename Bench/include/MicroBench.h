@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class BenchReport;
+
+// Handed to a benchmark body, which loops on KeepRunning and times one iteration per loop
+class MicroBenchState {
+public:
+    MicroBenchState() = delete;
+
+    explicit MicroBenchState(std::chrono::nanoseconds minTime, uint32_t minIterations);
+
+    // False once both the minimum time and iteration count are reached
+    bool KeepRunning();
+
+    // Excludes setup inside the loop, like writing inputs, from the iteration time
+    void PauseTiming();
+
+    void ResumeTiming();
+
+    // Per iteration, reported as throughput
+    void SetItemsPerIteration(uint64_t items) { m_items = items; }
+
+    void SetBytesPerIteration(uint64_t bytes) { m_bytes = bytes; }
+
+    [[nodiscard]] const std::vector<float> &GetSamples() const { return m_samples; } // Milliseconds per iteration
+
+    [[nodiscard]] uint64_t GetItemsPerIteration() const { return m_items; }
+
+    [[nodiscard]] uint64_t GetBytesPerIteration() const { return m_bytes; }
+
+    // Keeps a result alive so the compiler cannot drop the work producing it
+    template<typename T>
+    static void DoNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::nanoseconds m_minTime;
+    uint32_t                 m_minIterations = 0;
+    std::chrono::nanoseconds m_elapsed{0};
+    std::chrono::nanoseconds m_paused{0};
+    Clock::time_point        m_start;
+    Clock::time_point        m_pauseStart;
+    bool                     m_running = false;
+    uint64_t                 m_items   = 0;
+    uint64_t                 m_bytes   = 0;
+    std::vector<float>       m_samples;
+};
+
+using MicroBenchFunction = std::function<void(MicroBenchState &)>;
+
+// Google Benchmark style registry of named cases, each timed until a minimum time and iteration count
+class MicroBench {
+public:
+    MicroBench() = delete;
+
+    static void Register(std::string name, MicroBenchFunction function);
+
+    // Runs every case whose name contains the filter, logs a table and adds each case's series to the report
+    // Logging below warnings is muted while a case runs unless verbose
+    static void Run(const std::string &filter, std::chrono::nanoseconds minTime, uint32_t minIterations, bool verbose, BenchReport &report);
+
+private:
+    struct Case {
+        std::string        name;
+        MicroBenchFunction function;
+    };
+
+    static std::vector<Case> &GetCases();
+};
+
+// Defined next to the cases they register
+void RegisterLoaderBenchmarks();
+void RegisterThreadPoolBenchmarks();
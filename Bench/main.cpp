@@ -0,0 +1,21 @@
+#include <cstdlib>
+
+#include <glslang/Public/ShaderLang.h>
+
+#include <include/BenchRunner.h>
+#include <include/CpuProfiler.h>
+
+// Run from the build directory like the app, asset paths are relative to it
+int main(int argc, char *argv[]) {
+    const BenchConfig config = BenchConfig::FromArgs(argc, argv);
+
+    CpuProfiler::GetInstance().Init();
+    glslang::InitializeProcess();
+
+    BenchRunner runner(config);
+    const bool  succeeded = runner.Run();
+
+    glslang::FinalizeProcess();
+
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+#include <SDL3/SDL_log.h>
+#include <glslang/Public/ShaderLang.h>
+
+#include <Debug.h>
+
+#include <include/BenchReport.h>
+#include <include/MicroBench.h>
+
+// Loader, parser, shader compiler and thread pool benchmarks, nothing here touches the GPU
+// [--filter TEXT] [--min-time SECONDS] [--min-iterations N] [--out FILE] [--baseline FILE] [--tolerance PERCENT] [--slack MS] [--verbose]
+int main(int argc, char *argv[]) {
+    std::string filter;
+    double      minTime       = 0.5;
+    uint32_t    minIterations = 5;
+    std::string outputFile    = "micro_bench_results.json";
+    std::string baselineFile;
+    double      tolerance = 0.1;
+    double      slack     = 0.01;
+    bool        verbose   = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--verbose") {
+            verbose = true;
+            continue;
+        }
+        DEBUG_ASSERT_LOG(i + 1 < argc, (arg + " expects a value").c_str());
+        const char *value = argv[++i];
+
+        if (arg == "--filter") {
+            filter = value;
+        } else if (arg == "--min-time") {
+            minTime = std::stod(value);
+        } else if (arg == "--min-iterations") {
+            minIterations = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--out") {
+            outputFile = value;
+        } else if (arg == "--baseline") {
+            baselineFile = value;
+        } else if (arg == "--tolerance") {
+            tolerance = std::stod(value) / 100.0;
+        } else if (arg == "--slack") {
+            slack = std::stod(value);
+        } else {
+            DEBUG_ASSERT_LOG(false, ("Unknown argument " + arg).c_str());
+        }
+    }
+
+    glslang::InitializeProcess();
+
+    RegisterLoaderBenchmarks();
+    RegisterThreadPoolBenchmarks();
+
+    BenchReport report("micro");
+    MicroBench::Run(
+        filter, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(minTime)), minIterations, verbose, report
+    );
+
+    glslang::FinalizeProcess();
+
+    bool succeeded = report.Write(outputFile);
+    if (!baselineFile.empty()) {
+        const std::optional<BenchReport> baseline = BenchReport::Load(baselineFile);
+        if (!baseline) {
+            SDL_Log("Baseline %s does not exist, record one by writing the results there with --out", baselineFile.c_str());
+            return EXIT_FAILURE;
+        }
+        succeeded = report.Compare(*baseline, tolerance, slack) && succeeded;
+    }
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
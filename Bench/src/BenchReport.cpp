@@ -0,0 +1,121 @@
+#include "include/BenchReport.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+
+#include <SDL3/SDL_log.h>
+
+#include <include/JsonFile.h>
+
+namespace {
+void WriteEscaped(std::ofstream &file, const std::string &text) {
+    file << '"';
+    for (const char c: text) {
+        if (c == '"' || c == '\\') {
+            file << '\\';
+        }
+        file << c;
+    }
+    file << '"';
+}
+
+// Nearest rank on sorted samples
+float GetPercentile(const std::vector<float> &sorted, float percentile) {
+    const auto rank = static_cast<size_t>(percentile * static_cast<float>(sorted.size() - 1) + 0.5f);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+} // namespace
+
+void BenchReport::AddSeries(const std::string &name, std::vector<float> samples) {
+    if (samples.empty()) {
+        return;
+    }
+    std::ranges::sort(samples);
+
+    Add(name + ".avg_ms", std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size()));
+    Add(name + ".p50_ms", GetPercentile(samples, 0.5f));
+    Add(name + ".p95_ms", GetPercentile(samples, 0.95f));
+}
+
+bool BenchReport::Write(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file) {
+        SDL_Log("Failed to open %s", path.c_str());
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(4) << "{\n  \"scene\": ";
+    WriteEscaped(file, m_scene);
+    for (const auto &[name, value]: m_info) {
+        file << ",\n  ";
+        WriteEscaped(file, name);
+        file << ": " << value;
+    }
+
+    file << ",\n  \"metrics\": {";
+    for (size_t i = 0; i < m_metrics.size(); i++) {
+        file << (i == 0 ? "\n    " : ",\n    ");
+        WriteEscaped(file, m_metrics[i].name);
+        file << ": " << m_metrics[i].value;
+    }
+    file << "\n  }\n}\n";
+
+    SDL_Log("Benchmark results written to %s", path.c_str());
+    return true;
+}
+
+std::optional<BenchReport> BenchReport::Load(const std::string &path) {
+    if (!std::filesystem::exists(path)) {
+        return std::nullopt;
+    }
+
+    file_system::JsonFile json(path);
+
+    BenchReport report(json.GetString("scene", ""));
+    for (const auto field: json.GetObject("metrics")) {
+        double value = 0.0;
+        if (field.value.get(value) == simdjson::SUCCESS) {
+            report.Add(std::string(field.key), value);
+        }
+    }
+    return report;
+}
+
+bool BenchReport::Compare(const BenchReport &baseline, double tolerance, double slack) const {
+    if (baseline.m_scene != m_scene) {
+        SDL_Log("Baseline was recorded on scene %s, not %s", baseline.m_scene.c_str(), m_scene.c_str());
+        return false;
+    }
+
+    uint32_t regressions  = 0;
+    uint32_t improvements = 0;
+    for (const BenchMetric &expected: baseline.m_metrics) {
+        const auto current = std::ranges::find(m_metrics, expected.name, &BenchMetric::name);
+        if (current == m_metrics.end()) {
+            SDL_Log("Metric %s of the baseline was not measured", expected.name.c_str());
+            continue;
+        }
+
+        const double change = expected.value > 0.0 ? (current->value - expected.value) / expected.value * 100.0 : 0.0;
+        if (current->value > expected.value * (1.0 + tolerance) + slack) {
+            SDL_Log("REGRESSION %s: %.4f ms against %.4f ms (%+.1f%%)", expected.name.c_str(), current->value, expected.value, change);
+            regressions++;
+        } else if (current->value < expected.value * (1.0 - tolerance) - slack) {
+            SDL_Log("Improved %s: %.4f ms against %.4f ms (%+.1f%%)", expected.name.c_str(), current->value, expected.value, change);
+            improvements++;
+        }
+    }
+
+    SDL_Log(
+        "%u of %zu metrics regressed beyond %.1f%% + %.3f ms, %u improved",
+        regressions,
+        baseline.m_metrics.size(),
+        tolerance * 100.0,
+        slack,
+        improvements
+    );
+    return regressions == 0;
+}
@@ -0,0 +1,239 @@
+#include "include/BenchRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL_log.h>
+
+#include <Debug.h>
+
+#include <include/BenchReport.h>
+#include <include/BindlessTable.h>
+#include <include/CameraPath.h>
+#include <include/CpuProfiler.h>
+#include <include/GpuProfiler.h>
+#include <include/MaterialRegistry.h>
+#include <include/MeshManager.h>
+#include <include/ObjectRegistry.h>
+#include <include/PbrRenderer.h>
+#include <include/PipelineManager.h>
+#include <include/TextureManager.h>
+#include <include/ThreadPool.h>
+#include <include/UIRenderer.h>
+#include <include/VulkanState.h>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double MillisecondsSince(Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+using ZoneSamples = std::map<std::string, std::vector<float>>;
+
+// Sums the main thread zones of the last finished frame by name
+void CollectCpuZones(ZoneSamples &samples) {
+    const CpuProfiler &profiler = CpuProfiler::GetInstance();
+    const uint64_t     from     = profiler.GetFrameStart();
+    const uint64_t     to       = profiler.GetFrameEnd();
+
+    std::map<std::string, uint64_t> frame;
+    for (const CpuThreadEvents &thread: profiler.Capture(from, to)) {
+        if (thread.name != "Main") {
+            continue;
+        }
+        for (const CpuZoneEvent &event: thread.events) {
+            if (event.start >= from && event.end <= to) {
+                frame[event.name] += event.end - event.start;
+            }
+        }
+    }
+    for (const auto &[name, ticks]: frame) {
+        samples[name].push_back(static_cast<float>(profiler.ToMilliseconds(ticks)));
+    }
+}
+
+// Zones skipped in a frame, like cached shadows, do not get a sample for it
+void CollectGpuZones(ZoneSamples &samples, std::vector<size_t> &sampleCounts) {
+    const std::vector<GpuZoneStats> &zones = GpuProfiler::GetInstance().GetZones();
+    sampleCounts.resize(zones.size(), 0);
+
+    for (size_t i = 0; i < zones.size(); i++) {
+        if (zones[i].sampleCount > sampleCounts[i]) {
+            samples[zones[i].name].push_back(zones[i].GetLast());
+            sampleCounts[i] = zones[i].sampleCount;
+        }
+    }
+}
+} // namespace
+
+BenchConfig BenchConfig::FromArgs(int argc, char *argv[]) {
+    BenchConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        DEBUG_ASSERT_LOG(i + 1 < argc, (arg + " expects a value").c_str());
+        const char *value = argv[++i];
+
+        if (arg == "--scene") {
+            config.sceneFile = value;
+        } else if (arg == "--frames") {
+            config.frameCount = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--warmup") {
+            config.warmupFrames = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--size") {
+            DEBUG_ASSERT_LOG(std::sscanf(value, "%ux%u", &config.width, &config.height) == 2, "--size expects WIDTHxHEIGHT");
+        } else if (arg == "--camera") {
+            config.cameraPath = value;
+        } else if (arg == "--out") {
+            config.outputFile = value;
+        } else if (arg == "--baseline") {
+            config.baselineFile = value;
+        } else if (arg == "--tolerance") {
+            config.tolerance = std::stod(value) / 100.0;
+        } else if (arg == "--slack") {
+            config.slack = std::stod(value);
+        } else {
+            DEBUG_ASSERT_LOG(false, ("Unknown argument " + arg).c_str());
+        }
+    }
+
+    DEBUG_ASSERT_LOG(config.frameCount > 0 && config.width > 0 && config.height > 0, "Benchmarks need frames and a size");
+    return config;
+}
+
+BenchRunner::BenchRunner(BenchConfig config)
+    : m_config(std::move(config)),
+      m_scene(m_config.sceneFile.empty() ? SceneDescription::Default() : SceneDescription::FromFile(m_config.sceneFile)) {}
+
+bool BenchRunner::Run() {
+    BenchReport report(m_scene.name);
+    report.AddInfo("instances", m_scene.prefabs.size());
+    report.AddInfo("width", m_config.width);
+    report.AddInfo("height", m_config.height);
+    report.AddInfo("frames", m_config.frameCount);
+
+    Startup(report);
+    Measure(report);
+    Shutdown();
+
+    bool succeeded = report.Write(m_config.outputFile);
+    if (m_config.baselineFile.empty()) {
+        return succeeded;
+    }
+
+    const std::optional<BenchReport> baseline = BenchReport::Load(m_config.baselineFile);
+    if (!baseline) {
+        SDL_Log("Baseline %s does not exist, record one by writing the results there with --out", m_config.baselineFile.c_str());
+        return false;
+    }
+    return report.Compare(*baseline, m_config.tolerance, m_config.slack) && succeeded;
+}
+
+void BenchRunner::Startup(BenchReport &report) {
+    Clock::time_point start = Clock::now();
+    VulkanState::GetInstance().InitHeadless(m_config.width, m_config.height);
+    GpuProfiler::GetInstance().Init();
+    report.Add("startup.vulkan_ms", MillisecondsSince(start));
+
+    // The app lets these overlap on the thread pool, waiting after each isolates its cost
+    start = Clock::now();
+    PipelineManager::GetInstance().Init();
+    ThreadPool::GetInstance().WaitIdle();
+    report.Add("startup.pipelines_ms", MillisecondsSince(start));
+
+    start = Clock::now();
+    MeshManager::GetInstance().Init();
+    ThreadPool::GetInstance().WaitIdle();
+    report.Add("startup.meshes_ms", MillisecondsSince(start));
+
+    start = Clock::now();
+    TextureManager::GetInstance().Init();
+    ThreadPool::GetInstance().WaitIdle();
+    report.Add("startup.textures_ms", MillisecondsSince(start));
+
+    start = Clock::now();
+    BindlessTable::GetInstance().Init();
+    MaterialRegistry::GetInstance().Init();
+    ObjectRegistry::GetInstance().Init();
+    report.Add("startup.registries_ms", MillisecondsSince(start));
+}
+
+void BenchRunner::Measure(BenchReport &report) {
+    const Clock::time_point start = Clock::now();
+    UIRenderer              uiRenderer;
+    PbrRenderer             pbrRenderer(uiRenderer, m_scene);
+    report.Add("startup.renderer_ms", MillisecondsSince(start));
+
+    SDL_Log("Benchmarking %s, %zu instances over %u frames", m_scene.name.c_str(), m_scene.prefabs.size(), m_config.frameCount);
+
+    // Same frame layout as headless runs, the path is spread over the measured frames
+    const CameraPath path        = CameraPath::Load(m_config.cameraPath);
+    const uint32_t   measuredEnd = m_config.warmupFrames + m_config.frameCount;
+    const uint32_t   totalFrames = measuredEnd + GPU_PROFILER_FRAME_LATENCY;
+
+    std::vector<float>  frameTimes;
+    std::vector<float>  gpuTimes;
+    ZoneSamples         cpuZones;
+    ZoneSamples         gpuZones;
+    std::vector<size_t> gpuSampleCounts;
+
+    for (uint32_t frame = 0; frame < totalFrames; frame++) {
+        PROFILE_FRAME();
+        if (frame > m_config.warmupFrames && frame <= measuredEnd) {
+            CollectCpuZones(cpuZones);
+        }
+
+        const uint32_t pathFrame = std::clamp(frame, m_config.warmupFrames, measuredEnd - 1) - m_config.warmupFrames;
+        const float    ratio     = m_config.frameCount > 1 ? static_cast<float>(pathFrame) / static_cast<float>(m_config.frameCount - 1) : 0.0f;
+        path.Apply(ratio * path.GetDuration());
+
+        const Clock::time_point frameStart = Clock::now();
+
+        VulkanState::GetInstance().BeginFrame();
+        GpuProfiler::GetInstance().BeginFrame();
+        CollectGpuZones(gpuZones, gpuSampleCounts);
+        if (frame < m_config.warmupFrames + GPU_PROFILER_FRAME_LATENCY) {
+            gpuZones.clear(); // Warmup frames only advance the sample counts
+        } else {
+            gpuTimes.push_back(GpuProfiler::GetInstance().GetFrameTime());
+        }
+
+        {
+            PROFILE_ZONE("Bench::Frame");
+            pbrRenderer.Render();
+            uiRenderer.Render();
+            pbrRenderer.PostProcess();
+        }
+
+        VulkanState::GetInstance().EndFrame();
+
+        if (frame >= m_config.warmupFrames && frame < measuredEnd) {
+            frameTimes.push_back(static_cast<float>(MillisecondsSince(frameStart)));
+        }
+    }
+    VulkanState::GetInstance().WaitForLastFrame();
+
+    // Wall time includes the wait on the previous frame
+    report.AddSeries("frame.wall", std::move(frameTimes));
+    report.AddSeries("frame.gpu", std::move(gpuTimes));
+    for (auto &[name, samples]: gpuZones) {
+        report.AddSeries("gpu." + name, std::move(samples));
+    }
+    for (auto &[name, samples]: cpuZones) {
+        report.AddSeries("cpu." + name, std::move(samples));
+    }
+}
+
+void BenchRunner::Shutdown() {
+    GpuProfiler::GetInstance().Destroy();
+
+    ObjectRegistry::GetInstance().Destroy();
+    MaterialRegistry::GetInstance().Destroy();
+    BindlessTable::GetInstance().Destroy();
+    TextureManager::GetInstance().Destroy();
+    MeshManager::GetInstance().Destroy();
+    PipelineManager::GetInstance().Destroy();
+}
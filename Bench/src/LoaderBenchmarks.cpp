@@ -0,0 +1,193 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stb_image.h>
+
+#include <include/JsonInput.h>
+#include <include/MeshLoader.h>
+#include <include/MicroBench.h>
+#include <include/SceneDescription.h>
+#include <include/ShaderCompiler.h>
+#include <include/TextureLoader.h>
+
+namespace {
+// Synthetic inputs are written on first use and kept between runs
+std::filesystem::path GetSyntheticPath(const std::string &name) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "vrez_micro_bench";
+    std::filesystem::create_directories(dir);
+    return dir / name;
+}
+
+// Flat grid split into triangles, with the texture coordinates and normals LoadMesh expects
+std::string WriteGridMesh(uint32_t quadsPerSide) {
+    const std::filesystem::path path = GetSyntheticPath("grid_" + std::to_string(quadsPerSide) + ".obj");
+    if (std::filesystem::exists(path)) {
+        return path.string();
+    }
+
+    std::ofstream  file(path);
+    const uint32_t side = quadsPerSide + 1;
+    for (uint32_t z = 0; z < side; z++) {
+        for (uint32_t x = 0; x < side; x++) {
+            file << "v " << x << " 0 " << z << "\nvt " << static_cast<float>(x) / quadsPerSide << ' ' << static_cast<float>(z) / quadsPerSide << '\n';
+        }
+    }
+    file << "vn 0 1 0\n";
+    for (uint32_t z = 0; z < quadsPerSide; z++) {
+        for (uint32_t x = 0; x < quadsPerSide; x++) {
+            const uint32_t a = z * side + x + 1; // OBJ indices start at 1
+            const uint32_t b = a + 1;
+            const uint32_t c = a + side;
+            const uint32_t d = c + 1;
+            file << "f " << a << '/' << a << "/1 " << c << '/' << c << "/1 " << b << '/' << b << "/1\n";
+            file << "f " << b << '/' << b << "/1 " << c << '/' << c << "/1 " << d << '/' << d << "/1\n";
+        }
+    }
+    return path.string();
+}
+
+// Binary PPM of xorshift noise, noise keeps decoders from taking shortcuts on flat colors
+std::string WriteNoiseTexture(uint32_t size) {
+    const std::filesystem::path path = GetSyntheticPath("noise_" + std::to_string(size) + ".ppm");
+    if (std::filesystem::exists(path)) {
+        return path.string();
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file << "P6\n" << size << ' ' << size << "\n255\n";
+
+    std::vector<unsigned char> row(static_cast<size_t>(size) * 3);
+    uint32_t                   state = 0x9E3779B9u;
+    for (uint32_t y = 0; y < size; y++) {
+        for (unsigned char &value: row) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            value = static_cast<unsigned char>(state);
+        }
+        file.write(reinterpret_cast<const char *>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+    return path.string();
+}
+
+std::string WriteScene(uint32_t instanceCount) {
+    const std::filesystem::path path = GetSyntheticPath("scene_" + std::to_string(instanceCount) + ".json");
+    if (std::filesystem::exists(path)) {
+        return path.string();
+    }
+
+    std::ofstream file(path);
+    file << "{\n  \"name\": \"synthetic\",\n  \"instances\": [";
+    for (uint32_t i = 0; i < instanceCount; i++) {
+        file << (i == 0 ? "\n" : ",\n") << R"(    {"object": "../Assets/Models/Castle/Castle.json", "location": [)" << i % 100 << ", 0.0, "
+             << i / 100 << "]}";
+    }
+    file << "\n  ]\n}\n";
+    return path.string();
+}
+
+void BenchLoadMesh(MicroBenchState &state, const std::string &file) {
+    if (!std::filesystem::exists(file)) {
+        return;
+    }
+    state.SetBytesPerIteration(std::filesystem::file_size(file));
+
+    while (state.KeepRunning()) {
+        const std::vector<VertexPNTT> vertices = file_system::LoadMesh(file);
+        MicroBenchState::DoNotOptimize(vertices);
+    }
+}
+
+void BenchLoadTexture(MicroBenchState &state, const std::string &file) {
+    if (!std::filesystem::exists(file)) {
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        int            width  = 0;
+        int            height = 0;
+        unsigned char *data   = file_system::LoadTexture(file, &width, &height);
+        MicroBenchState::DoNotOptimize(data);
+        state.SetItemsPerIteration(static_cast<uint64_t>(width) * height); // Texels
+
+        state.PauseTiming();
+        stbi_image_free(data);
+        state.ResumeTiming();
+    }
+}
+
+void BenchShaderCompiler(MicroBenchState &state, const std::vector<std::string> &files) {
+    while (state.KeepRunning()) {
+        const ShaderCompiler compiler(files);
+        MicroBenchState::DoNotOptimize(compiler);
+    }
+}
+} // namespace
+
+void RegisterLoaderBenchmarks() {
+    for (const char *model: {"Castle", "BoomBox", "Suzanne"}) {
+        const std::string name = model;
+        MicroBench::Register("LoadMesh/" + name, [name](MicroBenchState &state) {
+            BenchLoadMesh(state, "../Assets/Models/" + name + "/" + name + ".obj");
+        });
+    }
+    for (const uint32_t quads: {64u, 256u, 512u}) {
+        MicroBench::Register("LoadMesh/Grid/" + std::to_string(2 * quads * quads), [quads](MicroBenchState &state) {
+            BenchLoadMesh(state, WriteGridMesh(quads));
+        });
+    }
+
+    for (const char *texture: {"Castle/castle_white_base_color.jpg", "Castle/Castle_ORM.jpg", "BoomBox/BoomBox_baseColor.png"}) {
+        const std::string file = texture;
+        MicroBench::Register("LoadTexture/" + file, [file](MicroBenchState &state) { BenchLoadTexture(state, "../Assets/Models/" + file); });
+    }
+    for (const uint32_t size: {512u, 1024u, 2048u, 4096u}) {
+        MicroBench::Register("LoadTexture/Noise/" + std::to_string(size), [size](MicroBenchState &state) {
+            BenchLoadTexture(state, WriteNoiseTexture(size));
+        });
+    }
+
+    for (const char *model: {"Castle", "BoomBox", "Suzanne"}) {
+        const std::string file = "../Assets/Models/" + std::string(model) + "/" + model + ".json";
+        MicroBench::Register("JsonFile/ObjectConfig/" + std::string(model), [file](MicroBenchState &state) {
+            while (state.KeepRunning()) {
+                const file_system::ObjectConfig config(file);
+                MicroBenchState::DoNotOptimize(config);
+            }
+        });
+    }
+    MicroBench::Register("JsonFile/MaterialConfig/BoomBox", [](MicroBenchState &state) {
+        const std::string file = file_system::ObjectConfig("../Assets/Models/BoomBox/BoomBox.json").material;
+        while (state.KeepRunning()) {
+            const file_system::MaterialConfig config(file);
+            MicroBenchState::DoNotOptimize(config);
+        }
+    });
+    for (const uint32_t count: {1000u, 10000u, 100000u}) {
+        MicroBench::Register("JsonFile/Scene/" + std::to_string(count), [count](MicroBenchState &state) {
+            const std::string file = WriteScene(count);
+            state.SetItemsPerIteration(count);
+            while (state.KeepRunning()) {
+                const SceneDescription scene = SceneDescription::FromFile(file);
+                MicroBenchState::DoNotOptimize(scene);
+            }
+        });
+    }
+
+    // Compile and reflect, the same stages PipelineManager loads
+    const std::vector<std::pair<std::string, std::vector<std::string>>> shaders{
+        {"gbuffer",  {"../Assets/Shaders/base.vert", "../Assets/Shaders/gbuffer.frag"}       },
+        {"lighting", {"../Assets/Shaders/fullscreen.vert", "../Assets/Shaders/lighting.frag"}},
+        {"forward",  {"../Assets/Shaders/base.vert", "../Assets/Shaders/forward.frag"}       },
+        {"cluster",  {"../Assets/Shaders/cluster.comp"}                                      },
+        {"cull",     {"../Assets/Shaders/cull.comp"}                                         },
+        {"tonemap",  {"../Assets/Shaders/tonemap.comp"}                                      },
+    };
+    for (const auto &[name, files]: shaders) {
+        MicroBench::Register("ShaderCompiler/" + name, [files](MicroBenchState &state) { BenchShaderCompiler(state, files); });
+    }
+}
@@ -0,0 +1,81 @@
+#include "include/MicroBench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+#include <SDL3/SDL_log.h>
+
+#include <include/BenchReport.h>
+
+namespace {
+// Keeps bodies of a few nanoseconds from filling memory with samples
+constexpr size_t MAX_ITERATIONS = 1 << 20;
+
+float ToMilliseconds(std::chrono::nanoseconds duration) { return std::chrono::duration<float, std::milli>(duration).count(); }
+} // namespace
+
+MicroBenchState::MicroBenchState(std::chrono::nanoseconds minTime, uint32_t minIterations)
+    : m_minTime(minTime), m_minIterations(minIterations) {}
+
+bool MicroBenchState::KeepRunning() {
+    const Clock::time_point now = Clock::now();
+    if (m_running) {
+        const std::chrono::nanoseconds lap = now - m_start - m_paused;
+        m_samples.push_back(ToMilliseconds(lap));
+        m_elapsed += lap;
+    }
+
+    const bool done = (m_samples.size() >= m_minIterations && m_elapsed >= m_minTime) || m_samples.size() >= MAX_ITERATIONS;
+    m_running       = !done;
+    m_paused        = std::chrono::nanoseconds(0);
+    m_start         = Clock::now();
+    return m_running;
+}
+
+void MicroBenchState::PauseTiming() { m_pauseStart = Clock::now(); }
+
+void MicroBenchState::ResumeTiming() { m_paused += Clock::now() - m_pauseStart; }
+
+std::vector<MicroBench::Case> &MicroBench::GetCases() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+void MicroBench::Register(std::string name, MicroBenchFunction function) { GetCases().push_back({std::move(name), std::move(function)}); }
+
+void MicroBench::Run(const std::string &filter, std::chrono::nanoseconds minTime, uint32_t minIterations, bool verbose, BenchReport &report) {
+    SDL_Log("%-44s %12s %12s %10s %16s", "Benchmark", "Median ms", "Min ms", "Iterations", "Throughput");
+
+    for (const Case &benchCase: GetCases()) {
+        if (!filter.empty() && benchCase.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        // Loaders log every file they read, which would end up in the timings
+        if (!verbose) {
+            SDL_SetLogPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_WARN);
+        }
+        MicroBenchState state(minTime, minIterations);
+        benchCase.function(state);
+        SDL_SetLogPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+        std::vector<float> samples = state.GetSamples();
+        if (samples.empty()) {
+            SDL_Log("%-44s skipped", benchCase.name.c_str());
+            continue;
+        }
+        std::ranges::sort(samples);
+        const float median = samples[samples.size() / 2];
+
+        char throughput[32] = "";
+        if (state.GetItemsPerIteration() > 0) {
+            std::snprintf(throughput, sizeof(throughput), "%.3g items/s", static_cast<double>(state.GetItemsPerIteration()) / median * 1e3);
+        } else if (state.GetBytesPerIteration() > 0) {
+            std::snprintf(throughput, sizeof(throughput), "%.1f MB/s", static_cast<double>(state.GetBytesPerIteration()) / median * 1e-3);
+        }
+        SDL_Log("%-44s %12.4f %12.4f %10zu %16s", benchCase.name.c_str(), median, samples.front(), samples.size(), throughput);
+
+        report.AddSeries("micro." + benchCase.name, std::move(samples));
+    }
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <include/MeshLoader.h>
+#include <include/MicroBench.h>
+#include <include/ThreadPool.h>
+
+namespace {
+constexpr uint32_t EMPTY_TASK_COUNT   = 10000;
+constexpr uint32_t COMPUTE_TASK_COUNT = 256;
+constexpr uint32_t COMPUTE_TASK_STEPS = 100000;
+constexpr uint32_t MESH_TASK_COUNT    = 32;
+
+// A pool of its own per case, so thread counts can be compared
+class SizedThreadPool : public ThreadPool {
+public:
+    explicit SizedThreadPool(size_t threadCount) : ThreadPool(threadCount) {}
+
+    ~SizedThreadPool() = default;
+};
+
+// Powers of two up to the hardware threads, which are always included
+std::vector<uint32_t> GetThreadCounts() {
+    const uint32_t        hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<uint32_t> counts;
+    for (uint32_t count = 1; count < hardwareThreads; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(hardwareThreads);
+    return counts;
+}
+
+void BenchTasks(MicroBenchState &state, uint32_t threadCount, uint32_t taskCount, const std::function<void()> &task) {
+    SizedThreadPool pool(threadCount);
+    state.SetItemsPerIteration(taskCount);
+
+    while (state.KeepRunning()) {
+        for (uint32_t i = 0; i < taskCount; i++) {
+            pool.Enqueue(std::function<void()>(task));
+        }
+        pool.WaitIdle();
+    }
+}
+} // namespace
+
+void RegisterThreadPoolBenchmarks() {
+    for (const uint32_t threads: GetThreadCounts()) {
+        const std::string suffix = "/" + std::to_string(threads);
+
+        // Queue and wake up overhead alone
+        MicroBench::Register("ThreadPool/EmptyTasks" + suffix, [threads](MicroBenchState &state) {
+            BenchTasks(state, threads, EMPTY_TASK_COUNT, []() {});
+        });
+
+        // Independent arithmetic, the ideal case for scaling
+        MicroBench::Register("ThreadPool/Compute" + suffix, [threads](MicroBenchState &state) {
+            BenchTasks(state, threads, COMPUTE_TASK_COUNT, []() {
+                float value = 0.0f;
+                for (uint32_t i = 0; i < COMPUTE_TASK_STEPS; i++) {
+                    value += std::sqrt(static_cast<float>(i));
+                }
+                MicroBenchState::DoNotOptimize(value);
+            });
+        });
+
+        // What MeshManager::Init enqueues, bound by parsing and allocation
+        MicroBench::Register("ThreadPool/LoadMesh" + suffix, [threads](MicroBenchState &state) {
+            const std::string file = "../Assets/Models/Castle/Castle.obj";
+            if (!std::filesystem::exists(file)) {
+                return;
+            }
+            BenchTasks(state, threads, MESH_TASK_COUNT, [file]() {
+                const std::vector<VertexPNTT> vertices = file_system::LoadMesh(file);
+                MicroBenchState::DoNotOptimize(vertices);
+            });
+        });
+    }
+}
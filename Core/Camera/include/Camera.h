@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include <glm/detail/type_quat.hpp>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/glm.hpp>
@@ -7,6 +9,7 @@
 #include <Singleton.h>
 
 inline constexpr size_t FRUSTUM_CORNER_NUM = 8;
+inline constexpr size_t CASCADE_COUNT      = 4;
 
 enum class CameraMoveDirection : uint8_t {
     FORWARD,
@@ -49,7 +52,10 @@ public:
 
     [[nodiscard]] glm::mat4 GetViewMatrix() const { return glm::lookAt(m_location, m_location + m_front, m_up); }
 
-    [[nodiscard]] glm::mat4 GetProjectonMatrix() const { return glm::perspective(glm::radians(m_fov), RATIO, NEAR, FAR); }
+    [[nodiscard]] glm::mat4 GetProjectonMatrix() const { return glm::perspective(glm::radians(m_fov), GetAspectRatio(), NEAR, FAR); }
+
+    // Of the swapchain, follows the window as it is resized
+    [[nodiscard]] float GetAspectRatio() const;
 
     [[nodiscard]] float GetFOV() const { return m_fov; }
 
@@ -57,6 +63,16 @@ public:
 
     [[nodiscard]] glm::vec3 GetLocation() const { return m_location; }
 
+    // View space distances splitting the frustum into shadow cascades, from the near to the far plane
+    [[nodiscard]] std::array<float, CASCADE_COUNT + 1> GetCascadeSplits() const;
+
+    // World space corners of the frustum slice between two view space distances
+    [[nodiscard]] std::array<glm::vec3, FRUSTUM_CORNER_NUM> GetFrustumCorners(float nearDepth, float farDepth) const;
+
+    [[nodiscard]] float GetNear() const { return NEAR; }
+
+    [[nodiscard]] float GetFar() const { return FAR; }
+
 
 protected:
     Camera();
@@ -64,9 +80,8 @@ protected:
     ~Camera() = default;
 
 private:
-    static constexpr float RATIO = (16.0f / 9.0f);
-    static constexpr float NEAR  = 0.1f;
-    static constexpr float FAR   = 8.0f;
+    static constexpr float NEAR = 0.1f;
+    static constexpr float FAR  = 8.0f;
 
     glm::vec3 m_location;
     glm::vec3 m_worldUp;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct CameraKeyframe {
+    float     time = 0.0f; // Seconds
+    glm::vec3 location{0.0f};
+    glm::vec3 pitchYawRoll{0.0f}; // In degrees
+};
+
+// Keyframed camera flight sampled by time, so scripted runs render the same views on every machine
+class CameraPath {
+public:
+    CameraPath() = default;
+
+    explicit CameraPath(std::vector<CameraKeyframe> keyframes);
+
+    // Circles the origin at a fixed height while looking at it
+    static CameraPath Orbit(float radius, float height, float duration);
+
+    // One keyframe per line as "time x y z pitch yaw roll", lines starting with # are skipped
+    static CameraPath FromFile(const std::string &file);
+
+    // "orbit", "static" or a keyframe file
+    static CameraPath Load(const std::string &nameOrFile);
+
+    // Moves the camera to the interpolated pose, times past the ends clamp
+    void Apply(float time) const;
+
+    [[nodiscard]] float GetDuration() const { return m_keyframes.empty() ? 0.0f : m_keyframes.back().time; }
+
+private:
+    std::vector<CameraKeyframe> m_keyframes; // Sorted by time
+};
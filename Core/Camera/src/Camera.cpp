@@ -3,6 +3,7 @@
 #include <include/VulkanState.h>
 
 #include <algorithm>
+#include <cmath>
 
 namespace {
 constexpr float YAW         = -90.0f;
@@ -30,6 +31,43 @@ CameraData Camera::Update() {
     return data;
 }
 
+float Camera::GetAspectRatio() const {
+    return static_cast<float>(VulkanState::GetInstance().GetWidth()) / static_cast<float>(VulkanState::GetInstance().GetHeight());
+}
+
+std::array<float, CASCADE_COUNT + 1> Camera::GetCascadeSplits() const {
+    std::array<float, CASCADE_COUNT + 1> splits{};
+
+    // Practical split scheme, blends logarithmic and uniform splits
+    for (size_t i = 0; i <= CASCADE_COUNT; i++) {
+        const float ratio       = static_cast<float>(i) / CASCADE_COUNT;
+        const float logarithmic = NEAR * std::pow(FAR / NEAR, ratio);
+        const float uniform     = NEAR + (FAR - NEAR) * ratio;
+        splits[i]               = CASCADE_LAMBDA * logarithmic + (1.0f - CASCADE_LAMBDA) * uniform;
+    }
+    return splits;
+}
+
+std::array<glm::vec3, FRUSTUM_CORNER_NUM> Camera::GetFrustumCorners(float nearDepth, float farDepth) const {
+    const glm::mat4 inverse = glm::inverse(GetProjectonMatrix() * GetViewMatrix());
+
+    std::array<glm::vec3, FRUSTUM_CORNER_NUM> corners{};
+    for (size_t i = 0; i < FRUSTUM_CORNER_NUM / 2; i++) {
+        const float x = (i & 1) != 0 ? 1.0f : -1.0f;
+        const float y = (i & 2) != 0 ? 1.0f : -1.0f;
+
+        const glm::vec4 nearCorner = inverse * glm::vec4(x, y, 0.0f, 1.0f);
+        const glm::vec4 farCorner  = inverse * glm::vec4(x, y, 1.0f, 1.0f);
+        const glm::vec3 nearPoint  = glm::vec3(nearCorner) / nearCorner.w;
+        const glm::vec3 farPoint   = glm::vec3(farCorner) / farCorner.w;
+
+        // View space depth is linear along the edges between the near and far planes
+        corners[i]                          = glm::mix(nearPoint, farPoint, (nearDepth - NEAR) / (FAR - NEAR));
+        corners[i + FRUSTUM_CORNER_NUM / 2] = glm::mix(nearPoint, farPoint, (farDepth - NEAR) / (FAR - NEAR));
+    }
+    return corners;
+}
+
 void Camera::SetFov(float fov) {
     m_fov = fov;
 
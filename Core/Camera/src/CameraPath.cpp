@@ -0,0 +1,97 @@
+#include "include/CameraPath.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numbers>
+#include <sstream>
+
+#include <SDL3/SDL_log.h>
+
+#include <Debug.h>
+
+#include "include/Camera.h"
+
+namespace {
+constexpr float    ORBIT_RADIUS    = 4.0f;
+constexpr float    ORBIT_HEIGHT    = 1.0f;
+constexpr float    ORBIT_DURATION  = 10.0f;
+constexpr uint32_t ORBIT_KEYFRAMES = 72;
+} // namespace
+
+CameraPath::CameraPath(std::vector<CameraKeyframe> keyframes) : m_keyframes(std::move(keyframes)) {
+    std::ranges::stable_sort(m_keyframes, {}, &CameraKeyframe::time);
+}
+
+CameraPath CameraPath::Orbit(float radius, float height, float duration) {
+    std::vector<CameraKeyframe> keyframes;
+    keyframes.reserve(ORBIT_KEYFRAMES + 1);
+
+    // Yaw keeps growing past a full turn so interpolation never wraps the wrong way
+    const float pitch = glm::degrees(-std::atan2(height, radius));
+    for (uint32_t i = 0; i <= ORBIT_KEYFRAMES; i++) {
+        const float ratio = static_cast<float>(i) / ORBIT_KEYFRAMES;
+        const float angle = ratio * 2.0f * std::numbers::pi_v<float>;
+        keyframes.push_back({
+            .time         = ratio * duration,
+            .location     = glm::vec3(radius * std::cos(angle), height, radius * std::sin(angle)),
+            .pitchYawRoll = glm::vec3(pitch, glm::degrees(angle) + 180.0f, 0.0f),
+        });
+    }
+    return CameraPath(std::move(keyframes));
+}
+
+CameraPath CameraPath::FromFile(const std::string &file) {
+    std::ifstream input(file);
+    DEBUG_ASSERT_LOG(input.is_open(), (file + " does not exist").c_str());
+
+    std::vector<CameraKeyframe> keyframes;
+    std::string                 line;
+    while (std::getline(input, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream stream(line);
+        CameraKeyframe     keyframe;
+        stream >> keyframe.time >> keyframe.location.x >> keyframe.location.y >> keyframe.location.z;
+        stream >> keyframe.pitchYawRoll.x >> keyframe.pitchYawRoll.y >> keyframe.pitchYawRoll.z;
+        DEBUG_ASSERT_LOG(!stream.fail(), ("Malformed keyframe in " + file + ": " + line).c_str());
+        keyframes.push_back(keyframe);
+    }
+    DEBUG_ASSERT_LOG(!keyframes.empty(), (file + " has no keyframes").c_str());
+
+    return CameraPath(std::move(keyframes));
+}
+
+CameraPath CameraPath::Load(const std::string &nameOrFile) {
+    if (nameOrFile == "orbit") {
+        return Orbit(ORBIT_RADIUS, ORBIT_HEIGHT, ORBIT_DURATION);
+    }
+    if (nameOrFile == "static") {
+        return CameraPath({
+            {.time = 0.0f, .location = glm::vec3(0.0f), .pitchYawRoll = glm::vec3(0.0f, -90.0f, 0.0f)}
+        });
+    }
+
+    SDL_Log("Loading camera path from file %s", nameOrFile.c_str());
+    return FromFile(nameOrFile);
+}
+
+void CameraPath::Apply(float time) const {
+    if (m_keyframes.empty()) {
+        return;
+    }
+
+    const auto next = std::ranges::upper_bound(m_keyframes, time, {}, &CameraKeyframe::time);
+    if (next == m_keyframes.begin() || next == m_keyframes.end()) {
+        const CameraKeyframe &keyframe = next == m_keyframes.begin() ? m_keyframes.front() : m_keyframes.back();
+        Camera::GetInstance().SetLocation(keyframe.location);
+        Camera::GetInstance().SetRotation(glm::radians(keyframe.pitchYawRoll));
+        return;
+    }
+
+    const CameraKeyframe &from  = *(next - 1);
+    const float           ratio = (time - from.time) / (next->time - from.time);
+    Camera::GetInstance().SetLocation(glm::mix(from.location, next->location, ratio));
+    Camera::GetInstance().SetRotation(glm::radians(glm::mix(from.pitchYawRoll, next->pitchYawRoll, ratio)));
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <include/VulkanBuffer.h>
+
+// Mirrors clusters.glsl
+inline constexpr uint32_t CLUSTER_COUNT_X        = 16;
+inline constexpr uint32_t CLUSTER_COUNT_Y        = 9;
+inline constexpr uint32_t CLUSTER_COUNT_Z        = 24;
+inline constexpr uint32_t CLUSTER_COUNT          = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+inline constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+
+// Bins the lights into screen tiles times exponential depth slices in a compute shader,
+// shading then only loops over the lights of the fragment's cluster
+class ClusteredLighting {
+public:
+    ClusteredLighting() = delete;
+
+    ClusteredLighting(const VulkanBuffer &cameraBuffer, const VulkanBuffer &lightBuffer);
+
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting &)            = delete;
+    ClusteredLighting(ClusteredLighting &&)                 = delete;
+    ClusteredLighting &operator=(const ClusteredLighting &) = delete;
+    ClusteredLighting &operator=(ClusteredLighting &&)      = delete;
+
+    // Once per frame, uploads the lights and the cluster grid of the view
+    void Update(const glm::mat4 &projection, float near, float far, VkExtent2D renderExtent);
+
+    // Records the binning dispatch, must be outside of dynamic rendering
+    void Build();
+
+    // Writes the light list and cluster bindings of clusters.glsl into a set
+    void WriteDescriptorSet(VkDescriptorSet set) const;
+
+private:
+    VulkanBuffer m_lightListBuffer;
+    VulkanBuffer m_clusterBuffer;
+    VulkanBuffer m_rangeBuffer;
+    VulkanBuffer m_indexBuffer;
+    VulkanBuffer m_counterBuffer;
+
+    VkDescriptorSet m_clusterSet = VK_NULL_HANDLE;
+
+    void CreateBuffers();
+    void CreateDescriptorSet(const VulkanBuffer &cameraBuffer, const VulkanBuffer &lightBuffer);
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Instancing.h"
+
+struct DrawContent;
+
+enum class DrawPass : uint32_t {
+    Shadow = 0,   // Dynamic casters, or every caster without shadow caching
+    StaticShadow, // Casters kept in the static shadow cache
+    PointShadow,  // Every caster, drawn once per point shadow cube face
+    GBuffer,
+    Forward,
+    Count,
+};
+
+inline constexpr size_t DRAW_PASS_COUNT = static_cast<size_t>(DrawPass::Count);
+
+struct DrawPacket {
+    uint64_t      key   = 0;
+    uint32_t      batch = 0;
+    InstanceRange range;
+};
+
+struct DrawStats {
+    uint32_t draws      = 0;
+    uint32_t meshBinds  = 0;
+    uint32_t savedBinds = 0; // Binds skipped because the mesh was already bound
+};
+
+// Packets of every pass sorted by pass, pipeline, material, mesh and depth, recorded without redundant binds
+// Materials are bindless, their key bits only keep packets sampling the same textures together
+class DrawList {
+public:
+    void Clear();
+
+    // Depth is the view space distance, ids of 0 sort first
+    void Add(DrawPass pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth, uint32_t batch, InstanceRange range);
+
+    void Sort();
+
+    // Binds the mesh of each packet only when it changes, then calls draw
+    void Record(DrawPass pass, const DrawContent &content, const std::function<void(const DrawPacket &)> &draw);
+
+    [[nodiscard]] const DrawStats &GetStats(DrawPass pass) const { return m_stats[static_cast<size_t>(pass)]; }
+
+    [[nodiscard]] size_t GetPacketCount() const { return m_packets.size(); }
+
+private:
+    std::vector<DrawPacket>                m_packets;
+    std::vector<DrawPacket>                m_scratch;
+    std::array<DrawStats, DRAW_PASS_COUNT> m_stats;
+
+    static uint64_t MakeKey(DrawPass pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+struct RenderSettings;
+
+// Picks the scene's render resolution from the GPU time of the previous frame
+// Render targets stay at their full size, only the viewport shrinks
+class DynamicResolution {
+public:
+    DynamicResolution() = delete;
+
+    explicit DynamicResolution(VkExtent2D maxExtent);
+
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution &)            = delete;
+    DynamicResolution(DynamicResolution &&)                 = delete;
+    DynamicResolution &operator=(const DynamicResolution &) = delete;
+    DynamicResolution &operator=(DynamicResolution &&)      = delete;
+
+    // Reads the last frame's timing, picks this frame's extent and opens the timed range
+    // Must be recorded after the render fence is waited and outside of dynamic rendering
+    void BeginFrame(const RenderSettings &settings);
+
+    void EndFrame();
+
+    [[nodiscard]] const VkExtent2D &GetRenderExtent() const { return m_renderExtent; }
+
+    [[nodiscard]] const VkExtent2D &GetMaxExtent() const { return m_maxExtent; }
+
+    // Follows the window, the targets may be larger than this but never smaller
+    void SetMaxExtent(VkExtent2D maxExtent);
+
+    [[nodiscard]] float GetScale() const { return m_scale; }
+
+    // Smoothed milliseconds of the scene's graphics work, 0 until timestamps come back
+    [[nodiscard]] float GetGpuTime() const { return m_gpuTime; }
+
+    // Timestamps are optional on graphics queues, the scale stays at 1 without them
+    [[nodiscard]] bool IsSupported() const { return m_queryPool != VK_NULL_HANDLE; }
+
+private:
+    VkQueryPool m_queryPool       = VK_NULL_HANDLE;
+    float       m_timestampPeriod = 1.0f; // Nanoseconds per tick
+    bool        m_pending         = false;
+
+    VkExtent2D m_maxExtent    = {};
+    VkExtent2D m_renderExtent = {};
+    float      m_scale        = 1.0f;
+    float      m_gpuTime      = 0.0f;
+
+    void ReadTimestamps();
+    void UpdateScale(const RenderSettings &settings);
+};
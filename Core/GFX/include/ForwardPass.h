@@ -15,4 +15,6 @@ public:
 private:
     void CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) override;
     void DrawCalls(const DrawContent &content, VkPipelineLayout layout) override;
+
+    [[nodiscard]] const char *GetName() const override { return "Forward"; }
 };
\ No newline at end of file
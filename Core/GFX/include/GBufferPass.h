@@ -19,6 +19,12 @@ public:
     void PreRender();
     void PostRender();
 
+    // Later culling phases draw on top of the first one
+    void SetLoadOp(VkAttachmentLoadOp loadOp);
+
+    // Reallocates the images at this size and rewrites the set sampling them, the last frame's work must have retired
+    void Resize(VkExtent2D extent);
+
     [[nodiscard]] const VkDescriptorSet &GetGBufferSet() const { return m_gBufferSet; }
 
 private:
@@ -27,9 +33,12 @@ private:
     VkDescriptorSet                        m_gBufferSet = VK_NULL_HANDLE;
     VkSampler                              m_sampler = VK_NULL_HANDLE;
 
-    void CreateGBufferImages();
+    void CreateGBufferImages(VkExtent3D extent);
     void CreateGBufferSet();
+    void UpdateGBufferSet();
 
     void CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) override;
     void DrawCalls(const DrawContent &content, VkPipelineLayout layout) override;
+
+    [[nodiscard]] const char *GetName() const override { return "G-Buffer"; }
 };
\ No newline at end of file
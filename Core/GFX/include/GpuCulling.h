@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <include/Frustum.h>
+#include <include/VulkanBuffer.h>
+
+#include "Instancing.h"
+
+struct DrawContent;
+class HiZPass;
+
+// Phase 0 tests against the previous frame's depth pyramid, phase 1 re-tests what phase 0 rejected against the current one
+inline constexpr uint32_t CULL_PHASE_COUNT = 2;
+
+// Frustum and occlusion culls every instance of one view in a compute shader and writes compacted indirect draws per batch
+class GpuCulling {
+public:
+    GpuCulling() = delete;
+
+    GpuCulling(const DrawContent &content, const VulkanBuffer &instanceBuffer, const HiZPass &hiZPass);
+
+    ~GpuCulling();
+
+    GpuCulling(const GpuCulling &)            = delete;
+    GpuCulling(GpuCulling &&)                 = delete;
+    GpuCulling &operator=(const GpuCulling &) = delete;
+    GpuCulling &operator=(GpuCulling &&)      = delete;
+
+    // Once per frame before culling any phase
+    void SetView(const Frustum &frustum, const glm::mat4 &viewProjection, uint32_t instanceCount);
+
+    // Records the culling dispatch, must be outside of dynamic rendering
+    void Cull(uint32_t phase, bool occlusion);
+
+    // Expects the batch's mesh to be bound
+    void DrawBatch(uint32_t batch, uint32_t phase) const;
+
+    // Rewrites the pyramid binding after the Hi-Z pass was resized, the rest of the set does not depend on the window
+    void UpdatePyramid();
+
+private:
+    VulkanBuffer m_cullBuffer;
+    VulkanBuffer m_batchBuffer;
+    VulkanBuffer m_commandBuffer;
+    VulkanBuffer m_countBuffer;
+    VulkanBuffer m_occludedBuffer;
+
+    std::vector<uint32_t> m_firstCommands;
+    std::vector<uint32_t> m_maxDrawCounts;
+
+    const HiZPass  *m_hiZPass       = nullptr;
+    VkDescriptorSet m_cullSet       = VK_NULL_HANDLE;
+    uint32_t        m_batchCount    = 0;
+    uint32_t        m_commandCount  = 0;
+    uint32_t        m_instanceCount = 0;
+
+    void CreateBuffers(const DrawContent &content);
+    void CreateDescriptorSet(const VulkanBuffer &instanceBuffer);
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <include/VulkanImage.h>
+
+// Builds a min/max depth pyramid in compute, sampled by GPU occlusion culling
+class HiZPass {
+public:
+    HiZPass() = delete;
+
+    explicit HiZPass(const VulkanImage &depthImage);
+
+    ~HiZPass();
+
+    HiZPass(const HiZPass &)            = delete;
+    HiZPass(HiZPass &&)                 = delete;
+    HiZPass &operator=(const HiZPass &) = delete;
+    HiZPass &operator=(HiZPass &&)      = delete;
+
+    // Depth must be in shader read only layout, the pyramid stays in general layout
+    // Only the top left render extent of the depth is valid under dynamic resolution
+    void Build(VkExtent2D renderExtent);
+
+    // Rebuilds the pyramid for a reallocated depth image, the last frame's graphics and compute work must have retired
+    // Occlusion culling skips a frame until the new pyramid is built, and sets sampling the pyramid have to be rewritten
+    void Resize(const VulkanImage &depthImage);
+
+    [[nodiscard]] const VkImageView &GetPyramidView() const { return m_pyramid.GetImageView(); }
+
+    [[nodiscard]] const VkSampler &GetSampler() const { return m_sampler; }
+
+    [[nodiscard]] const VkExtent2D &GetExtent() const { return m_extent; }
+
+    [[nodiscard]] uint32_t GetLevelCount() const { return m_levelCount; }
+
+    // Maps screen uvs of the view the pyramid was last built from into the pyramid
+    [[nodiscard]] const glm::vec2 &GetUvScale() const { return m_uvScale; }
+
+    // False until the first build, the pyramid holds garbage before that
+    [[nodiscard]] bool IsBuilt() const { return m_built; }
+
+private:
+    VulkanImage                  m_pyramid;
+    std::vector<VkImageView>     m_levelViews;
+    std::vector<VkDescriptorSet> m_levelSets;
+    VkSampler                    m_sampler    = VK_NULL_HANDLE;
+    VkExtent2D                   m_extent     = {};
+    uint32_t                     m_levelCount = 0;
+    glm::vec2                    m_uvScale    = glm::vec2(1.0f);
+    bool                         m_built      = false;
+
+    void CreatePyramid();
+    void DestroyPyramid();
+    void CreateLevelSets(const VulkanImage &depthImage);
+};
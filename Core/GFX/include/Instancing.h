@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class VulkanObject;
+
+// Per instance data in the instance storage buffer, mirrors instances.glsl
+struct alignas(16) InstanceData {
+    glm::mat4                 model;
+    glm::vec4                 sphere; // World space bounding sphere
+    uint32_t                  batch    = 0;
+    uint32_t                  material = 0; // Bindless material index
+    [[maybe_unused]] uint32_t padding1 = 0;
+    [[maybe_unused]] uint32_t padding2 = 0;
+};
+
+// Instances sharing a mesh and a material, drawn together
+struct DrawBatch {
+    const VulkanObject *object        = nullptr;
+    uint32_t            firstCommand  = 0; // First command in the GPU culling command buffer
+    uint32_t            instanceCount = 0;
+};
+
+// Range of the instance index buffer drawn by one instanced draw
+struct InstanceRange {
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+namespace instancing {
+// Sorts the visible scene indices by batch into indices starting at offset, writes one range per batch
+void BuildRanges(
+    const std::vector<uint32_t> &visible,
+    const std::vector<uint32_t> &instanceBatches,
+    uint32_t                     offset,
+    std::vector<uint32_t>       &indices,
+    std::vector<InstanceRange>  &ranges
+);
+} // namespace instancing
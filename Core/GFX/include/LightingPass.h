@@ -17,4 +17,6 @@ public:
 private:
     void CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) override;
     void DrawCalls(const DrawContent &content, VkPipelineLayout layout) override;
+
+    [[nodiscard]] const char *GetName() const override { return "Lighting"; }
 };
\ No newline at end of file
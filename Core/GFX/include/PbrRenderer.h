@@ -1,12 +1,22 @@
 #pragma once
 
 
+#include <memory>
 #include <vector>
 
+#include <include/ClusteredLighting.h>
+#include <include/DrawList.h>
+#include <include/DynamicResolution.h>
 #include <include/ForwardPass.h>
 #include <include/GBufferPass.h>
+#include <include/GpuCulling.h>
+#include <include/HiZPass.h>
 #include <include/LightingPass.h>
+#include <include/PointShadowPass.h>
 #include <include/PostProcessingPass.h>
+#include <include/RenderSettings.h>
+#include <include/SceneDescription.h>
+#include <include/SceneStore.h>
 #include <include/ShadowPass.h>
 #include <include/SkyboxPass.h>
 #include <include/UIRenderer.h>
@@ -14,19 +24,39 @@
 #include <include/VulkanPrefab.h>
 
 struct DrawContent {
-    std::vector<VulkanPrefab> deferredPrefabs;
-    std::vector<VulkanPrefab> frontPrefabs;
-    VulkanMesh               *screen;
-    VkRenderingAttachmentInfo drawAttachments;
-    VkRenderingAttachmentInfo depthAttachments;
-    VkRenderingAttachmentInfo postProcessdAttachments;
+    std::vector<VulkanPrefab>  deferredPrefabs;
+    std::vector<VulkanPrefab>  frontPrefabs;
+    SceneStore                 scene;                        // Deferred prefabs first, followed by front prefabs
+    std::vector<uint32_t>      cameraVisible;                // Scene indices inside the camera frustum
+    std::vector<uint32_t>      shadowVisible;                // Scene indices inside the light frustum, dynamic only when caching
+    std::vector<uint32_t>      staticShadowVisible;          // Static casters redrawn into the shadow cache
+    std::vector<InstanceRange> cameraRanges;                 // Per batch instances drawn after CPU culling
+    std::vector<InstanceRange> shadowRanges;
+    std::vector<InstanceRange> staticShadowRanges;
+    std::vector<InstanceRange> pointShadowRanges;            // Every instance, point shadows are not culled
+    std::vector<DrawBatch>     batches;                      // Deferred batches first, followed by front batches
+    std::vector<uint32_t>      instanceBatches;              // Batch of each scene index
+    uint32_t                   deferredBatchCount = 0;
+    const GpuCulling          *cameraCulling      = nullptr; // Set when draws come from GPU culling
+    const GpuCulling          *shadowCulling      = nullptr;
+    uint32_t                   cullingPhase       = 0;       // Phase drawn by the G-buffer pass
+    DrawList                  *drawList           = nullptr;
+    VulkanMesh                *screen;
+    VkRenderingAttachmentInfo  drawAttachments;
+    VkRenderingAttachmentInfo  depthAttachments;
+
+    [[nodiscard]] const VulkanPrefab &GetPrefab(uint32_t index) const {
+        return index < deferredPrefabs.size() ? deferredPrefabs[index] : frontPrefabs[index - deferredPrefabs.size()];
+    }
 };
 
 class PbrRenderer {
 public:
     PbrRenderer() = delete;
 
-    explicit PbrRenderer(UIRenderer &uiRenderer);
+    explicit PbrRenderer(UIRenderer &uiRenderer) : PbrRenderer(uiRenderer, SceneDescription::Default()) {}
+
+    PbrRenderer(UIRenderer &uiRenderer, const SceneDescription &scene);
 
     ~PbrRenderer();
 
@@ -37,22 +67,27 @@ public:
 
     void Render();
 
+    // Records the post chain after the UI is drawn, into the async compute command buffer when enabled
+    void PostProcess();
+
+    // After the swapchain is recreated and the UI overlay resized, recreation already waited for the last frame's graphics and compute work
+    // Targets are reallocated with hysteresis, and only the sets reading reallocated images are rewritten
+    void Resize(const VulkanImage &uiOverlay);
+
     [[nodiscard]] const VkExtent3D &GetDrawImageExtent() const { return m_drawImage.GetExtent(); }
 
 private:
     VulkanImage m_depthImage;
     VulkanImage m_drawImage;
-    VulkanImage m_postProcessedImage;
-    VkSampler   m_sampler;
 
     RenderingConfig m_config;
 
-    ShadowPass         m_shadowPass;
-    GBufferPass        m_gBufferPass;
-    LightingPass       m_lightingPass;
-    ForwardPass        m_forwardPass;
-    SkyboxPass         m_skybox;
-    PostProcessingPass m_postProcessingPass;
+    ShadowPass      m_shadowPass;
+    PointShadowPass m_pointShadowPass;
+    GBufferPass     m_gBufferPass;
+    LightingPass    m_lightingPass;
+    ForwardPass     m_forwardPass;
+    SkyboxPass      m_skybox;
 
     DrawContent m_drawContent;
 
@@ -62,18 +97,45 @@ private:
 
     VulkanBuffer m_cameraBuffer;
     VulkanBuffer m_lightBuffer;
-
-    VkDescriptorSet m_uniformSet        = VK_NULL_HANDLE;
-    VkDescriptorSet m_cameraSet         = VK_NULL_HANDLE;
-    VkDescriptorSet m_iblSet            = VK_NULL_HANDLE;
-    VkDescriptorSet m_uniformShadowSet  = VK_NULL_HANDLE;
-    VkDescriptorSet m_uniformForwardSet = VK_NULL_HANDLE;
-    VkDescriptorSet m_postProcessSet    = VK_NULL_HANDLE;
+    VulkanBuffer m_instanceBuffer;
+    VulkanBuffer m_instanceIndexBuffer;
+
+    std::unique_ptr<HiZPass>    m_hiZPass;
+    std::unique_ptr<GpuCulling> m_cameraCulling;
+    std::unique_ptr<GpuCulling> m_shadowCulling;
+
+    std::unique_ptr<ClusteredLighting>  m_clusteredLighting;
+    std::unique_ptr<PostProcessingPass> m_postProcessingPass;
+    std::unique_ptr<DynamicResolution>  m_dynamicResolution;
+
+    DrawList                  m_drawList;
+    RenderSettings            m_settings;
+    std::vector<InstanceData> m_instances;
+    std::vector<uint32_t>     m_instanceIndices;
+
+    ShadowUpdate m_shadowUpdate  = ShadowUpdate::All;
+    bool         m_castersMoved  = false; // Some instance moved this frame
+    bool         m_staticChanged = false; // Some instance moved for the first time and left the shadow cache
+
+    VkDescriptorSet m_uniformSet            = VK_NULL_HANDLE;
+    VkDescriptorSet m_cameraSet             = VK_NULL_HANDLE;
+    VkDescriptorSet m_uniformGBufferSet     = VK_NULL_HANDLE;
+    VkDescriptorSet m_iblSet                = VK_NULL_HANDLE;
+    VkDescriptorSet m_uniformShadowSet      = VK_NULL_HANDLE;
+    VkDescriptorSet m_uniformPointShadowSet = VK_NULL_HANDLE;
+    VkDescriptorSet m_uniformForwardSet     = VK_NULL_HANDLE;
 
     void CreateImages();
-    void CreateDrawContent();
+    void CreateTargets(VkExtent2D extent);
+    void CreateDrawContent(const SceneDescription &scene);
+    void CreateBatches();
+    void UpdateScene();
+    void CullScene(const glm::mat4 &viewProjection, const glm::mat4 &lightSpaceMatrix);
+    void BuildDrawList(const glm::mat4 &view);
+    void RenderShadows();
+    void RenderGBuffer();
     void CreateBuffers();
     void CreateDescriptorSets();
-    void CreateRenderConfig();
+    void UpdateRenderConfig(VkExtent2D extent);
     void OneTimeUpdateDescriptorSets();
 };
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <include/Camera.h>
+#include <include/VulkanBuffer.h>
+#include <include/VulkanImage.h>
+
+#include "RenderPass.h"
+#include "ShadowAtlas.h"
+
+inline constexpr uint32_t CUBE_FACE_COUNT        = 6;
+inline constexpr uint32_t MAX_POINT_SHADOW_COUNT = 32;
+
+// Cube shadows of the point lights in tiles of one atlas, tiles are sized by the light's screen coverage
+// and only a budget of shadows is redrawn per frame
+class PointShadowPass : public RenderPass {
+public:
+    PointShadowPass();
+
+    ~PointShadowPass();
+
+    PointShadowPass(const PointShadowPass &)            = delete;
+    PointShadowPass(PointShadowPass &&)                 = delete;
+    PointShadowPass &operator=(const PointShadowPass &) = delete;
+    PointShadowPass &operator=(PointShadowPass &&)      = delete;
+
+    // Once per frame, picks the shadowed lights and the shadows redrawn this frame
+    void Update(const CameraData &cameraData, bool castersMoved);
+
+    // Whether the pass has to render this frame
+    [[nodiscard]] bool HasWork() const { return !m_pending.empty() || !m_initialized; }
+
+    void PreRender();
+    void PostRender();
+
+    // Writes the atlas and the shadow records into the shadow set
+    void WriteDescriptorSet(VkDescriptorSet set) const;
+
+    [[nodiscard]] size_t GetShadowCount() const { return m_shadows.size(); }
+
+    [[nodiscard]] size_t GetUpdateCount() const { return m_pending.size(); }
+
+private:
+    struct PointShadow {
+        uint32_t                               light = 0;
+        glm::vec3                              position;
+        float                                  range    = 0.0f;
+        float                                  coverage = 0.0f; // Projected radius over the screen height
+        std::array<AtlasTile, CUBE_FACE_COUNT> tiles;
+        std::array<glm::mat4, CUBE_FACE_COUNT> faceMatrices;
+        bool                                   ready = false; // Drawn at least once since its tiles were allocated
+        bool                                   dirty = true;
+    };
+
+    VulkanImage               m_atlas;
+    VkRenderingAttachmentInfo m_atlasAttachment;
+    VkSampler                 m_sampler = VK_NULL_HANDLE;
+    ShadowAtlas               m_allocator;
+
+    VulkanBuffer m_shadowBuffer;
+    VulkanBuffer m_lightShadowBuffer;
+
+    std::vector<PointShadow> m_shadows;
+    std::vector<uint32_t>    m_pending; // Shadows drawn this frame
+    std::vector<int32_t>     m_lightShadows;
+    bool                     m_initialized = false;
+
+    void SelectShadows(const CameraData &cameraData);
+    bool AllocateTiles(PointShadow &shadow, uint32_t tileSize);
+    void FreeTiles(const PointShadow &shadow);
+    void Upload();
+
+    void CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) override;
+    void DrawCalls(const DrawContent &content, VkPipelineLayout layout) override;
+
+    [[nodiscard]] const char *GetName() const override { return "Point Shadow"; }
+};
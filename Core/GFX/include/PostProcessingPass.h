@@ -1,18 +1,58 @@
 #pragma once
 
-#include "RenderPass.h"
+#include <vector>
 
-class PostProcessingPass : public RenderPass {
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <include/VulkanImage.h>
+
+struct RenderSettings;
+
+// Bloom, tonemapping and FXAA as a chain of compute dispatches writing straight into the swapchain image
+// The chain may be recorded into the async compute command buffer, it only touches its own images
+class PostProcessingPass {
 public:
-    PostProcessingPass()  = default;
-    ~PostProcessingPass() = default;
+    PostProcessingPass() = delete;
+
+    // The draw image must be in shader read only layout when the chain runs, the UI overlay too
+    PostProcessingPass(const VulkanImage &drawImage, const VulkanImage &uiOverlay);
+
+    ~PostProcessingPass();
 
-    PostProcessingPass(const PostProcessingPass&) = delete;
-    PostProcessingPass(PostProcessingPass&&) = delete;
-    PostProcessingPass& operator=(const PostProcessingPass&) = delete;
-    PostProcessingPass& operator=(PostProcessingPass&&) = delete;
+    PostProcessingPass(const PostProcessingPass &)            = delete;
+    PostProcessingPass(PostProcessingPass &&)                 = delete;
+    PostProcessingPass &operator=(const PostProcessingPass &) = delete;
+    PostProcessingPass &operator=(PostProcessingPass &&)      = delete;
+
+    // Upscales the top left render extent of the draw image to the swapchain, which is left in present layout
+    void Render(VkCommandBuffer cmdBuf, const RenderSettings &settings, VkExtent2D renderExtent);
+
+    // After the swapchain is recreated, which waits for the last frame's graphics and compute work to retire
+    // Reallocates only what the new sizes no longer fit and rewrites only the sets reading changed images
+    void Resize(const VulkanImage &drawImage, const VulkanImage &uiOverlay);
 
 private:
-    void CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) override;
-    void DrawCalls(const DrawContent &content, VkPipelineLayout layout) override;
-};
\ No newline at end of file
+    VulkanImage                  m_bloom;
+    VulkanImage                  m_tonemapped;
+    std::vector<VkImageView>     m_bloomViews;
+    std::vector<VkDescriptorSet> m_downsampleSets;
+    std::vector<VkDescriptorSet> m_upsampleSets;
+    std::vector<VkDescriptorSet> m_fxaaSets; // One per swapchain image
+    VkDescriptorSet              m_tonemapSet      = VK_NULL_HANDLE;
+    VkSampler                    m_sampler         = VK_NULL_HANDLE;
+    VkExtent2D                   m_extent          = {}; // Swapchain size, the tonemapped image may be larger
+    VkExtent2D                   m_sceneExtent     = {}; // Of the draw image
+    VkExtent2D                   m_bloomExtent     = {};
+    uint32_t                     m_bloomLevelCount = 0;
+    bool                         m_initialized     = false;
+
+    void CreateBloom(const VulkanImage &drawImage);
+    void DestroyBloom();
+    void CreateTonemapped(VkExtent2D extent);
+    void CreateBloomSets(const VulkanImage &drawImage);
+    void UpdateTonemapSet(const VulkanImage &drawImage);
+    void UpdateFxaaSets(const VulkanImage &uiOverlay);
+
+    void RenderBloom(VkCommandBuffer cmdBuf, const RenderSettings &settings, const glm::vec2 &sceneUvScale);
+};
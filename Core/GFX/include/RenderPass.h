@@ -1,5 +1,6 @@
 #pragma once
 
+#include <include/GpuProfiler.h>
 #include <include/VulkanGraphicsPipeline.h>
 
 
@@ -23,6 +24,9 @@ public:
     ) {
         CreateRenderingInfo(config, content);
 
+        // Queries may not span the begin or end of dynamic rendering, so the zone wraps it
+        GpuZone zone(VulkanState::GetInstance().GetCommandBuffer(), GetName());
+
         vkCmdBeginRendering(VulkanState::GetInstance().GetCommandBuffer(), &m_infoRendering);
         vkCmdSetViewport(VulkanState::GetInstance().GetCommandBuffer(), 0, 1, &m_viewport);
         vkCmdSetScissor(VulkanState::GetInstance().GetCommandBuffer(), 0, 1, &m_infoRendering.renderArea);
@@ -44,6 +48,9 @@ protected:
     virtual void CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) = 0;
     virtual void DrawCalls(const DrawContent &content, VkPipelineLayout layout)                 = 0;
 
+    // Zone of the pass in the GPU profiler, passes rendered several times a frame are summed
+    [[nodiscard]] virtual const char *GetName() const = 0;
+
 private:
     void Bind(const std::vector<std::pair<VkDescriptorSet, uint32_t>> &globalSets, VulkanGraphicsPipeline *pipeline) {
         vkCmdBindPipeline(VulkanState::GetInstance().GetCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->GetPipeline());
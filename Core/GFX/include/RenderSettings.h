@@ -0,0 +1,20 @@
+#pragma once
+
+// Renderer toggles exposed through the UI
+struct RenderSettings {
+    bool gpuCulling       = false; // Cull on the GPU and draw through indirect commands
+    bool occlusionCulling = true;  // Two-phase Hi-Z occlusion on top of GPU culling
+    bool shadowCaching    = true;  // Keep casters that never moved in a cached shadow layer
+
+    bool  bloom          = true;
+    float bloomThreshold = 1.0f; // Scene luminance where bloom starts
+    float bloomIntensity = 0.05f;
+    float exposure       = 1.0f;
+    bool  fxaa           = true;
+    bool  asyncCompute   = true; // Run post-processing on the compute queue, overlapping the next frame
+
+    bool  dynamicResolution = false; // Scale the scene's resolution to hold the target GPU time
+    float targetFrameTime   = 16.6f; // Milliseconds
+    float minRenderScale    = 0.5f;
+    float upscaleSharpness  = 0.5f;
+};
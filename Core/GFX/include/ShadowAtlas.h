@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Square region of the atlas in texels
+struct AtlasTile {
+    uint32_t x    = 0;
+    uint32_t y    = 0;
+    uint32_t size = 0;
+
+    bool operator==(const AtlasTile &) const = default;
+};
+
+// Quadtree allocator handing out power of two tiles, freed siblings merge back into their parent
+class ShadowAtlas {
+public:
+    ShadowAtlas() = delete;
+
+    ShadowAtlas(uint32_t size, uint32_t minTileSize);
+
+    // Size is rounded up to a power of two, empty when no tile of that size is left
+    std::optional<AtlasTile> Allocate(uint32_t size);
+
+    void Free(const AtlasTile &tile);
+
+    void Clear();
+
+    [[nodiscard]] uint32_t GetSize() const { return m_size; }
+
+private:
+    uint32_t m_size        = 0;
+    uint32_t m_minTileSize = 0;
+
+    // Free tiles per level, level 0 is the whole atlas
+    std::vector<std::vector<AtlasTile>> m_freeTiles;
+
+    [[nodiscard]] uint32_t GetLevel(uint32_t size) const;
+    std::optional<AtlasTile> AllocateLevel(uint32_t level);
+};
@@ -1,7 +1,21 @@
 #pragma once
 
+#include <array>
+
+#include <glm/glm.hpp>
+
+#include <include/LightManager.h>
+
 #include "RenderPass.h"
 
+// How much of the shadow map a frame redraws
+enum class ShadowUpdate : uint8_t {
+    Skip,    // Neither the cascades nor any caster moved, last frame's map is kept
+    All,     // Caching is off, every caster is drawn
+    Dynamic, // The static cache is copied in and the dynamic casters are drawn on top
+    Full,    // The static cache is redrawn first, then the dynamic step runs
+};
+
 class ShadowPass : public RenderPass {
 public:
     ShadowPass();
@@ -13,22 +27,38 @@ public:
     ShadowPass &operator=(const ShadowPass &) = delete;
     ShadowPass &operator=(ShadowPass &&)      = delete;
 
-    void PreRender();
+    // Once per frame, castersMoved is set when any caster moved and staticChanged when one left the static cache
+    ShadowUpdate Update(const LightsData &lights, bool castersMoved, bool staticChanged, bool caching);
+
+    // Around the render of the static casters into the cache, full updates only
+    void PreRenderStatic();
+    void PostRenderStatic();
+
+    void PreRender(ShadowUpdate update);
     void PostRender();
 
     [[nodiscard]] const VkDescriptorSet &GetCSMSet() const { return m_shadowSet; }
 
 private:
     VulkanImage               m_shadowMap;
+    VulkanImage               m_staticCache;
     VkRenderingAttachmentInfo m_shadowAttachment;
+    VkRenderingAttachmentInfo m_staticAttachment;
     VkDescriptorSet           m_shadowSet;
     VkSampler                 m_sampler;
 
     VkExtent2D                m_extent;
 
+    std::array<glm::mat4, CASCADE_COUNT> m_cascadeMatrices{};
+    bool                                 m_valid           = false;
+    bool                                 m_cacheValid      = false;
+    bool                                 m_renderingStatic = false;
+
     void CreateShadowMapImage();
     void CreateCSMSet();
 
     void CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) override;
     void DrawCalls(const DrawContent &content, VkPipelineLayout layout) override;
-};
\ No newline at end of file
+
+    [[nodiscard]] const char *GetName() const override { return "Shadow"; }
+};
@@ -34,4 +34,6 @@ private:
 
     void CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) override;
     void DrawCalls(const DrawContent &content, VkPipelineLayout layout) override;
+
+    [[nodiscard]] const char *GetName() const override { return "Skybox"; }
 };
\ No newline at end of file
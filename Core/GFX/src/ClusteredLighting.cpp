@@ -0,0 +1,195 @@
+#include "include/ClusteredLighting.h"
+
+#include <cmath>
+#include <vector>
+
+#include <include/Descriptor.h>
+#include <include/LightManager.h>
+#include <include/PipelineManager.h>
+#include <include/VulkanState.h>
+#include <include/VulkanUtil.h>
+
+namespace {
+// Mirrors clusters.glsl
+struct alignas(16) ClusterData {
+    glm::mat4              inverseProjection;
+    glm::vec2              tileSize;
+    float                  sliceScale = 0.0f;
+    float                  sliceBias  = 0.0f;
+    float                  near       = 0.0f;
+    float                  far        = 0.0f;
+    [[maybe_unused]] float padding0   = 0.0f;
+    [[maybe_unused]] float padding1   = 0.0f;
+};
+} // namespace
+
+ClusteredLighting::ClusteredLighting(const VulkanBuffer &cameraBuffer, const VulkanBuffer &lightBuffer) {
+    CreateBuffers();
+    CreateDescriptorSet(cameraBuffer, lightBuffer);
+}
+
+ClusteredLighting::~ClusteredLighting() {
+    if (m_clusterSet != VK_NULL_HANDLE) {
+        vk_util::FreeDescriptorSet(m_clusterSet);
+    }
+    m_clusterSet = VK_NULL_HANDLE;
+}
+
+void ClusteredLighting::Update(const glm::mat4 &projection, float near, float far, VkExtent2D renderExtent) {
+    const std::vector<Light> &lights = LightManager::GetInstance().GetLights();
+    m_lightListBuffer.Upload(sizeof(Light) * lights.size(), lights.data());
+
+    // slice = log(depth) * scale + bias inverts depth = near * (far / near) ^ (slice / count)
+    const float logRatio = std::log(far / near);
+
+    const ClusterData clusterData{
+        .inverseProjection = glm::inverse(projection),
+        .tileSize          = glm::vec2(
+            static_cast<float>(renderExtent.width) / CLUSTER_COUNT_X,
+            static_cast<float>(renderExtent.height) / CLUSTER_COUNT_Y
+        ),
+        .sliceScale = CLUSTER_COUNT_Z / logRatio,
+        .sliceBias  = -CLUSTER_COUNT_Z * std::log(near) / logRatio,
+        .near       = near,
+        .far        = far,
+    };
+    m_clusterBuffer.Upload(sizeof(ClusterData), &clusterData);
+}
+
+void ClusteredLighting::Build() {
+    const VkCommandBuffer cmdBuf = VulkanState::GetInstance().GetCommandBuffer();
+
+    // Last frame's shading has finished reading the lists once the render fence is waited
+    vkCmdFillBuffer(cmdBuf, m_counterBuffer.GetBuffer(), 0, VK_WHOLE_SIZE, 0);
+    vk_util::CmdMemoryBarrier(
+        cmdBuf,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    );
+
+    const VulkanPipeline *pipeline = PipelineManager::GetInstance().Load("cluster_comp");
+    vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetPipeline());
+    vkCmdBindDescriptorSets(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetLayout(), descriptor::UNIFORM_SET, 1, &m_clusterSet, 0, nullptr);
+    vkCmdDispatch(cmdBuf, 1, 1, CLUSTER_COUNT_Z);
+
+    vk_util::CmdMemoryBarrier(
+        cmdBuf,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT
+    );
+}
+
+void ClusteredLighting::WriteDescriptorSet(VkDescriptorSet set) const {
+    VkDescriptorBufferInfo infoLightList{.buffer = m_lightListBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE};
+    VkDescriptorBufferInfo infoCluster{.buffer = m_clusterBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE};
+
+    std::vector<VkDescriptorBufferInfo> infoLists{
+        {.buffer = m_rangeBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = m_indexBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE},
+    };
+
+    std::vector<VkWriteDescriptorSet> writeSets{
+        {
+         .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .pNext            = nullptr,
+         .dstSet           = set,
+         .dstBinding       = 4,
+         .dstArrayElement  = 0,
+         .descriptorCount  = 1,
+         .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         .pImageInfo       = nullptr,
+         .pBufferInfo      = &infoLightList,
+         .pTexelBufferView = nullptr,
+         },
+        {
+         .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .pNext            = nullptr,
+         .dstSet           = set,
+         .dstBinding       = 5,
+         .dstArrayElement  = 0,
+         .descriptorCount  = 1,
+         .descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+         .pImageInfo       = nullptr,
+         .pBufferInfo      = &infoCluster,
+         .pTexelBufferView = nullptr,
+         },
+        {
+         .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .pNext            = nullptr,
+         .dstSet           = set,
+         .dstBinding       = 6,
+         .dstArrayElement  = 0,
+         .descriptorCount  = static_cast<uint32_t>(infoLists.size()),
+         .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         .pImageInfo       = nullptr,
+         .pBufferInfo      = infoLists.data(),
+         .pTexelBufferView = nullptr,
+         },
+    };
+
+    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+}
+
+void ClusteredLighting::CreateBuffers() {
+    VulkanBuffer lightListBuffer(sizeof(Light) * MAX_LIGHT_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_lightListBuffer = std::move(lightListBuffer);
+
+    VulkanBuffer clusterBuffer(sizeof(ClusterData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    m_clusterBuffer = std::move(clusterBuffer);
+
+    VulkanBuffer rangeBuffer(sizeof(glm::uvec2) * CLUSTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_rangeBuffer = std::move(rangeBuffer);
+
+    // Large enough for every cluster to be full
+    VulkanBuffer indexBuffer(sizeof(uint32_t) * CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_indexBuffer = std::move(indexBuffer);
+
+    VulkanBuffer counterBuffer(sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    m_counterBuffer = std::move(counterBuffer);
+}
+
+void ClusteredLighting::CreateDescriptorSet(const VulkanBuffer &cameraBuffer, const VulkanBuffer &lightBuffer) {
+    m_clusterSet =
+        vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("cluster_comp")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
+
+    std::vector<VkDescriptorBufferInfo> infoUniforms{
+        {.buffer = cameraBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = lightBuffer.GetBuffer(),  .offset = 0, .range = VK_WHOLE_SIZE},
+    };
+
+    VkDescriptorBufferInfo infoCounter{.buffer = m_counterBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE};
+
+    std::vector<VkWriteDescriptorSet> writeSets{
+        {
+         .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .pNext            = nullptr,
+         .dstSet           = m_clusterSet,
+         .dstBinding       = 0,
+         .dstArrayElement  = 0,
+         .descriptorCount  = static_cast<uint32_t>(infoUniforms.size()),
+         .descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+         .pImageInfo       = nullptr,
+         .pBufferInfo      = infoUniforms.data(),
+         .pTexelBufferView = nullptr,
+         },
+        {
+         .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .pNext            = nullptr,
+         .dstSet           = m_clusterSet,
+         .dstBinding       = 8,
+         .dstArrayElement  = 0,
+         .descriptorCount  = 1,
+         .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         .pImageInfo       = nullptr,
+         .pBufferInfo      = &infoCounter,
+         .pTexelBufferView = nullptr,
+         },
+    };
+
+    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+    WriteDescriptorSet(m_clusterSet);
+}
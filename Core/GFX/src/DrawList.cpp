@@ -0,0 +1,105 @@
+#include "include/DrawList.h"
+
+#include <algorithm>
+#include <bit>
+
+#include <include/PbrRenderer.h>
+#include <include/VulkanMesh.h>
+#include <include/VulkanObject.h>
+
+namespace {
+// Key layout from the most significant bit
+constexpr uint32_t PASS_BITS     = 4;
+constexpr uint32_t PIPELINE_BITS = 8;
+constexpr uint32_t MATERIAL_BITS = 16;
+constexpr uint32_t MESH_BITS     = 16;
+constexpr uint32_t DEPTH_BITS    = 20;
+
+constexpr uint32_t DEPTH_SHIFT    = 0;
+constexpr uint32_t MESH_SHIFT     = DEPTH_SHIFT + DEPTH_BITS;
+constexpr uint32_t MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+constexpr uint32_t PIPELINE_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+constexpr uint32_t PASS_SHIFT     = PIPELINE_SHIFT + PIPELINE_BITS;
+
+static_assert(PASS_SHIFT + PASS_BITS == 64);
+static_assert(DRAW_PASS_COUNT <= (1u << PASS_BITS));
+
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX_SIZE = 1u << RADIX_BITS;
+
+uint64_t Field(uint32_t value, uint32_t bits, uint32_t shift) { return (static_cast<uint64_t>(value) & ((1ull << bits) - 1)) << shift; }
+
+// Positive floats order like their bit patterns, keep the highest bits
+uint32_t QuantizeDepth(float depth) { return std::bit_cast<uint32_t>(std::max(depth, 0.0f)) >> (32 - DEPTH_BITS); }
+} // namespace
+
+void DrawList::Clear() {
+    m_packets.clear();
+    m_stats = {};
+}
+
+void DrawList::Add(DrawPass pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth, uint32_t batch, InstanceRange range) {
+    m_packets.push_back({.key = MakeKey(pass, pipeline, material, mesh, depth), .batch = batch, .range = range});
+}
+
+void DrawList::Sort() {
+    if (m_packets.size() < 2) {
+        return;
+    }
+
+    // LSD radix sort, digits shared by every key are skipped
+    m_scratch.resize(m_packets.size());
+    for (uint32_t shift = 0; shift < 64; shift += RADIX_BITS) {
+        std::array<uint32_t, RADIX_SIZE> offsets{};
+        for (const auto &packet: m_packets) {
+            offsets[(packet.key >> shift) & (RADIX_SIZE - 1)]++;
+        }
+        if (offsets[(m_packets[0].key >> shift) & (RADIX_SIZE - 1)] == m_packets.size()) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (auto &count: offsets) {
+            const uint32_t digitCount = count;
+            count                     = offset;
+            offset                   += digitCount;
+        }
+        for (const auto &packet: m_packets) {
+            m_scratch[offsets[(packet.key >> shift) & (RADIX_SIZE - 1)]++] = packet;
+        }
+        m_packets.swap(m_scratch);
+    }
+}
+
+void DrawList::Record(DrawPass pass, const DrawContent &content, const std::function<void(const DrawPacket &)> &draw) {
+    // Packets of one pass are contiguous once sorted
+    const uint64_t first = Field(static_cast<uint32_t>(pass), PASS_BITS, PASS_SHIFT);
+    const uint64_t last  = Field(static_cast<uint32_t>(pass) + 1, PASS_BITS, PASS_SHIFT);
+
+    auto begin = std::lower_bound(m_packets.begin(), m_packets.end(), first, [](const DrawPacket &packet, uint64_t key) {
+        return packet.key < key;
+    });
+
+    DrawStats        &stats = m_stats[static_cast<size_t>(pass)];
+    const VulkanMesh *mesh  = nullptr;
+
+    for (auto packet = begin; packet != m_packets.end() && packet->key < last; ++packet) {
+        const VulkanObject *object = content.batches[packet->batch].object;
+
+        if (object->GetMesh() != mesh) {
+            mesh = object->GetMesh();
+            mesh->Bind();
+            stats.meshBinds++;
+        }
+
+        draw(*packet);
+        stats.draws++;
+    }
+
+    stats.savedBinds = stats.draws - stats.meshBinds;
+}
+
+uint64_t DrawList::MakeKey(DrawPass pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) {
+    return Field(static_cast<uint32_t>(pass), PASS_BITS, PASS_SHIFT) | Field(pipeline, PIPELINE_BITS, PIPELINE_SHIFT) |
+           Field(material, MATERIAL_BITS, MATERIAL_SHIFT) | Field(mesh, MESH_BITS, MESH_SHIFT) | Field(QuantizeDepth(depth), DEPTH_BITS, DEPTH_SHIFT);
+}
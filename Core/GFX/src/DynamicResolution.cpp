@@ -0,0 +1,128 @@
+#include "include/DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <SDL3/SDL_log.h>
+
+#include <Debug.h>
+
+#include <include/RenderSettings.h>
+#include <include/VulkanState.h>
+
+namespace {
+constexpr uint32_t TIMESTAMP_COUNT = 2;
+
+// Aim a bit under the target so noise does not push frames over it
+constexpr float TIME_HEADROOM = 0.9f;
+// Drop resolution quickly on spikes, raise it slowly so the scale does not oscillate
+constexpr float SCALE_DOWN_RATE = 0.5f;
+constexpr float SCALE_UP_RATE   = 0.05f;
+constexpr float TIME_SMOOTHING  = 0.1f;
+} // namespace
+
+DynamicResolution::DynamicResolution(VkExtent2D maxExtent) {
+    m_maxExtent    = maxExtent;
+    m_renderExtent = maxExtent;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(VulkanState::GetInstance().GetPhysicalDevice(), &properties);
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanState::GetInstance().GetPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanState::GetInstance().GetPhysicalDevice(), &familyCount, families.data());
+
+    if (families[VulkanState::GetInstance().GetGraphicsFamily()].timestampValidBits == 0) {
+        SDL_Log("Timestamps unsupported on the graphics queue, dynamic resolution disabled");
+        return;
+    }
+    m_timestampPeriod = properties.limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo infoQueryPool{
+        .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .pNext      = nullptr,
+        .flags      = 0,
+        .queryType  = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = TIMESTAMP_COUNT,
+    };
+    DEBUG_VK_ASSERT(vkCreateQueryPool(VulkanState::GetInstance().GetDevice(), &infoQueryPool, nullptr, &m_queryPool));
+}
+
+DynamicResolution::~DynamicResolution() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(VulkanState::GetInstance().GetDevice(), m_queryPool, nullptr);
+    }
+    m_queryPool = VK_NULL_HANDLE;
+}
+
+void DynamicResolution::SetMaxExtent(VkExtent2D maxExtent) {
+    // The scale carries over, BeginFrame applies it to the new size
+    m_maxExtent    = maxExtent;
+    m_renderExtent = maxExtent;
+}
+
+void DynamicResolution::BeginFrame(const RenderSettings &settings) {
+    if (!IsSupported()) {
+        return;
+    }
+
+    ReadTimestamps();
+    UpdateScale(settings);
+
+    const VkCommandBuffer cmdBuf = VulkanState::GetInstance().GetCommandBuffer();
+    vkCmdResetQueryPool(cmdBuf, m_queryPool, 0, TIMESTAMP_COUNT);
+    vkCmdWriteTimestamp(cmdBuf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, 0);
+}
+
+void DynamicResolution::EndFrame() {
+    if (!IsSupported()) {
+        return;
+    }
+
+    vkCmdWriteTimestamp(VulkanState::GetInstance().GetCommandBuffer(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, 1);
+    m_pending = true;
+}
+
+void DynamicResolution::ReadTimestamps() {
+    if (!m_pending) {
+        return;
+    }
+
+    // The render fence was waited, last frame's queries are written
+    uint64_t       timestamps[TIMESTAMP_COUNT] = {};
+    const VkResult result                      = vkGetQueryPoolResults(
+        VulkanState::GetInstance().GetDevice(),
+        m_queryPool,
+        0,
+        TIMESTAMP_COUNT,
+        sizeof(timestamps),
+        timestamps,
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT
+    );
+    m_pending = false;
+    if (result != VK_SUCCESS) {
+        return;
+    }
+
+    const float time = static_cast<float>(timestamps[1] - timestamps[0]) * m_timestampPeriod * 1e-6f;
+    m_gpuTime        = m_gpuTime == 0.0f ? time : m_gpuTime + (time - m_gpuTime) * TIME_SMOOTHING;
+}
+
+void DynamicResolution::UpdateScale(const RenderSettings &settings) {
+    if (!settings.dynamicResolution) {
+        m_scale = 1.0f;
+    } else if (m_gpuTime > 0.0f) {
+        // GPU time follows the pixel count, which is the square of the scale
+        const float target = m_scale * std::sqrt(settings.targetFrameTime * TIME_HEADROOM / m_gpuTime);
+        const float rate   = target < m_scale ? SCALE_DOWN_RATE : SCALE_UP_RATE;
+        m_scale            = std::clamp(m_scale + (target - m_scale) * rate, settings.minRenderScale, 1.0f);
+    }
+
+    m_renderExtent = {
+        std::max(static_cast<uint32_t>(std::lround(static_cast<float>(m_maxExtent.width) * m_scale)), 1u),
+        std::max(static_cast<uint32_t>(std::lround(static_cast<float>(m_maxExtent.height) * m_scale)), 1u),
+    };
+}
@@ -9,7 +9,17 @@ void ForwardPass::CreateRenderingInfo(const RenderingConfig &config, const DrawC
 }
 
 void ForwardPass::DrawCalls(const DrawContent &content, VkPipelineLayout layout) {
-    for (const auto& prefab : content.frontPrefabs) {
-        prefab.BindAndDraw(layout);
+    if (content.cameraCulling != nullptr) {
+        // Forward draws once after every culling phase has run
+        for (uint32_t phase = 0; phase < CULL_PHASE_COUNT; phase++) {
+            content.drawList->Record(DrawPass::Forward, content, [&content, phase](const DrawPacket &packet) {
+                content.cameraCulling->DrawBatch(packet.batch, phase);
+            });
+        }
+        return;
     }
+
+    content.drawList->Record(DrawPass::Forward, content, [&content](const DrawPacket &packet) {
+        content.batches[packet.batch].object->GetMesh()->Draw(packet.range.count, packet.range.first);
+    });
 }
@@ -3,18 +3,23 @@
 #include <include/Descriptor.h>
 #include <include/PbrRenderer.h>
 #include <include/PipelineManager.h>
+#include <include/SamplerCache.h>
 #include <include/VulkanState.h>
 #include <include/VulkanUtil.h>
 
+namespace {
+const SamplerConfig G_BUFFER_SAMPLER{.maxLod = 1.0f};
+} // namespace
+
 GBufferPass::GBufferPass() {
-    CreateGBufferImages();
+    CreateGBufferImages({VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight(), 1});
     CreateGBufferSet();
 }
 
 GBufferPass::~GBufferPass() {
     if (m_gBufferSet != VK_NULL_HANDLE) {
-        vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_gBufferSet);
-        vkDestroySampler(VulkanState::GetInstance().GetDevice(), m_sampler, nullptr);
+        vk_util::FreeDescriptorSet(m_gBufferSet);
+        SamplerCache::GetInstance().Release(G_BUFFER_SAMPLER);
     }
     m_gBufferSet = VK_NULL_HANDLE;
     m_sampler = VK_NULL_HANDLE;
@@ -28,8 +33,31 @@ void GBufferPass::CreateRenderingInfo(const RenderingConfig &config, const DrawC
 }
 
 void GBufferPass::DrawCalls(const DrawContent &content, VkPipelineLayout layout) {
-    for (const auto &prefab: content.deferredPrefabs) {
-        prefab.BindAndDraw(layout);
+    content.drawList->Record(DrawPass::GBuffer, content, [&content](const DrawPacket &packet) {
+        if (content.cameraCulling != nullptr) {
+            content.cameraCulling->DrawBatch(packet.batch, content.cullingPhase);
+        } else {
+            content.batches[packet.batch].object->GetMesh()->Draw(packet.range.count, packet.range.first);
+        }
+    });
+}
+
+void GBufferPass::Resize(VkExtent2D extent) {
+    // Load ops set for the next phase carry over to the new attachments
+    const VkAttachmentLoadOp loadOp = m_gBufferAttachments.front().loadOp;
+
+    m_gBufferImages.clear();
+    m_gBufferAttachments.clear();
+    CreateGBufferImages({extent.width, extent.height, 1});
+    SetLoadOp(loadOp);
+
+    // The set itself is kept, only its images change
+    UpdateGBufferSet();
+}
+
+void GBufferPass::SetLoadOp(VkAttachmentLoadOp loadOp) {
+    for (auto &attachment: m_gBufferAttachments) {
+        attachment.loadOp = loadOp;
     }
 }
 
@@ -64,34 +92,15 @@ void GBufferPass::PostRender() {
 }
 
 void GBufferPass::CreateGBufferSet() {
-    {
-        VkSamplerCreateInfo infoSampler = {
-            .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-            .pNext                   = nullptr,
-            .flags                   = 0,
-            .magFilter               = VK_FILTER_LINEAR,
-            .minFilter               = VK_FILTER_LINEAR,
-            .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR,
-            .addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-            .addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-            .addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-            .mipLodBias              = 0.0f,
-            .anisotropyEnable        = VK_FALSE,
-            .maxAnisotropy           = 1.0f,
-            .compareEnable           = VK_FALSE,
-            .compareOp               = VK_COMPARE_OP_ALWAYS,
-            .minLod                  = 0.0f,
-            .maxLod                  = 1.0f,
-            .borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
-            .unnormalizedCoordinates = VK_FALSE, // Always normalized
-        };
-
-        vkCreateSampler(VulkanState::GetInstance().GetDevice(), &infoSampler, nullptr, &m_sampler);
-    }
+    m_sampler = SamplerCache::GetInstance().Acquire(G_BUFFER_SAMPLER);
 
     m_gBufferSet =
         vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("lighting_gfx")->GetDescriptorSetLayouts()[descriptor::TEXTURE_SET]);
 
+    UpdateGBufferSet();
+}
+
+void GBufferPass::UpdateGBufferSet() {
     std::vector<VkDescriptorImageInfo> infoImages;
     for (const auto &image: m_gBufferImages) {
         infoImages.emplace_back(m_sampler, image.GetImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
@@ -112,10 +121,9 @@ void GBufferPass::CreateGBufferSet() {
     vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSet, 0, 0);
 }
 
-void GBufferPass::CreateGBufferImages() {
+void GBufferPass::CreateGBufferImages(VkExtent3D extent) {
     constexpr size_t gBufferImageCount = 4;
 
-    VkExtent3D   extent{VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight(), 1};
     VkClearValue colorClear{
         .color = {0.0f, 0.0f, 0.0f, 1.0f}
     };
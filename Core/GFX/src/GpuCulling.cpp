@@ -0,0 +1,225 @@
+#include "include/GpuCulling.h"
+
+#include <Debug.h>
+
+#include <include/Descriptor.h>
+#include <include/HiZPass.h>
+#include <include/PbrRenderer.h>
+#include <include/PipelineManager.h>
+#include <include/VulkanState.h>
+#include <include/VulkanUtil.h>
+
+namespace {
+constexpr uint32_t CULL_GROUP_SIZE = 64;
+
+// Mirrors cull.comp
+struct alignas(16) CullData {
+    glm::mat4                 viewProjection;
+    glm::vec4                 planes[FRUSTUM_PLANE_COUNT];
+    glm::vec2                 pyramidSize;
+    uint32_t                  pyramidLevelCount = 0;
+    uint32_t                  instanceCount     = 0;
+    uint32_t                  batchCount        = 0;
+    uint32_t                  commandCount      = 0;
+    [[maybe_unused]] uint32_t padding0          = 0;
+    [[maybe_unused]] uint32_t padding1          = 0;
+};
+
+struct CullPhase {
+    uint32_t  phase     = 0;
+    uint32_t  occlusion = 0;
+    glm::vec2 uvScale   = glm::vec2(1.0f);
+};
+
+struct GpuDrawBatch {
+    uint32_t                  firstCommand = 0;
+    uint32_t                  vertexCount  = 0;
+    [[maybe_unused]] uint32_t padding0     = 0;
+    [[maybe_unused]] uint32_t padding1     = 0;
+};
+} // namespace
+
+GpuCulling::GpuCulling(const DrawContent &content, const VulkanBuffer &instanceBuffer, const HiZPass &hiZPass) {
+    m_hiZPass = &hiZPass;
+    CreateBuffers(content);
+    CreateDescriptorSet(instanceBuffer);
+}
+
+GpuCulling::~GpuCulling() {
+    if (m_cullSet != VK_NULL_HANDLE) {
+        vk_util::FreeDescriptorSet(m_cullSet);
+    }
+    m_cullSet = VK_NULL_HANDLE;
+}
+
+void GpuCulling::SetView(const Frustum &frustum, const glm::mat4 &viewProjection, uint32_t instanceCount) {
+    m_instanceCount = instanceCount;
+
+    CullData cullData{
+        .viewProjection    = viewProjection,
+        .pyramidSize       = glm::vec2(m_hiZPass->GetExtent().width, m_hiZPass->GetExtent().height),
+        .pyramidLevelCount = m_hiZPass->GetLevelCount(),
+        .instanceCount     = instanceCount,
+        .batchCount        = m_batchCount,
+        .commandCount      = m_commandCount,
+    };
+    for (size_t i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+        cullData.planes[i] = frustum.planes[i];
+    }
+    m_cullBuffer.Upload(sizeof(CullData), &cullData);
+}
+
+void GpuCulling::Cull(uint32_t phase, bool occlusion) {
+    DEBUG_ASSERT(phase < CULL_PHASE_COUNT);
+
+    const VkCommandBuffer cmdBuf = VulkanState::GetInstance().GetCommandBuffer();
+
+    if (phase == 0) {
+        // Last frame's draws have finished reading the counts once the render fence is waited
+        vkCmdFillBuffer(cmdBuf, m_countBuffer.GetBuffer(), 0, VK_WHOLE_SIZE, 0);
+        vk_util::CmdMemoryBarrier(
+            cmdBuf,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+        );
+    }
+
+    // Phase 0 tests against last frame's pyramid, which may have been rendered at another scale
+    CullPhase cullPhase{.phase = phase, .occlusion = occlusion ? 1u : 0u, .uvScale = m_hiZPass->GetUvScale()};
+
+    const VulkanPipeline *pipeline = PipelineManager::GetInstance().Load("cull_comp");
+    vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetPipeline());
+    vkCmdBindDescriptorSets(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetLayout(), descriptor::UNIFORM_SET, 1, &m_cullSet, 0, nullptr);
+    vkCmdPushConstants(cmdBuf, pipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPhase), &cullPhase);
+    vkCmdDispatch(cmdBuf, (m_instanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    vk_util::CmdMemoryBarrier(
+        cmdBuf,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT
+    );
+}
+
+void GpuCulling::DrawBatch(uint32_t batch, uint32_t phase) const {
+    vkCmdDrawIndirectCount(
+        VulkanState::GetInstance().GetCommandBuffer(),
+        m_commandBuffer.GetBuffer(),
+        (phase * m_commandCount + m_firstCommands[batch]) * sizeof(VkDrawIndirectCommand),
+        m_countBuffer.GetBuffer(),
+        (phase * m_batchCount + batch) * sizeof(uint32_t),
+        m_maxDrawCounts[batch],
+        sizeof(VkDrawIndirectCommand)
+    );
+}
+
+void GpuCulling::CreateBuffers(const DrawContent &content) {
+    m_batchCount = static_cast<uint32_t>(content.batches.size());
+
+    std::vector<GpuDrawBatch> gpuBatches;
+    m_commandCount = 0;
+    for (const auto &batch: content.batches) {
+        gpuBatches.push_back({.firstCommand = batch.firstCommand, .vertexCount = batch.object->GetMesh()->GetVertexCount()});
+        m_firstCommands.push_back(batch.firstCommand);
+        m_maxDrawCounts.push_back(batch.instanceCount);
+        m_commandCount += batch.instanceCount;
+    }
+
+    VulkanBuffer cullBuffer(sizeof(CullData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    m_cullBuffer = std::move(cullBuffer);
+
+    VulkanBuffer batchBuffer(sizeof(GpuDrawBatch) * gpuBatches.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    batchBuffer.Upload(sizeof(GpuDrawBatch) * gpuBatches.size(), gpuBatches.data());
+    m_batchBuffer = std::move(batchBuffer);
+
+    // Commands and counts hold one range per phase
+    VulkanBuffer commandBuffer(
+        sizeof(VkDrawIndirectCommand) * m_commandCount * CULL_PHASE_COUNT,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+    );
+    m_commandBuffer = std::move(commandBuffer);
+
+    VulkanBuffer countBuffer(
+        sizeof(uint32_t) * m_batchCount * CULL_PHASE_COUNT,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+    );
+    m_countBuffer = std::move(countBuffer);
+
+    VulkanBuffer occludedBuffer(sizeof(uint32_t) * content.scene.GetCount(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_occludedBuffer = std::move(occludedBuffer);
+}
+
+void GpuCulling::CreateDescriptorSet(const VulkanBuffer &instanceBuffer) {
+    m_cullSet =
+        vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("cull_comp")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
+
+    VkDescriptorBufferInfo infoCull{.buffer = m_cullBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE};
+
+    std::vector<VkDescriptorBufferInfo> infoStorages{
+        {.buffer = instanceBuffer.GetBuffer(),   .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = m_batchBuffer.GetBuffer(),    .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = m_commandBuffer.GetBuffer(),  .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = m_countBuffer.GetBuffer(),    .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = m_occludedBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE},
+    };
+
+    std::vector<VkWriteDescriptorSet> writeSets{
+        {
+         .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .pNext            = nullptr,
+         .dstSet           = m_cullSet,
+         .dstBinding       = 0,
+         .dstArrayElement  = 0,
+         .descriptorCount  = 1,
+         .descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+         .pImageInfo       = nullptr,
+         .pBufferInfo      = &infoCull,
+         .pTexelBufferView = nullptr,
+         },
+    };
+
+    // Storage buffers are bound at 2 to 6
+    for (uint32_t i = 0; i < infoStorages.size(); i++) {
+        writeSets.push_back({
+            .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext            = nullptr,
+            .dstSet           = m_cullSet,
+            .dstBinding       = 2 + i,
+            .dstArrayElement  = 0,
+            .descriptorCount  = 1,
+            .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pImageInfo       = nullptr,
+            .pBufferInfo      = &infoStorages[i],
+            .pTexelBufferView = nullptr,
+        });
+    }
+
+    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+
+    UpdatePyramid();
+}
+
+void GpuCulling::UpdatePyramid() {
+    VkDescriptorImageInfo infoPyramid{
+        .sampler     = m_hiZPass->GetSampler(),
+        .imageView   = m_hiZPass->GetPyramidView(),
+        .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+    };
+
+    VkWriteDescriptorSet writeSet{
+        .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext            = nullptr,
+        .dstSet           = m_cullSet,
+        .dstBinding       = 7,
+        .dstArrayElement  = 0,
+        .descriptorCount  = 1,
+        .descriptorType   = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .pImageInfo       = &infoPyramid,
+        .pBufferInfo      = nullptr,
+        .pTexelBufferView = nullptr,
+    };
+    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSet, 0, nullptr);
+}
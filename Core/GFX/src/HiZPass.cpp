@@ -0,0 +1,224 @@
+#include "include/HiZPass.h"
+
+#include <algorithm>
+#include <bit>
+
+#include <glm/glm.hpp>
+
+#include <Debug.h>
+
+#include <include/Descriptor.h>
+#include <include/PipelineManager.h>
+#include <include/SamplerCache.h>
+#include <include/VulkanState.h>
+#include <include/VulkanUtil.h>
+
+namespace {
+constexpr uint32_t HIZ_GROUP_SIZE = 8;
+
+// Reads exact texels of any level
+const SamplerConfig PYRAMID_SAMPLER{
+    .filter      = VK_FILTER_NEAREST,
+    .mipmapMode  = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+    .addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+};
+
+// Mirrors hiz.comp
+struct HiZLevel {
+    glm::ivec2 sourceSize;
+    glm::ivec2 destinationSize;
+    uint32_t   firstLevel = 0;
+};
+
+VkExtent2D GetLevelExtent(VkExtent2D extent, uint32_t level) {
+    return {std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u)};
+}
+} // namespace
+
+HiZPass::HiZPass(const VulkanImage &depthImage) {
+    m_sampler = SamplerCache::GetInstance().Acquire(PYRAMID_SAMPLER);
+    Resize(depthImage);
+}
+
+HiZPass::~HiZPass() {
+    DestroyPyramid();
+    if (m_sampler != VK_NULL_HANDLE) {
+        SamplerCache::GetInstance().Release(PYRAMID_SAMPLER);
+    }
+    m_sampler = VK_NULL_HANDLE;
+}
+
+void HiZPass::Resize(const VulkanImage &depthImage) {
+    DestroyPyramid();
+
+    m_extent     = {depthImage.GetExtent().width, depthImage.GetExtent().height};
+    m_levelCount = std::bit_width(std::max(m_extent.width, m_extent.height));
+    m_built      = false;
+
+    CreatePyramid();
+    CreateLevelSets(depthImage);
+}
+
+void HiZPass::Build(VkExtent2D renderExtent) {
+    const VkCommandBuffer cmdBuf = VulkanState::GetInstance().GetCommandBuffer();
+
+    m_uvScale = glm::vec2(renderExtent.width, renderExtent.height) / glm::vec2(m_extent.width, m_extent.height);
+
+    if (!m_built) {
+        vk_util::CmdImageLayoutTransition(
+            cmdBuf,
+            m_pyramid.GetImage(),
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            0,
+            m_levelCount
+        );
+    }
+
+    // Culling of the previous phase may still be sampling the pyramid
+    vk_util::CmdMemoryBarrier(
+        cmdBuf,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    );
+
+    const VulkanPipeline *pipeline = PipelineManager::GetInstance().Load("hiz_comp");
+    vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->GetPipeline());
+
+    for (uint32_t i = 0; i < m_levelCount; i++) {
+        const VkExtent2D source      = i == 0 ? renderExtent : GetLevelExtent(m_extent, i - 1);
+        const VkExtent2D destination = GetLevelExtent(m_extent, i);
+
+        HiZLevel level{
+            .sourceSize      = glm::ivec2(source.width, source.height),
+            .destinationSize = glm::ivec2(destination.width, destination.height),
+            .firstLevel      = i == 0 ? 1u : 0u,
+        };
+
+        vkCmdBindDescriptorSets(
+            cmdBuf,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            pipeline->GetLayout(),
+            descriptor::UNIFORM_SET,
+            1,
+            &m_levelSets[i],
+            0,
+            nullptr
+        );
+        vkCmdPushConstants(cmdBuf, pipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(HiZLevel), &level);
+        vkCmdDispatch(
+            cmdBuf,
+            (destination.width + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE,
+            (destination.height + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE,
+            1
+        );
+
+        // The next level reads this one
+        vk_util::CmdMemoryBarrier(
+            cmdBuf,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT
+        );
+    }
+
+    m_built = true;
+}
+
+void HiZPass::DestroyPyramid() {
+    for (const auto set: m_levelSets) {
+        vk_util::FreeDescriptorSet(set);
+    }
+    for (const auto view: m_levelViews) {
+        VulkanState::GetInstance().GetReleaseQueue().Release(VK_OBJECT_TYPE_IMAGE_VIEW, view);
+    }
+
+    m_levelSets.clear();
+    m_levelViews.clear();
+    m_pyramid = {};
+}
+
+void HiZPass::CreatePyramid() {
+    VulkanImage pyramid(
+        VK_FORMAT_R32G32_SFLOAT,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        {m_extent.width, m_extent.height, 1},
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_SAMPLE_COUNT_1_BIT,
+        m_levelCount
+    );
+    m_pyramid = std::move(pyramid);
+
+    // Storage writes need one view per level
+    for (uint32_t i = 0; i < m_levelCount; i++) {
+        VkImageViewCreateInfo infoView{
+            .sType      = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext      = nullptr,
+            .flags      = 0,
+            .image      = m_pyramid.GetImage(),
+            .viewType   = VK_IMAGE_VIEW_TYPE_2D,
+            .format     = VK_FORMAT_R32G32_SFLOAT,
+            .components = {VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY},
+            .subresourceRange = vk_util::GetSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1)
+        };
+
+        VkImageView view = VK_NULL_HANDLE;
+        DEBUG_VK_ASSERT(vkCreateImageView(VulkanState::GetInstance().GetDevice(), &infoView, nullptr, &view));
+        m_levelViews.push_back(view);
+    }
+}
+
+void HiZPass::CreateLevelSets(const VulkanImage &depthImage) {
+    const VkDescriptorSetLayout layout = PipelineManager::GetInstance().Load("hiz_comp")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET];
+
+    for (uint32_t i = 0; i < m_levelCount; i++) {
+        m_levelSets.push_back(vk_util::CreateDescriptorSet(layout));
+
+        // The first level reduces depth, every other level the one above it
+        VkDescriptorImageInfo infoSource{
+            .sampler     = m_sampler,
+            .imageView   = i == 0 ? depthImage.GetImageView() : m_levelViews[i - 1],
+            .imageLayout = i == 0 ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL,
+        };
+        VkDescriptorImageInfo infoDestination{
+            .sampler     = VK_NULL_HANDLE,
+            .imageView   = m_levelViews[i],
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        };
+
+        std::vector<VkWriteDescriptorSet> writeSets{
+            {
+             .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+             .pNext            = nullptr,
+             .dstSet           = m_levelSets[i],
+             .dstBinding       = 0,
+             .dstArrayElement  = 0,
+             .descriptorCount  = 1,
+             .descriptorType   = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+             .pImageInfo       = &infoSource,
+             .pBufferInfo      = nullptr,
+             .pTexelBufferView = nullptr,
+             },
+            {
+             .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+             .pNext            = nullptr,
+             .dstSet           = m_levelSets[i],
+             .dstBinding       = 1,
+             .dstArrayElement  = 0,
+             .descriptorCount  = 1,
+             .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+             .pImageInfo       = &infoDestination,
+             .pBufferInfo      = nullptr,
+             .pTexelBufferView = nullptr,
+             },
+        };
+
+        vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+    }
+}
@@ -0,0 +1,32 @@
+#include "include/Instancing.h"
+
+#include <Debug.h>
+
+void instancing::BuildRanges(
+    const std::vector<uint32_t> &visible,
+    const std::vector<uint32_t> &instanceBatches,
+    uint32_t                     offset,
+    std::vector<uint32_t>       &indices,
+    std::vector<InstanceRange>  &ranges
+) {
+    DEBUG_ASSERT(offset + visible.size() <= indices.size());
+
+    for (auto &range: ranges) {
+        range = {};
+    }
+    for (const uint32_t index: visible) {
+        ranges[instanceBatches[index]].count++;
+    }
+
+    // Counting sort, the counts are rebuilt while placing the indices
+    uint32_t first = offset;
+    for (auto &range: ranges) {
+        range.first  = first;
+        first       += range.count;
+        range.count  = 0;
+    }
+    for (const uint32_t index: visible) {
+        InstanceRange &range = ranges[instanceBatches[index]];
+        indices[range.first + range.count++] = index;
+    }
+}
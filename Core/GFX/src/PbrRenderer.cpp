@@ -1,25 +1,37 @@
 #include "include/PbrRenderer.h"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+
+#include <SDL3/SDL_log.h>
+
+#include <include/BindlessTable.h>
 #include <include/Camera.h>
+#include <include/CpuProfiler.h>
 #include <include/Descriptor.h>
+#include <include/Frustum.h>
+#include <include/GpuProfiler.h>
 #include <include/LightManager.h>
 #include <include/MeshManager.h>
 #include <include/PipelineManager.h>
 #include <include/TextureManager.h>
+#include <include/VulkanMaterial.h>
+#include <include/VulkanObject.h>
 #include <include/VulkanState.h>
 #include <include/VulkanUtil.h>
 
-PbrRenderer::PbrRenderer(UIRenderer &uiRenderer)
+PbrRenderer::PbrRenderer(UIRenderer &uiRenderer, const SceneDescription &scene)
     : m_skybox("../Assets/Skybox/Skybox.png", PipelineManager::GetInstance().Load("skybox_gfx")->GetDescriptorSetLayouts()[descriptor::TEXTURE_SET]) {
     m_brdf       = TextureManager::GetInstance().Load("../Assets/Skybox/brdf_lut.png");
     m_irradiance = TextureManager::GetInstance().Load("../Assets/Skybox/irradiance.png");
     m_specular   = TextureManager::GetInstance().Load("../Assets/Skybox/specular.png");
 
     CreateImages();
+    CreateDrawContent(scene);
     CreateBuffers();
-    CreateDrawContent();
     CreateDescriptorSets();
-    CreateRenderConfig();
 
     size_t i = 0;
     for (i; i < m_drawContent.deferredPrefabs.size(); i++) {
@@ -30,10 +42,17 @@ PbrRenderer::PbrRenderer(UIRenderer &uiRenderer)
         uiRenderer.AddPrefabWindow(m_drawContent.frontPrefabs[j], i + j);
     }
 
+    uiRenderer.AddRenderSettingsWindow(m_settings, *m_dynamicResolution);
+    uiRenderer.AddDrawStatsWindow(m_drawList);
+
     OneTimeUpdateDescriptorSets();
+
+    m_postProcessingPass = std::make_unique<PostProcessingPass>(m_drawImage, uiRenderer.GetOverlay());
 }
 
 PbrRenderer::~PbrRenderer() {
+    m_postProcessingPass.reset();
+
     m_drawImage  = {};
     m_depthImage = {};
 
@@ -45,26 +64,54 @@ PbrRenderer::~PbrRenderer() {
     m_irradiance = nullptr;
     m_specular   = nullptr;
 
-    m_cameraBuffer = {};
-    m_lightBuffer  = {};
-
-    vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_uniformSet);
-    vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_cameraSet);
-    vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_iblSet);
-    vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_uniformShadowSet);
-    vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_uniformForwardSet);
-    vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_postProcessSet);
-
-    vkDestroySampler(VulkanState::GetInstance().GetDevice(), m_sampler, nullptr);
+    m_cameraCulling.reset();
+    m_shadowCulling.reset();
+    m_hiZPass.reset();
+    m_clusteredLighting.reset();
+    m_dynamicResolution.reset();
+
+    m_cameraBuffer        = {};
+    m_lightBuffer         = {};
+    m_instanceBuffer      = {};
+    m_instanceIndexBuffer = {};
+
+    vk_util::FreeDescriptorSet(m_uniformSet);
+    vk_util::FreeDescriptorSet(m_cameraSet);
+    vk_util::FreeDescriptorSet(m_uniformGBufferSet);
+    vk_util::FreeDescriptorSet(m_iblSet);
+    vk_util::FreeDescriptorSet(m_uniformShadowSet);
+    vk_util::FreeDescriptorSet(m_uniformPointShadowSet);
+    vk_util::FreeDescriptorSet(m_uniformForwardSet);
 }
 
 void PbrRenderer::Render() {
+    PROFILE_ZONE("PbrRenderer::Render");
+    m_dynamicResolution->BeginFrame(m_settings);
+    UpdateRenderConfig(m_dynamicResolution->GetRenderExtent());
+
     CameraData cameraData = Camera::GetInstance().Update();
     m_cameraBuffer.Upload(sizeof(CameraData), &cameraData);
 
     LightsData lightsData = LightManager::GetInstance().Update();
     m_lightBuffer.Upload(sizeof(LightsData), &lightsData);
 
+    UpdateScene();
+    m_shadowUpdate = m_shadowPass.Update(lightsData, m_castersMoved, m_staticChanged, m_settings.shadowCaching && !m_settings.gpuCulling);
+    m_pointShadowPass.Update(cameraData, m_castersMoved);
+    CullScene(cameraData.projection * cameraData.view, LightManager::GetInstance().GetShadowCullMatrix());
+    BuildDrawList(cameraData.view);
+
+    m_clusteredLighting->Update(
+        cameraData.projection,
+        Camera::GetInstance().GetNear(),
+        Camera::GetInstance().GetFar(),
+        m_dynamicResolution->GetRenderExtent()
+    );
+    {
+        GpuZone zone(VulkanState::GetInstance().GetCommandBuffer(), "Clusters");
+        m_clusteredLighting->Build();
+    }
+
     // Layout transition
     vk_util::CmdImageLayoutTransition(
         VulkanState::GetInstance().GetCommandBuffer(),
@@ -75,6 +122,14 @@ void PbrRenderer::Render() {
         0,
         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
     );
+
+    m_drawContent.depthAttachments.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+
+    RenderShadows();
+
+    RenderGBuffer();
+
+    // The draw image is first touched here so everything above overlaps last frame's async post chain reading it
     vk_util::CmdImageLayoutTransition(
         VulkanState::GetInstance().GetCommandBuffer(),
         m_drawImage.GetImage(),
@@ -84,40 +139,6 @@ void PbrRenderer::Render() {
         0,
         VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
     );
-    vk_util::CmdImageLayoutTransition(
-        VulkanState::GetInstance().GetCommandBuffer(),
-        m_postProcessedImage.GetImage(),
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        VK_IMAGE_ASPECT_COLOR_BIT,
-        0,
-        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
-    );
-
-    m_drawContent.depthAttachments.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    m_drawContent.drawAttachments.loadOp  = VK_ATTACHMENT_LOAD_OP_CLEAR;
-
-    m_shadowPass.PreRender();
-    m_shadowPass.Render(
-        m_config,
-        {
-            {m_uniformShadowSet, descriptor::UNIFORM_SET}
-    },
-        m_drawContent,
-        dynamic_cast<VulkanGraphicsPipeline *>(PipelineManager::GetInstance().Load("shadow_gfx"))
-    );
-    m_shadowPass.PostRender();
-
-    m_gBufferPass.PreRender();
-    m_gBufferPass.Render(
-        m_config,
-        {
-            {m_cameraSet, descriptor::UNIFORM_SET}
-    },
-        m_drawContent,
-        dynamic_cast<VulkanGraphicsPipeline *>(PipelineManager::GetInstance().Load("gbuffer_gfx"))
-    );
-    m_gBufferPass.PostRender();
 
     m_drawContent.drawAttachments.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
     m_lightingPass.Render(
@@ -136,9 +157,10 @@ void PbrRenderer::Render() {
     m_forwardPass.Render(
         m_config,
         {
-            {m_uniformForwardSet,      descriptor::UNIFORM_SET},
-            {m_iblSet,                 descriptor::IBL_SET    },
-            {m_shadowPass.GetCSMSet(), descriptor::SHADOW_SET }
+            {m_uniformForwardSet,                            descriptor::UNIFORM_SET},
+            {BindlessTable::GetInstance().GetDescriptorSet(), descriptor::TEXTURE_SET},
+            {m_iblSet,                                       descriptor::IBL_SET    },
+            {m_shadowPass.GetCSMSet(),                       descriptor::SHADOW_SET }
     },
         m_drawContent,
         dynamic_cast<VulkanGraphicsPipeline *>(PipelineManager::GetInstance().Load("forward_gfx"))
@@ -163,35 +185,163 @@ void PbrRenderer::Render() {
         VK_ACCESS_SHADER_READ_BIT
     );
 
-    m_postProcessingPass.Render(
+    m_dynamicResolution->EndFrame();
+}
+
+void PbrRenderer::PostProcess() {
+    PROFILE_ZONE("PbrRenderer::PostProcess");
+    const bool            async  = m_settings.asyncCompute && VulkanState::GetInstance().HasAsyncCompute();
+    const VkCommandBuffer cmdBuf = async ? VulkanState::GetInstance().BeginAsyncCompute() : VulkanState::GetInstance().GetCommandBuffer();
+    m_postProcessingPass->Render(cmdBuf, m_settings, m_dynamicResolution->GetRenderExtent());
+}
+
+void PbrRenderer::RenderShadows() {
+    PROFILE_ZONE("PbrRenderer::RenderShadows");
+    if (m_shadowUpdate != ShadowUpdate::Skip) {
+        auto *pipeline = dynamic_cast<VulkanGraphicsPipeline *>(PipelineManager::GetInstance().Load("shadow_gfx"));
+
+        if (m_shadowUpdate == ShadowUpdate::Full) {
+            m_shadowPass.PreRenderStatic();
+            m_shadowPass.Render(
+                m_config,
+                {
+                    {m_uniformShadowSet, descriptor::UNIFORM_SET}
+            },
+                m_drawContent,
+                pipeline
+            );
+            m_shadowPass.PostRenderStatic();
+        }
+
+        m_shadowPass.PreRender(m_shadowUpdate);
+        m_shadowPass.Render(
+            m_config,
+            {
+                {m_uniformShadowSet, descriptor::UNIFORM_SET}
+        },
+            m_drawContent,
+            pipeline
+        );
+        m_shadowPass.PostRender();
+    }
+
+    // Point shadows keep their tiles until the update budget reaches them
+    if (m_pointShadowPass.HasWork()) {
+        m_pointShadowPass.PreRender();
+        m_pointShadowPass.Render(
+            m_config,
+            {
+                {m_uniformPointShadowSet, descriptor::UNIFORM_SET}
+        },
+            m_drawContent,
+            dynamic_cast<VulkanGraphicsPipeline *>(PipelineManager::GetInstance().Load("point_shadow_gfx"))
+        );
+        m_pointShadowPass.PostRender();
+    }
+}
+
+void PbrRenderer::RenderGBuffer() {
+    PROFILE_ZONE("PbrRenderer::RenderGBuffer");
+    auto *pipeline = dynamic_cast<VulkanGraphicsPipeline *>(PipelineManager::GetInstance().Load("gbuffer_gfx"));
+
+    m_drawContent.cullingPhase = 0;
+    m_gBufferPass.PreRender();
+    m_gBufferPass.Render(
         m_config,
         {
-            {m_uniformSet,     descriptor::UNIFORM_SET},
-            {m_postProcessSet, descriptor::TEXTURE_SET}
+            {m_uniformGBufferSet,                            descriptor::UNIFORM_SET},
+            {BindlessTable::GetInstance().GetDescriptorSet(), descriptor::TEXTURE_SET}
     },
         m_drawContent,
-        dynamic_cast<VulkanGraphicsPipeline *>(PipelineManager::GetInstance().Load("post_processing_gfx"))
+        pipeline
     );
 
-    vk_util::CmdImageLayoutTransition(
-        VulkanState::GetInstance().GetCommandBuffer(),
-        m_postProcessedImage.GetImage(),
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        VK_IMAGE_ASPECT_COLOR_BIT,
-        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-        VK_ACCESS_TRANSFER_READ_BIT
-    );
+    if (m_drawContent.cameraCulling != nullptr && m_settings.occlusionCulling) {
+        // Build the pyramid from what the first phase drew, then draw the rejected instances that turn out visible
+        vk_util::CmdImageLayoutTransition(
+            VulkanState::GetInstance().GetCommandBuffer(),
+            m_depthImage.GetImage(),
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_IMAGE_ASPECT_DEPTH_BIT,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT
+        );
+        {
+            GpuZone zone(VulkanState::GetInstance().GetCommandBuffer(), "Hi-Z");
+            m_hiZPass->Build(m_dynamicResolution->GetRenderExtent());
+        }
+        vk_util::CmdImageLayoutTransition(
+            VulkanState::GetInstance().GetCommandBuffer(),
+            m_depthImage.GetImage(),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_ASPECT_DEPTH_BIT,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+        );
+        {
+            GpuZone zone(VulkanState::GetInstance().GetCommandBuffer(), "Culling");
+            m_cameraCulling->Cull(1, true);
+        }
+
+        m_drawContent.cullingPhase            = 1;
+        m_drawContent.depthAttachments.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        m_gBufferPass.SetLoadOp(VK_ATTACHMENT_LOAD_OP_LOAD);
+        m_gBufferPass.Render(
+            m_config,
+            {
+                {m_uniformGBufferSet,                            descriptor::UNIFORM_SET},
+                {BindlessTable::GetInstance().GetDescriptorSet(), descriptor::TEXTURE_SET}
+        },
+            m_drawContent,
+            pipeline
+        );
+        m_gBufferPass.SetLoadOp(VK_ATTACHMENT_LOAD_OP_CLEAR);
+    }
+
+    m_gBufferPass.PostRender();
+}
 
+void PbrRenderer::Resize(const VulkanImage &uiOverlay) {
+    PROFILE_ZONE("PbrRenderer::Resize");
+    const VkExtent2D extent{VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight()};
+    m_dynamicResolution->SetMaxExtent(extent);
+
+    // Passes draw into the top left of larger targets anyway, so they are kept until the window outgrows them
+    const VkExtent2D current{m_drawImage.GetExtent().width, m_drawImage.GetExtent().height};
+    const VkExtent2D target = vk_util::GetTargetExtent(current, extent);
+    if (target.width != current.width || target.height != current.height) {
+        SDL_Log("Render targets reallocated at %ux%u for a %ux%u window", target.width, target.height, extent.width, extent.height);
+
+        CreateTargets(target);
+        m_drawContent.drawAttachments.imageView  = m_drawImage.GetImageView();
+        m_drawContent.depthAttachments.imageView = m_depthImage.GetImageView();
+
+        m_gBufferPass.Resize(target);
+        m_hiZPass->Resize(m_depthImage);
+        m_cameraCulling->UpdatePyramid();
+        m_shadowCulling->UpdatePyramid();
+    }
 
-    VulkanState::GetInstance().CopyToPresentImage(m_postProcessedImage);
+    m_postProcessingPass->Resize(m_drawImage, uiOverlay);
 }
 
 void PbrRenderer::CreateImages() {
+    const VkExtent2D extent{VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight()};
+    CreateTargets(extent);
+
+    m_hiZPass = std::make_unique<HiZPass>(m_depthImage);
+
+    // Targets are allocated at least at the window size, the largest extent dynamic resolution renders at
+    m_dynamicResolution = std::make_unique<DynamicResolution>(extent);
+}
+
+void PbrRenderer::CreateTargets(VkExtent2D extent) {
     VulkanImage drawImg(
         VK_FORMAT_R16G16B16A16_SFLOAT,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        {VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight(), 1},
+        {extent.width, extent.height, 1},
         VK_IMAGE_ASPECT_COLOR_BIT
     );
 
@@ -199,44 +349,11 @@ void PbrRenderer::CreateImages() {
 
     VulkanImage depthImg(
         VK_FORMAT_D32_SFLOAT,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        {VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight(), 1},
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        {extent.width, extent.height, 1},
         VK_IMAGE_ASPECT_DEPTH_BIT
     );
     m_depthImage = std::move(depthImg);
-
-    VulkanImage postProcessedImage(
-        VK_FORMAT_R16G16B16A16_SFLOAT,
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-        {VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight(), 1},
-        VK_IMAGE_ASPECT_COLOR_BIT
-    );
-    m_postProcessedImage = std::move(postProcessedImage);
-
-    {
-        VkSamplerCreateInfo infoSampler = {
-            .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-            .pNext                   = nullptr,
-            .flags                   = 0,
-            .magFilter               = VK_FILTER_LINEAR,
-            .minFilter               = VK_FILTER_LINEAR,
-            .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST,
-            .addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-            .addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-            .addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-            .mipLodBias              = 0.0f,
-            .anisotropyEnable        = VK_FALSE,
-            .maxAnisotropy           = 1.0f,
-            .compareEnable           = VK_FALSE,
-            .compareOp               = VK_COMPARE_OP_ALWAYS,
-            .minLod                  = 0.0f,
-            .maxLod                  = 1.0f,
-            .borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
-            .unnormalizedCoordinates = VK_FALSE, // Always normalized
-        };
-
-        vkCreateSampler(VulkanState::GetInstance().GetDevice(), &infoSampler, nullptr, &m_sampler);
-    }
 }
 
 void PbrRenderer::CreateBuffers() {
@@ -245,14 +362,45 @@ void PbrRenderer::CreateBuffers() {
 
     VulkanBuffer lightBuffer(sizeof(LightsData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
     m_lightBuffer = std::move(lightBuffer);
+
+    m_instances.resize(m_drawContent.scene.GetCount());
+    VulkanBuffer instanceBuffer(sizeof(InstanceData) * m_instances.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_instanceBuffer = std::move(instanceBuffer);
+
+    // Identity indices for GPU culling, then the camera and shadow regions of CPU culling and the point shadow region
+    const auto count = static_cast<uint32_t>(m_instances.size());
+    m_instanceIndices.resize(count * 4);
+    std::iota(m_instanceIndices.begin(), m_instanceIndices.begin() + count, 0u);
+
+    // Point shadows draw every instance, their ranges never change
+    const std::vector<uint32_t> allInstances(m_instanceIndices.begin(), m_instanceIndices.begin() + count);
+    instancing::BuildRanges(allInstances, m_drawContent.instanceBatches, count * 3, m_instanceIndices, m_drawContent.pointShadowRanges);
+
+    VulkanBuffer instanceIndexBuffer(sizeof(uint32_t) * m_instanceIndices.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    instanceIndexBuffer.Upload(sizeof(uint32_t) * m_instanceIndices.size(), m_instanceIndices.data());
+    m_instanceIndexBuffer = std::move(instanceIndexBuffer);
+
+    m_cameraCulling = std::make_unique<GpuCulling>(m_drawContent, m_instanceBuffer, *m_hiZPass);
+    m_shadowCulling = std::make_unique<GpuCulling>(m_drawContent, m_instanceBuffer, *m_hiZPass);
+
+    m_clusteredLighting = std::make_unique<ClusteredLighting>(m_cameraBuffer, m_lightBuffer);
 }
 
-void PbrRenderer::CreateDrawContent() {
-    m_drawContent.deferredPrefabs.emplace_back("../Assets/Models/BoomBox/BoomBox.json", glm::vec3(0.0f, 0.1f, 0.0f));
-    m_drawContent.deferredPrefabs.emplace_back("../Assets/Models/Chessboard/Chessboard.json");
-    m_drawContent.deferredPrefabs.emplace_back("../Assets/Models/Castle/Castle.json");
+void PbrRenderer::CreateDrawContent(const SceneDescription &scene) {
+    for (const ScenePrefab &prefab: scene.prefabs) {
+        auto &prefabs = prefab.front ? m_drawContent.frontPrefabs : m_drawContent.deferredPrefabs;
+        prefabs.emplace_back(prefab.object, prefab.location);
+    }
+
+    for (const auto &prefab: m_drawContent.deferredPrefabs) {
+        m_drawContent.scene.Add(prefab.GetTransformation(), prefab.GetBounds());
+    }
+    for (const auto &prefab: m_drawContent.frontPrefabs) {
+        m_drawContent.scene.Add(prefab.GetTransformation(), prefab.GetBounds());
+    }
+    CreateBatches();
 
-    m_drawContent.frontPrefabs.emplace_back("../Assets/Models/Castle/Castle.json", glm::vec3(0.35f, 0.0f, 0.0f));
+    m_drawContent.drawList = &m_drawList;
 
     m_drawContent.screen = MeshManager::GetInstance().Load("screen");
 
@@ -283,16 +431,213 @@ void PbrRenderer::CreateDrawContent() {
         VK_NULL_HANDLE,
         VK_IMAGE_LAYOUT_UNDEFINED
     );
-    m_drawContent.postProcessdAttachments = vk_util::GetRenderingAttachmentInfo(
-        m_postProcessedImage.GetImageView(),
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        &colorClear,
-        VK_ATTACHMENT_LOAD_OP_CLEAR,
-        VK_ATTACHMENT_STORE_OP_STORE,
-        VK_RESOLVE_MODE_NONE,
-        VK_NULL_HANDLE,
-        VK_IMAGE_LAYOUT_UNDEFINED
+}
+
+void PbrRenderer::CreateBatches() {
+    const auto deferredCount = static_cast<uint32_t>(m_drawContent.deferredPrefabs.size());
+    const auto frontCount    = static_cast<uint32_t>(m_drawContent.frontPrefabs.size());
+
+    m_drawContent.batches.clear();
+    m_drawContent.instanceBatches.resize(m_drawContent.scene.GetCount());
+
+    // Group instances by mesh and material, a batch never mixes deferred and front prefabs
+    auto group = [this](uint32_t first, uint32_t count) {
+        std::map<std::pair<const VulkanMesh *, const VulkanMaterial *>, uint32_t> batchIndices;
+        for (uint32_t i = first; i < first + count; i++) {
+            const VulkanObject *object = m_drawContent.GetPrefab(i).GetObject();
+
+            auto pair = batchIndices.find({object->GetMesh(), object->GetMaterial()});
+            if (pair == batchIndices.end()) {
+                pair = batchIndices.emplace(std::make_pair(object->GetMesh(), object->GetMaterial()), m_drawContent.batches.size()).first;
+                m_drawContent.batches.push_back({.object = object});
+            }
+
+            m_drawContent.instanceBatches[i] = pair->second;
+            m_drawContent.batches[pair->second].instanceCount++;
+        }
+    };
+
+    group(0, deferredCount);
+    m_drawContent.deferredBatchCount = static_cast<uint32_t>(m_drawContent.batches.size());
+    group(deferredCount, frontCount);
+
+    // Every batch owns a command range large enough to hold all of its instances
+    uint32_t firstCommand = 0;
+    for (auto &batch: m_drawContent.batches) {
+        batch.firstCommand  = firstCommand;
+        firstCommand       += batch.instanceCount;
+    }
+
+    m_drawContent.cameraRanges.resize(m_drawContent.batches.size());
+    m_drawContent.shadowRanges.resize(m_drawContent.batches.size());
+    m_drawContent.staticShadowRanges.resize(m_drawContent.batches.size());
+    m_drawContent.pointShadowRanges.resize(m_drawContent.batches.size());
+}
+
+void PbrRenderer::UpdateScene() {
+    PROFILE_ZONE("PbrRenderer::UpdateScene");
+    SceneStore &scene = m_drawContent.scene;
+
+    m_castersMoved  = false;
+    m_staticChanged = false;
+
+    // Prefabs are edited through the UI, pull their transforms into the scene store
+    for (uint32_t i = 0; i < scene.GetCount(); i++) {
+        const bool wasDynamic = scene.IsDynamic(i);
+        if (scene.SetWorldMatrix(i, m_drawContent.GetPrefab(i).GetTransformation())) {
+            m_castersMoved   = true;
+            m_staticChanged |= !wasDynamic;
+        }
+
+        const uint32_t batch = m_drawContent.instanceBatches[i];
+
+        m_instances[i] = {
+            .model    = scene.GetWorldMatrix(i),
+            .sphere   = glm::vec4(scene.GetCentersX()[i], scene.GetCentersY()[i], scene.GetCentersZ()[i], scene.GetRadii()[i]),
+            .batch    = batch,
+            .material = m_drawContent.batches[batch].object->GetMaterial()->GetIndex(),
+        };
+    }
+
+    m_instanceBuffer.Upload(sizeof(InstanceData) * m_instances.size(), m_instances.data());
+}
+
+void PbrRenderer::CullScene(const glm::mat4 &viewProjection, const glm::mat4 &lightSpaceMatrix) {
+    PROFILE_ZONE("PbrRenderer::CullScene");
+    const auto deferredCount = static_cast<uint32_t>(m_drawContent.deferredPrefabs.size());
+    const auto frontCount    = static_cast<uint32_t>(m_drawContent.frontPrefabs.size());
+
+    const Frustum cameraFrustum = Frustum::FromMatrix(viewProjection);
+    const Frustum lightFrustum  = Frustum::FromMatrix(lightSpaceMatrix);
+
+    if (m_settings.gpuCulling) {
+        // Only the camera has a depth pyramid, shadows are frustum culled
+        GpuZone zone(VulkanState::GetInstance().GetCommandBuffer(), "Culling");
+        m_cameraCulling->SetView(cameraFrustum, viewProjection, deferredCount + frontCount);
+        m_cameraCulling->Cull(0, m_settings.occlusionCulling && m_hiZPass->IsBuilt());
+        if (m_shadowUpdate != ShadowUpdate::Skip) {
+            m_shadowCulling->SetView(lightFrustum, lightSpaceMatrix, deferredCount + frontCount);
+            m_shadowCulling->Cull(0, false);
+        }
+
+        m_drawContent.cameraCulling = m_cameraCulling.get();
+        m_drawContent.shadowCulling = m_shadowCulling.get();
+        return;
+    }
+
+    m_drawContent.cameraCulling = nullptr;
+    m_drawContent.shadowCulling = nullptr;
+
+    m_drawContent.cameraVisible.clear();
+    m_drawContent.shadowVisible.clear();
+    m_drawContent.staticShadowVisible.clear();
+
+    culling::CullSpheres(cameraFrustum, m_drawContent.scene, 0, deferredCount + frontCount, m_drawContent.cameraVisible);
+    if (m_shadowUpdate != ShadowUpdate::Skip) {
+        culling::CullSpheres(lightFrustum, m_drawContent.scene, 0, deferredCount + frontCount, m_drawContent.shadowVisible);
+    }
+
+    if (m_shadowUpdate == ShadowUpdate::Dynamic || m_shadowUpdate == ShadowUpdate::Full) {
+        // Static casters come from the cache, only a full update redraws them
+        std::vector<uint32_t> &shadowVisible = m_drawContent.shadowVisible;
+
+        const SceneStore &scene = m_drawContent.scene;
+        const auto split = std::stable_partition(shadowVisible.begin(), shadowVisible.end(), [&scene](uint32_t index) {
+            return scene.IsDynamic(index);
+        });
+        if (m_shadowUpdate == ShadowUpdate::Full) {
+            m_drawContent.staticShadowVisible.assign(split, shadowVisible.end());
+        }
+        shadowVisible.erase(split, shadowVisible.end());
+    }
+
+    // Group the visible instances of each view by batch for instanced draws
+    const uint32_t sceneCount = m_drawContent.scene.GetCount();
+    instancing::BuildRanges(
+        m_drawContent.cameraVisible,
+        m_drawContent.instanceBatches,
+        sceneCount,
+        m_instanceIndices,
+        m_drawContent.cameraRanges
+    );
+    instancing::BuildRanges(
+        m_drawContent.shadowVisible,
+        m_drawContent.instanceBatches,
+        sceneCount * 2,
+        m_instanceIndices,
+        m_drawContent.shadowRanges
     );
+    instancing::BuildRanges(
+        m_drawContent.staticShadowVisible,
+        m_drawContent.instanceBatches,
+        sceneCount * 2 + static_cast<uint32_t>(m_drawContent.shadowVisible.size()),
+        m_instanceIndices,
+        m_drawContent.staticShadowRanges
+    );
+    m_instanceIndexBuffer.Upload(sizeof(uint32_t) * m_instanceIndices.size(), m_instanceIndices.data());
+}
+
+void PbrRenderer::BuildDrawList(const glm::mat4 &view) {
+    PROFILE_ZONE("PbrRenderer::BuildDrawList");
+    m_drawList.Clear();
+
+    const uint32_t shadowPipeline      = PipelineManager::GetInstance().Load("shadow_gfx")->GetId();
+    const uint32_t pointShadowPipeline = PipelineManager::GetInstance().Load("point_shadow_gfx")->GetId();
+    const uint32_t gBufferPipeline     = PipelineManager::GetInstance().Load("gbuffer_gfx")->GetId();
+    const uint32_t forwardPipeline     = PipelineManager::GetInstance().Load("forward_gfx")->GetId();
+
+    // View space distance to the nearest instance of a range
+    auto nearestDepth = [this, &view](const InstanceRange &range) {
+        const SceneStore &scene = m_drawContent.scene;
+
+        float depth = std::numeric_limits<float>::max();
+        for (uint32_t i = range.first; i < range.first + range.count; i++) {
+            const uint32_t index = m_instanceIndices[i];
+            const float    z     = view[0][2] * scene.GetCentersX()[index] + view[1][2] * scene.GetCentersY()[index] +
+                            view[2][2] * scene.GetCentersZ()[index] + view[3][2];
+            depth = std::min(depth, -z - scene.GetRadii()[index]);
+        }
+        return depth;
+    };
+
+    for (uint32_t i = 0; i < m_drawContent.batches.size(); i++) {
+        const VulkanObject *object   = m_drawContent.batches[i].object;
+        const uint32_t      material = object->GetMaterial()->GetId();
+        const uint32_t      mesh     = object->GetMesh()->GetId();
+
+        const bool     isDeferred     = i < m_drawContent.deferredBatchCount;
+        const DrawPass cameraPass     = isDeferred ? DrawPass::GBuffer : DrawPass::Forward;
+        const uint32_t cameraPipeline = isDeferred ? gBufferPipeline : forwardPipeline;
+
+        // Shadows bind no material, their packets only sort by mesh
+        const InstanceRange &pointShadowRange = m_drawContent.pointShadowRanges[i];
+        if (pointShadowRange.count > 0) {
+            m_drawList.Add(DrawPass::PointShadow, pointShadowPipeline, 0, mesh, 0.0f, i, pointShadowRange);
+        }
+
+        if (m_drawContent.cameraCulling != nullptr) {
+            m_drawList.Add(cameraPass, cameraPipeline, material, mesh, 0.0f, i, {});
+            m_drawList.Add(DrawPass::Shadow, shadowPipeline, 0, mesh, 0.0f, i, {});
+            continue;
+        }
+
+        const InstanceRange &cameraRange = m_drawContent.cameraRanges[i];
+        if (cameraRange.count > 0) {
+            m_drawList.Add(cameraPass, cameraPipeline, material, mesh, nearestDepth(cameraRange), i, cameraRange);
+        }
+
+        const InstanceRange &shadowRange = m_drawContent.shadowRanges[i];
+        if (shadowRange.count > 0) {
+            m_drawList.Add(DrawPass::Shadow, shadowPipeline, 0, mesh, 0.0f, i, shadowRange);
+        }
+
+        const InstanceRange &staticShadowRange = m_drawContent.staticShadowRanges[i];
+        if (staticShadowRange.count > 0) {
+            m_drawList.Add(DrawPass::StaticShadow, shadowPipeline, 0, mesh, 0.0f, i, staticShadowRange);
+        }
+    }
+
+    m_drawList.Sort();
 }
 
 void PbrRenderer::CreateDescriptorSets() {
@@ -300,6 +645,9 @@ void PbrRenderer::CreateDescriptorSets() {
         vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("lighting_gfx")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
 
     m_cameraSet =
+        vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("skybox_gfx")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
+
+    m_uniformGBufferSet =
         vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("gbuffer_gfx")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
 
     m_iblSet = vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("lighting_gfx")->GetDescriptorSetLayouts()[descriptor::IBL_SET]);
@@ -307,25 +655,26 @@ void PbrRenderer::CreateDescriptorSets() {
     m_uniformShadowSet =
         vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("shadow_gfx")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
 
+    m_uniformPointShadowSet =
+        vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("point_shadow_gfx")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
+
     m_uniformForwardSet =
         vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("forward_gfx")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
-
-    m_postProcessSet =
-        vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("post_processing_gfx")->GetDescriptorSetLayouts()[descriptor::TEXTURE_SET]);
 }
 
-void PbrRenderer::CreateRenderConfig() {
+void PbrRenderer::UpdateRenderConfig(VkExtent2D extent) {
+    // Camera passes draw into the top left extent of the targets
     m_config.renderArea = {
-        .offset = {0,                                     0                                     },
-        .extent = {VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight()}
+        .offset = {0, 0},
+        .extent = extent
     };
     m_config.viewport = {
         .x        = 0.f,
         // Flip the view port
-        .y        = static_cast<float>(VulkanState::GetInstance().GetHeight()),
-        .width    = static_cast<float>(VulkanState::GetInstance().GetWidth()),
+        .y        = static_cast<float>(extent.height),
+        .width    = static_cast<float>(extent.width),
         // Flip the view port
-        .height   = -static_cast<float>(VulkanState::GetInstance().GetHeight()),
+        .height   = -static_cast<float>(extent.height),
         .minDepth = 0.f,
         .maxDepth = 1.f
     };
@@ -364,6 +713,31 @@ void PbrRenderer::OneTimeUpdateDescriptorSets() {
     };
 
 
+    std::vector<VkDescriptorBufferInfo> infoInstances{
+        {.buffer = m_instanceBuffer.GetBuffer(),      .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = m_instanceIndexBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE},
+    };
+
+    // Instance transforms and indices for every pass drawing prefabs
+    std::vector<VkWriteDescriptorSet> writeSetsInstances;
+    for (const VkDescriptorSet set: {m_uniformGBufferSet, m_uniformShadowSet, m_uniformPointShadowSet, m_uniformForwardSet}) {
+        writeSetsInstances.push_back({
+            .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext            = nullptr,
+            .dstSet           = set,
+            .dstBinding       = 2,
+            .dstArrayElement  = 0,
+            .descriptorCount  = static_cast<uint32_t>(infoInstances.size()),
+            .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pImageInfo       = nullptr,
+            .pBufferInfo      = infoInstances.data(),
+            .pTexelBufferView = nullptr,
+        });
+    }
+
+    VkWriteDescriptorSet writeSetGBuffer = writeSetCamera;
+    writeSetGBuffer.dstSet               = m_uniformGBufferSet;
+
     std::vector<VkDescriptorImageInfo> infoImages{
         {.sampler = m_brdf->GetSampler(),       .imageView = m_brdf->GetImageView(),       .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
         {.sampler = m_irradiance->GetSampler(), .imageView = m_irradiance->GetImageView(), .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
@@ -410,30 +784,23 @@ void PbrRenderer::OneTimeUpdateDescriptorSets() {
     };
 
 
-    VkDescriptorImageInfo infoPostProcess{
-        .sampler     = m_sampler,
-        .imageView   = m_drawImage.GetImageView(),
-        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-    };
-
-
-    VkWriteDescriptorSet writeSetPostProcess{
-        .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .pNext            = nullptr,
-        .dstSet           = m_postProcessSet,
-        .dstBinding       = 0,
-        .dstArrayElement  = 0,
-        .descriptorCount  = 1,
-        .descriptorType   = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-        .pImageInfo       = &infoPostProcess,
-        .pBufferInfo      = nullptr,
-        .pTexelBufferView = nullptr,
-    };
-
     vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSetUniform, 0, 0);
     vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSetCamera, 0, 0);
     vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSetIBL, 0, 0);
     vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSetUniformShadow, 0, 0);
     vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSetForward, 0, 0);
-    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSetPostProcess, 0, 0);
+    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSetGBuffer, 0, 0);
+    vkUpdateDescriptorSets(
+        VulkanState::GetInstance().GetDevice(),
+        static_cast<uint32_t>(writeSetsInstances.size()),
+        writeSetsInstances.data(),
+        0,
+        nullptr
+    );
+
+    // Shading reads the lights through the clusters
+    m_clusteredLighting->WriteDescriptorSet(m_uniformSet);
+    m_clusteredLighting->WriteDescriptorSet(m_uniformForwardSet);
+
+    m_pointShadowPass.WriteDescriptorSet(m_shadowPass.GetCSMSet());
 }
@@ -0,0 +1,385 @@
+#include "include/PointShadowPass.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <include/Frustum.h>
+#include <include/LightManager.h>
+#include <include/PbrRenderer.h>
+#include <include/SamplerCache.h>
+#include <include/VulkanUtil.h>
+
+namespace {
+constexpr uint32_t ATLAS_SIZE    = 4096;
+constexpr uint32_t MIN_TILE_SIZE = 64;
+constexpr uint32_t MAX_TILE_SIZE = 512;
+// Shadows redrawn per frame, the rest keep last frame's tiles
+constexpr uint32_t UPDATE_BUDGET = 4;
+
+// Bilinear compare filtering, reads are kept inside their tile in shadow.glsl
+const SamplerConfig POINT_SHADOW_SAMPLER{
+    .filter        = VK_FILTER_LINEAR,
+    .mipmapMode    = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+    .addressMode   = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+    .compareEnable = VK_TRUE,
+    .compareOp     = VK_COMPARE_OP_GREATER_OR_EQUAL,
+    .maxLod        = 1.0f,
+};
+
+// Faces ordered +x, -x, +y, -y, +z, -z like shadow.glsl picks them
+const glm::vec3 FACE_DIRECTIONS[CUBE_FACE_COUNT] = {
+    {1.0f,  0.0f,  0.0f },
+    {-1.0f, 0.0f,  0.0f },
+    {0.0f,  1.0f,  0.0f },
+    {0.0f,  -1.0f, 0.0f },
+    {0.0f,  0.0f,  1.0f },
+    {0.0f,  0.0f,  -1.0f},
+};
+const glm::vec3 FACE_UPS[CUBE_FACE_COUNT] = {
+    {0.0f, -1.0f, 0.0f },
+    {0.0f, -1.0f, 0.0f },
+    {0.0f, 0.0f,  1.0f },
+    {0.0f, 0.0f,  -1.0f},
+    {0.0f, -1.0f, 0.0f },
+    {0.0f, -1.0f, 0.0f },
+};
+
+// Mirrors shadow.glsl
+struct GpuPointShadow {
+    glm::mat4 faceMatrices[CUBE_FACE_COUNT];
+    glm::vec4 faceRects[CUBE_FACE_COUNT]; // Atlas uv offset in xy, scale in zw
+};
+
+bool IsSphereVisible(const Frustum &frustum, const glm::vec3 &center, float radius) {
+    return std::ranges::all_of(frustum.planes, [&center, radius](const glm::vec4 &plane) {
+        return glm::dot(glm::vec3(plane), center) + plane.w >= -radius;
+    });
+}
+
+// Larger lights on screen get larger tiles
+uint32_t GetTileSize(float coverage) {
+    const auto size = static_cast<uint32_t>(coverage * static_cast<float>(MAX_TILE_SIZE));
+    return std::clamp(std::bit_ceil(std::max(size, 1u)), MIN_TILE_SIZE, MAX_TILE_SIZE);
+}
+} // namespace
+
+PointShadowPass::PointShadowPass()
+    : m_allocator(ATLAS_SIZE, MIN_TILE_SIZE) {
+    VkClearValue depthClear = {
+        .depthStencil = {.depth = 1.0f, .stencil = 0}
+    };
+
+    VulkanImage atlas(
+        VK_FORMAT_D32_SFLOAT,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        {ATLAS_SIZE, ATLAS_SIZE, 1},
+        VK_IMAGE_ASPECT_DEPTH_BIT
+    );
+    m_atlas = std::move(atlas);
+
+    m_atlasAttachment = vk_util::GetRenderingAttachmentInfo(
+        m_atlas.GetImageView(),
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        &depthClear,
+        VK_ATTACHMENT_LOAD_OP_CLEAR,
+        VK_ATTACHMENT_STORE_OP_STORE,
+        VK_RESOLVE_MODE_NONE,
+        VK_NULL_HANDLE,
+        VK_IMAGE_LAYOUT_UNDEFINED
+    );
+
+    m_sampler = SamplerCache::GetInstance().Acquire(POINT_SHADOW_SAMPLER);
+
+    VulkanBuffer shadowBuffer(sizeof(GpuPointShadow) * MAX_POINT_SHADOW_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_shadowBuffer = std::move(shadowBuffer);
+
+    VulkanBuffer lightShadowBuffer(sizeof(int32_t) * MAX_LIGHT_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_lightShadowBuffer = std::move(lightShadowBuffer);
+}
+
+PointShadowPass::~PointShadowPass() {
+    if (m_sampler != VK_NULL_HANDLE) {
+        SamplerCache::GetInstance().Release(POINT_SHADOW_SAMPLER);
+    }
+    m_sampler = VK_NULL_HANDLE;
+
+    m_atlas             = {};
+    m_shadowBuffer      = {};
+    m_lightShadowBuffer = {};
+}
+
+void PointShadowPass::Update(const CameraData &cameraData, bool castersMoved) {
+    SelectShadows(cameraData);
+
+    const std::vector<Light> &lights = LightManager::GetInstance().GetLights();
+    for (auto &shadow: m_shadows) {
+        const Light &light = lights[shadow.light];
+        if (!castersMoved && shadow.ready && light.position == shadow.position && light.range == shadow.range) {
+            continue;
+        }
+
+        shadow.dirty    = true;
+        shadow.position = light.position;
+        shadow.range    = light.range;
+
+        const glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, shadow.range * 0.01f, shadow.range);
+        for (uint32_t face = 0; face < CUBE_FACE_COUNT; face++) {
+            shadow.faceMatrices[face] = projection * glm::lookAt(shadow.position, shadow.position + FACE_DIRECTIONS[face], FACE_UPS[face]);
+        }
+    }
+
+    // Shadows that were never drawn go first, then the most visible ones
+    std::vector<uint32_t> dirty;
+    for (uint32_t i = 0; i < m_shadows.size(); i++) {
+        if (m_shadows[i].dirty) {
+            dirty.push_back(i);
+        }
+    }
+    std::ranges::stable_sort(dirty, [this](uint32_t a, uint32_t b) {
+        if (m_shadows[a].ready != m_shadows[b].ready) {
+            return !m_shadows[a].ready;
+        }
+        return m_shadows[a].coverage > m_shadows[b].coverage;
+    });
+
+    m_pending.assign(dirty.begin(), dirty.begin() + std::min<size_t>(dirty.size(), UPDATE_BUDGET));
+    for (const uint32_t index: m_pending) {
+        m_shadows[index].dirty = false;
+        m_shadows[index].ready = true;
+    }
+
+    Upload();
+}
+
+void PointShadowPass::SelectShadows(const CameraData &cameraData) {
+    const std::vector<Light> &lights  = LightManager::GetInstance().GetLights();
+    const Frustum             frustum = Frustum::FromMatrix(cameraData.projection * cameraData.view);
+
+    // Rank the visible point lights by projected radius, light 0 has the cascades
+    std::vector<std::pair<float, uint32_t>> candidates;
+    for (uint32_t i = 1; i < lights.size(); i++) {
+        const Light &light = lights[i];
+        if (light.type != static_cast<uint32_t>(LightType::Point) || !IsSphereVisible(frustum, light.position, light.range)) {
+            continue;
+        }
+
+        const float distance = glm::length(light.position - cameraData.position);
+        const float coverage = distance <= light.range ? 1.0f : std::min(light.range / distance * cameraData.projection[1][1], 1.0f);
+        candidates.emplace_back(coverage, i);
+    }
+    std::ranges::sort(candidates, std::greater<>());
+    candidates.resize(std::min<size_t>(candidates.size(), MAX_POINT_SHADOW_COUNT));
+
+    // Keep tiles within a factor of two of the wanted size, so tiles are not reallocated on every small camera move
+    std::vector<PointShadow> shadows;
+    for (const auto &shadow: m_shadows) {
+        const auto candidate = std::ranges::find(candidates, shadow.light, &std::pair<float, uint32_t>::second);
+        if (candidate == candidates.end()) {
+            FreeTiles(shadow);
+            continue;
+        }
+
+        const uint32_t tileSize = GetTileSize(candidate->first);
+        if (tileSize > shadow.tiles[0].size * 2 || tileSize * 2 < shadow.tiles[0].size) {
+            FreeTiles(shadow);
+            continue;
+        }
+
+        shadows.push_back(shadow);
+        shadows.back().coverage = candidate->first;
+    }
+
+    for (const auto &[coverage, light]: candidates) {
+        if (std::ranges::find(shadows, light, &PointShadow::light) != shadows.end()) {
+            continue;
+        }
+
+        PointShadow shadow{.light = light, .coverage = coverage};
+        if (AllocateTiles(shadow, GetTileSize(coverage))) {
+            shadows.push_back(shadow);
+        }
+    }
+
+    m_shadows = std::move(shadows);
+}
+
+bool PointShadowPass::AllocateTiles(PointShadow &shadow, uint32_t tileSize) {
+    // Fall back to smaller tiles when the atlas is crowded
+    for (; tileSize >= MIN_TILE_SIZE; tileSize /= 2) {
+        uint32_t face = 0;
+        for (; face < CUBE_FACE_COUNT; face++) {
+            const std::optional<AtlasTile> tile = m_allocator.Allocate(tileSize);
+            if (!tile.has_value()) {
+                break;
+            }
+            shadow.tiles[face] = *tile;
+        }
+
+        if (face == CUBE_FACE_COUNT) {
+            return true;
+        }
+        for (uint32_t i = 0; i < face; i++) {
+            m_allocator.Free(shadow.tiles[i]);
+        }
+    }
+    return false;
+}
+
+void PointShadowPass::FreeTiles(const PointShadow &shadow) {
+    for (const auto &tile: shadow.tiles) {
+        m_allocator.Free(tile);
+    }
+}
+
+void PointShadowPass::Upload() {
+    std::vector<GpuPointShadow> gpuShadows(m_shadows.size());
+    m_lightShadows.assign(LightManager::GetInstance().GetLightCount(), -1);
+
+    const float atlasSize = static_cast<float>(m_allocator.GetSize());
+    for (uint32_t i = 0; i < m_shadows.size(); i++) {
+        const PointShadow &shadow = m_shadows[i];
+        for (uint32_t face = 0; face < CUBE_FACE_COUNT; face++) {
+            const AtlasTile &tile = shadow.tiles[face];
+
+            gpuShadows[i].faceMatrices[face] = shadow.faceMatrices[face];
+            gpuShadows[i].faceRects[face]    = glm::vec4(tile.x, tile.y, tile.size, tile.size) / atlasSize;
+        }
+
+        // Shadows still waiting for their first draw stay unshadowed
+        if (shadow.ready) {
+            m_lightShadows[shadow.light] = static_cast<int32_t>(i);
+        }
+    }
+
+    m_shadowBuffer.Upload(sizeof(GpuPointShadow) * gpuShadows.size(), gpuShadows.data());
+    m_lightShadowBuffer.Upload(sizeof(int32_t) * m_lightShadows.size(), m_lightShadows.data());
+}
+
+void PointShadowPass::PreRender() {
+    // Tiles not redrawn this frame are kept
+    vk_util::CmdImageLayoutTransition(
+        VulkanState::GetInstance().GetCommandBuffer(),
+        m_atlas.GetImage(),
+        m_initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        m_initialized ? VK_ACCESS_SHADER_READ_BIT : 0,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+    );
+    m_atlasAttachment.loadOp = m_initialized ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+}
+
+void PointShadowPass::PostRender() {
+    vk_util::CmdImageLayoutTransition(
+        VulkanState::GetInstance().GetCommandBuffer(),
+        m_atlas.GetImage(),
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT
+    );
+    m_initialized = true;
+}
+
+void PointShadowPass::WriteDescriptorSet(VkDescriptorSet set) const {
+    VkDescriptorImageInfo infoAtlas{
+        .sampler     = m_sampler,
+        .imageView   = m_atlas.GetImageView(),
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
+
+    std::vector<VkDescriptorBufferInfo> infoBuffers{
+        {.buffer = m_shadowBuffer.GetBuffer(),      .offset = 0, .range = VK_WHOLE_SIZE},
+        {.buffer = m_lightShadowBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE},
+    };
+
+    std::vector<VkWriteDescriptorSet> writeSets{
+        {
+         .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .pNext            = nullptr,
+         .dstSet           = set,
+         .dstBinding       = 1,
+         .dstArrayElement  = 0,
+         .descriptorCount  = 1,
+         .descriptorType   = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+         .pImageInfo       = &infoAtlas,
+         .pBufferInfo      = nullptr,
+         .pTexelBufferView = nullptr,
+         },
+        {
+         .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .pNext            = nullptr,
+         .dstSet           = set,
+         .dstBinding       = 2,
+         .dstArrayElement  = 0,
+         .descriptorCount  = static_cast<uint32_t>(infoBuffers.size()),
+         .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         .pImageInfo       = nullptr,
+         .pBufferInfo      = infoBuffers.data(),
+         .pTexelBufferView = nullptr,
+         },
+    };
+
+    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+}
+
+void PointShadowPass::CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) {
+    VkRect2D area{
+        .offset = {0,          0         },
+        .extent = {ATLAS_SIZE, ATLAS_SIZE},
+    };
+    VkViewport viewport{
+        .x        = 0.f,
+        .y        = 0.f,
+        .width    = static_cast<float>(ATLAS_SIZE),
+        .height   = static_cast<float>(ATLAS_SIZE),
+        .minDepth = 0.f,
+        .maxDepth = 1.f
+    };
+    m_infoRendering = vk_util::GetRenderingInfo(area, nullptr, &m_atlasAttachment);
+    m_viewport      = viewport;
+}
+
+void PointShadowPass::DrawCalls(const DrawContent &content, VkPipelineLayout layout) {
+    const VkCommandBuffer cmdBuf = VulkanState::GetInstance().GetCommandBuffer();
+
+    for (const uint32_t index: m_pending) {
+        const PointShadow &shadow = m_shadows[index];
+
+        for (uint32_t face = 0; face < CUBE_FACE_COUNT; face++) {
+            const AtlasTile &tile = shadow.tiles[face];
+
+            // Each face renders into its own tile
+            VkRect2D scissor{
+                .offset = {static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y)},
+                .extent = {tile.size,                    tile.size                   },
+            };
+            VkViewport viewport{
+                .x        = static_cast<float>(tile.x),
+                .y        = static_cast<float>(tile.y),
+                .width    = static_cast<float>(tile.size),
+                .height   = static_cast<float>(tile.size),
+                .minDepth = 0.f,
+                .maxDepth = 1.f
+            };
+            vkCmdSetViewport(cmdBuf, 0, 1, &viewport);
+            vkCmdSetScissor(cmdBuf, 0, 1, &scissor);
+
+            VkClearAttachment clear{
+                .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
+                .clearValue = {.depthStencil = {.depth = 1.0f, .stencil = 0}},
+            };
+            VkClearRect clearRect{.rect = scissor, .baseArrayLayer = 0, .layerCount = 1};
+            vkCmdClearAttachments(cmdBuf, 1, &clear, 1, &clearRect);
+
+            vkCmdPushConstants(cmdBuf, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &shadow.faceMatrices[face]);
+            content.drawList->Record(DrawPass::PointShadow, content, [&content](const DrawPacket &packet) {
+                content.batches[packet.batch].object->GetMesh()->Draw(packet.range.count, packet.range.first);
+            });
+        }
+    }
+}
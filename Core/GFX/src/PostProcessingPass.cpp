@@ -1,13 +1,463 @@
 #include "include/PostProcessingPass.h"
 
-#include "include/PbrRenderer.h"
-#include "include/VulkanUtil.h"
+#include <algorithm>
+#include <bit>
 
-void PostProcessingPass::CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) {
-    m_infoRendering = vk_util::GetRenderingInfo(config.renderArea, &content.postProcessdAttachments, nullptr);
-    m_viewport = config.viewport;
+#include <glm/glm.hpp>
+
+#include <Debug.h>
+
+#include <include/Descriptor.h>
+#include <include/GpuProfiler.h>
+#include <include/PipelineManager.h>
+#include <include/RenderSettings.h>
+#include <include/SamplerCache.h>
+#include <include/VulkanState.h>
+#include <include/VulkanUtil.h>
+
+namespace {
+constexpr uint32_t POST_GROUP_SIZE   = 8;
+constexpr uint32_t BLOOM_LEVEL_COUNT = 6;
+
+const SamplerConfig POST_PROCESS_SAMPLER{
+    .mipmapMode  = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+    .addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+};
+
+// Mirrors bloom_downsample.comp
+struct BloomDownsample {
+    glm::vec2  sourceTexelSize;
+    glm::ivec2 destinationSize;
+    glm::vec2  sourceUvScale = glm::vec2(1.0f);
+    float      threshold     = 0.0f;
+    uint32_t   firstLevel = 0;
+};
+
+// Mirrors bloom_upsample.comp
+struct BloomUpsample {
+    glm::vec2  sourceTexelSize;
+    glm::ivec2 destinationSize;
+    float      radius = 1.0f;
+};
+
+// Mirrors tonemap.comp
+struct Tonemap {
+    glm::ivec2 outputSize;
+    glm::vec2  sceneTexelSize;
+    glm::vec2  sceneUvScale   = glm::vec2(1.0f);
+    float      exposure       = 1.0f;
+    float      bloomIntensity = 0.0f;
+    float      sharpness      = 0.0f;
+};
+
+// Mirrors fxaa.comp
+struct Resolve {
+    glm::ivec2 outputSize;
+    uint32_t   fxaa = 0;
+};
+
+VkExtent2D GetLevelExtent(VkExtent2D extent, uint32_t level) {
+    return {std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u)};
+}
+
+void Dispatch(VkCommandBuffer cmdBuf, VkExtent2D extent) {
+    vkCmdDispatch(cmdBuf, (extent.width + POST_GROUP_SIZE - 1) / POST_GROUP_SIZE, (extent.height + POST_GROUP_SIZE - 1) / POST_GROUP_SIZE, 1);
+}
+
+// Every later dispatch reads what the previous one wrote
+void ComputeBarrier(VkCommandBuffer cmdBuf) {
+    vk_util::CmdMemoryBarrier(
+        cmdBuf,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    );
+}
+
+VkWriteDescriptorSet GetImageWrite(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, const VkDescriptorImageInfo *info) {
+    return {
+        .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext            = nullptr,
+        .dstSet           = set,
+        .dstBinding       = binding,
+        .dstArrayElement  = 0,
+        .descriptorCount  = 1,
+        .descriptorType   = type,
+        .pImageInfo       = info,
+        .pBufferInfo      = nullptr,
+        .pTexelBufferView = nullptr,
+    };
+}
+} // namespace
+
+PostProcessingPass::PostProcessingPass(const VulkanImage &drawImage, const VulkanImage &uiOverlay) {
+    m_sampler = SamplerCache::GetInstance().Acquire(POST_PROCESS_SAMPLER);
+    m_tonemapSet =
+        vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("tonemap_comp")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET]);
+
+    Resize(drawImage, uiOverlay);
+}
+
+PostProcessingPass::~PostProcessingPass() {
+    DestroyBloom();
+    for (const auto set: m_fxaaSets) {
+        vk_util::FreeDescriptorSet(set);
+    }
+    if (m_tonemapSet != VK_NULL_HANDLE) {
+        vk_util::FreeDescriptorSet(m_tonemapSet);
+    }
+    if (m_sampler != VK_NULL_HANDLE) {
+        SamplerCache::GetInstance().Release(POST_PROCESS_SAMPLER);
+    }
+
+    m_fxaaSets.clear();
+    m_tonemapSet = VK_NULL_HANDLE;
+    m_sampler    = VK_NULL_HANDLE;
+    m_tonemapped = {};
+}
+
+void PostProcessingPass::Resize(const VulkanImage &drawImage, const VulkanImage &uiOverlay) {
+    m_extent = {VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight()};
+
+    // The bloom chain follows the draw image, which keeps its size and view until it is reallocated
+    const VkExtent2D sceneExtent   = {drawImage.GetExtent().width, drawImage.GetExtent().height};
+    const bool       sceneResized  = sceneExtent.width != m_sceneExtent.width || sceneExtent.height != m_sceneExtent.height;
+    const VkExtent2D current       = {m_tonemapped.GetExtent().width, m_tonemapped.GetExtent().height};
+    const VkExtent2D target        = vk_util::GetTargetExtent(current, m_extent);
+    const bool       outputResized = target.width != current.width || target.height != current.height;
+
+    if (sceneResized) {
+        m_sceneExtent = sceneExtent;
+        DestroyBloom();
+        CreateBloom(drawImage);
+    }
+    if (outputResized) {
+        CreateTonemapped(target);
+    }
+    if (sceneResized || outputResized) {
+        UpdateTonemapSet(drawImage);
+        m_initialized = false;
+    }
+
+    // Swapchain views are new on every resize
+    UpdateFxaaSets(uiOverlay);
 }
 
-void PostProcessingPass::DrawCalls(const DrawContent &content, VkPipelineLayout layout) {
-    content.screen->BindAndDraw();
+void PostProcessingPass::Render(VkCommandBuffer cmdBuf, const RenderSettings &settings, VkExtent2D renderExtent) {
+    GpuZone zone(cmdBuf, "Post-Processing");
+
+    if (!m_initialized) {
+        // Both images stay in general layout for their whole life
+        vk_util::CmdImageLayoutTransition(
+            cmdBuf,
+            m_bloom.GetImage(),
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            0,
+            m_bloomLevelCount
+        );
+        vk_util::CmdImageLayoutTransition(
+            cmdBuf,
+            m_tonemapped.GetImage(),
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_GENERAL,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+        );
+        m_initialized = true;
+    }
+
+    const glm::vec2 sceneUvScale = glm::vec2(renderExtent.width, renderExtent.height) / glm::vec2(m_sceneExtent.width, m_sceneExtent.height);
+    const bool      upscaling    = renderExtent.width != m_extent.width || renderExtent.height != m_extent.height;
+
+    if (settings.bloom) {
+        RenderBloom(cmdBuf, settings, sceneUvScale);
+    }
+
+    Tonemap tonemap{
+        .outputSize     = glm::ivec2(m_extent.width, m_extent.height),
+        .sceneTexelSize = 1.0f / glm::vec2(m_sceneExtent.width, m_sceneExtent.height),
+        .sceneUvScale   = sceneUvScale,
+        .exposure       = settings.exposure,
+        .bloomIntensity = settings.bloom ? settings.bloomIntensity : 0.0f,
+        .sharpness      = upscaling ? settings.upscaleSharpness : 0.0f,
+    };
+
+    const VulkanPipeline *tonemapPipeline = PipelineManager::GetInstance().Load("tonemap_comp");
+    vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, tonemapPipeline->GetPipeline());
+    vkCmdBindDescriptorSets(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, tonemapPipeline->GetLayout(), descriptor::UNIFORM_SET, 1, &m_tonemapSet, 0, nullptr);
+    vkCmdPushConstants(cmdBuf, tonemapPipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Tonemap), &tonemap);
+    Dispatch(cmdBuf, m_extent);
+    ComputeBarrier(cmdBuf);
+
+    // The swapchain image is fully overwritten, its old content is dropped
+    vk_util::CmdImageLayoutTransition(
+        cmdBuf,
+        VulkanState::GetInstance().GetPresentImage(),
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        0,
+        VK_ACCESS_SHADER_WRITE_BIT
+    );
+
+    Resolve resolve{
+        .outputSize = glm::ivec2(m_extent.width, m_extent.height),
+        .fxaa       = settings.fxaa ? 1u : 0u,
+    };
+
+    const VulkanPipeline *fxaaPipeline = PipelineManager::GetInstance().Load("fxaa_comp");
+    vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, fxaaPipeline->GetPipeline());
+    vkCmdBindDescriptorSets(
+        cmdBuf,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        fxaaPipeline->GetLayout(),
+        descriptor::UNIFORM_SET,
+        1,
+        &m_fxaaSets[VulkanState::GetInstance().GetPresentImageIndex()],
+        0,
+        nullptr
+    );
+    vkCmdPushConstants(cmdBuf, fxaaPipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Resolve), &resolve);
+    Dispatch(cmdBuf, m_extent);
+
+    vk_util::CmdImageLayoutTransition(
+        cmdBuf,
+        VulkanState::GetInstance().GetPresentImage(),
+        VK_IMAGE_LAYOUT_GENERAL,
+        VulkanState::GetInstance().GetPresentLayout(),
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VulkanState::GetInstance().IsHeadless() ? VK_ACCESS_TRANSFER_READ_BIT : 0
+    );
+}
+
+void PostProcessingPass::RenderBloom(VkCommandBuffer cmdBuf, const RenderSettings &settings, const glm::vec2 &sceneUvScale) {
+    // Last frame's tonemap may still be sampling the chain
+    ComputeBarrier(cmdBuf);
+
+    const VulkanPipeline *downsamplePipeline = PipelineManager::GetInstance().Load("bloom_downsample_comp");
+    vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, downsamplePipeline->GetPipeline());
+
+    for (uint32_t i = 0; i < m_bloomLevelCount; i++) {
+        const VkExtent2D source      = i == 0 ? m_sceneExtent : GetLevelExtent(m_bloomExtent, i - 1);
+        const VkExtent2D destination = GetLevelExtent(m_bloomExtent, i);
+
+        BloomDownsample level{
+            .sourceTexelSize = 1.0f / glm::vec2(source.width, source.height),
+            .destinationSize = glm::ivec2(destination.width, destination.height),
+            .sourceUvScale   = i == 0 ? sceneUvScale : glm::vec2(1.0f),
+            .threshold       = settings.bloomThreshold,
+            .firstLevel      = i == 0 ? 1u : 0u,
+        };
+
+        vkCmdBindDescriptorSets(
+            cmdBuf,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            downsamplePipeline->GetLayout(),
+            descriptor::UNIFORM_SET,
+            1,
+            &m_downsampleSets[i],
+            0,
+            nullptr
+        );
+        vkCmdPushConstants(cmdBuf, downsamplePipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(BloomDownsample), &level);
+        Dispatch(cmdBuf, destination);
+        ComputeBarrier(cmdBuf);
+    }
+
+    // Walk back up, each level accumulates the blurred level below it
+    const VulkanPipeline *upsamplePipeline = PipelineManager::GetInstance().Load("bloom_upsample_comp");
+    vkCmdBindPipeline(cmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, upsamplePipeline->GetPipeline());
+
+    for (uint32_t i = m_bloomLevelCount - 1; i-- > 0;) {
+        const VkExtent2D source      = GetLevelExtent(m_bloomExtent, i + 1);
+        const VkExtent2D destination = GetLevelExtent(m_bloomExtent, i);
+
+        BloomUpsample level{
+            .sourceTexelSize = 1.0f / glm::vec2(source.width, source.height),
+            .destinationSize = glm::ivec2(destination.width, destination.height),
+        };
+
+        vkCmdBindDescriptorSets(
+            cmdBuf,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            upsamplePipeline->GetLayout(),
+            descriptor::UNIFORM_SET,
+            1,
+            &m_upsampleSets[i],
+            0,
+            nullptr
+        );
+        vkCmdPushConstants(cmdBuf, upsamplePipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(BloomUpsample), &level);
+        Dispatch(cmdBuf, destination);
+        ComputeBarrier(cmdBuf);
+    }
+}
+
+void PostProcessingPass::CreateBloom(const VulkanImage &drawImage) {
+    m_bloomExtent     = GetLevelExtent(m_sceneExtent, 1);
+    m_bloomLevelCount = std::min(BLOOM_LEVEL_COUNT, static_cast<uint32_t>(std::bit_width(std::min(m_bloomExtent.width, m_bloomExtent.height))));
+
+    VulkanImage bloom(
+        VK_FORMAT_R16G16B16A16_SFLOAT,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        {m_bloomExtent.width, m_bloomExtent.height, 1},
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_SAMPLE_COUNT_1_BIT,
+        m_bloomLevelCount
+    );
+    m_bloom = std::move(bloom);
+
+    // Storage writes need one view per level
+    for (uint32_t i = 0; i < m_bloomLevelCount; i++) {
+        VkImageViewCreateInfo infoView{
+            .sType      = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext      = nullptr,
+            .flags      = 0,
+            .image      = m_bloom.GetImage(),
+            .viewType   = VK_IMAGE_VIEW_TYPE_2D,
+            .format     = VK_FORMAT_R16G16B16A16_SFLOAT,
+            .components = {VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY},
+            .subresourceRange = vk_util::GetSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1)
+        };
+
+        VkImageView view = VK_NULL_HANDLE;
+        DEBUG_VK_ASSERT(vkCreateImageView(VulkanState::GetInstance().GetDevice(), &infoView, nullptr, &view));
+        m_bloomViews.push_back(view);
+    }
+
+    CreateBloomSets(drawImage);
+}
+
+void PostProcessingPass::DestroyBloom() {
+    for (const auto set: m_downsampleSets) {
+        vk_util::FreeDescriptorSet(set);
+    }
+    for (const auto set: m_upsampleSets) {
+        vk_util::FreeDescriptorSet(set);
+    }
+    for (const auto view: m_bloomViews) {
+        VulkanState::GetInstance().GetReleaseQueue().Release(VK_OBJECT_TYPE_IMAGE_VIEW, view);
+    }
+
+    m_downsampleSets.clear();
+    m_upsampleSets.clear();
+    m_bloomViews.clear();
+    m_bloom = {};
+}
+
+void PostProcessingPass::CreateTonemapped(VkExtent2D extent) {
+    // Tonemapped colors, FXAA reads them filtered
+    VulkanImage tonemapped(
+        VK_FORMAT_R16G16B16A16_SFLOAT,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        {extent.width, extent.height, 1},
+        VK_IMAGE_ASPECT_COLOR_BIT
+    );
+    m_tonemapped = std::move(tonemapped);
+}
+
+void PostProcessingPass::CreateBloomSets(const VulkanImage &drawImage) {
+    const VkDevice device = VulkanState::GetInstance().GetDevice();
+
+    VkDescriptorImageInfo infoDrawImage{
+        .sampler     = m_sampler,
+        .imageView   = drawImage.GetImageView(),
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
+
+    const VkDescriptorSetLayout downsampleLayout =
+        PipelineManager::GetInstance().Load("bloom_downsample_comp")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET];
+    const VkDescriptorSetLayout upsampleLayout =
+        PipelineManager::GetInstance().Load("bloom_upsample_comp")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET];
+
+    for (uint32_t i = 0; i < m_bloomLevelCount; i++) {
+        m_downsampleSets.push_back(vk_util::CreateDescriptorSet(downsampleLayout));
+
+        // The first level reads the draw image, every other level the one above it
+        VkDescriptorImageInfo infoSource = infoDrawImage;
+        if (i > 0) {
+            infoSource = {.sampler = m_sampler, .imageView = m_bloomViews[i - 1], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+        }
+        VkDescriptorImageInfo infoDestination{.sampler = VK_NULL_HANDLE, .imageView = m_bloomViews[i], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+
+        std::vector<VkWriteDescriptorSet> writeSets{
+            GetImageWrite(m_downsampleSets[i], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &infoSource),
+            GetImageWrite(m_downsampleSets[i], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &infoDestination),
+        };
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+    }
+
+    for (uint32_t i = 0; i + 1 < m_bloomLevelCount; i++) {
+        m_upsampleSets.push_back(vk_util::CreateDescriptorSet(upsampleLayout));
+
+        VkDescriptorImageInfo infoSource{.sampler = m_sampler, .imageView = m_bloomViews[i + 1], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+        VkDescriptorImageInfo infoDestination{.sampler = VK_NULL_HANDLE, .imageView = m_bloomViews[i], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+
+        std::vector<VkWriteDescriptorSet> writeSets{
+            GetImageWrite(m_upsampleSets[i], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &infoSource),
+            GetImageWrite(m_upsampleSets[i], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &infoDestination),
+        };
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+    }
+}
+
+void PostProcessingPass::UpdateTonemapSet(const VulkanImage &drawImage) {
+    VkDescriptorImageInfo infoDrawImage{
+        .sampler     = m_sampler,
+        .imageView   = drawImage.GetImageView(),
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
+    VkDescriptorImageInfo infoBloom{.sampler = m_sampler, .imageView = m_bloomViews[0], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    VkDescriptorImageInfo infoOutput{.sampler = VK_NULL_HANDLE, .imageView = m_tonemapped.GetImageView(), .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+
+    std::vector<VkWriteDescriptorSet> writeSets{
+        GetImageWrite(m_tonemapSet, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &infoDrawImage),
+        GetImageWrite(m_tonemapSet, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &infoBloom),
+        GetImageWrite(m_tonemapSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &infoOutput),
+    };
+    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+}
+
+void PostProcessingPass::UpdateFxaaSets(const VulkanImage &uiOverlay) {
+    const VkDevice device = VulkanState::GetInstance().GetDevice();
+
+    // The last dispatch writes whichever swapchain image was acquired, recreated swapchains may have another image count
+    const VkDescriptorSetLayout fxaaLayout = PipelineManager::GetInstance().Load("fxaa_comp")->GetDescriptorSetLayouts()[descriptor::UNIFORM_SET];
+    const uint32_t              imageCount = VulkanState::GetInstance().GetSwapchainImageCount();
+    while (m_fxaaSets.size() > imageCount) {
+        vk_util::FreeDescriptorSet(m_fxaaSets.back());
+        m_fxaaSets.pop_back();
+    }
+    while (m_fxaaSets.size() < imageCount) {
+        m_fxaaSets.push_back(vk_util::CreateDescriptorSet(fxaaLayout));
+    }
+
+    VkDescriptorImageInfo infoTonemapped{.sampler = m_sampler, .imageView = m_tonemapped.GetImageView(), .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+    VkDescriptorImageInfo infoOverlay{
+        .sampler     = m_sampler,
+        .imageView   = uiOverlay.GetImageView(),
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
+
+    for (uint32_t i = 0; i < imageCount; i++) {
+        VkDescriptorImageInfo infoPresent{
+            .sampler     = VK_NULL_HANDLE,
+            .imageView   = VulkanState::GetInstance().GetSwapchainImageView(i),
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        };
+
+        std::vector<VkWriteDescriptorSet> writeSets{
+            GetImageWrite(m_fxaaSets[i], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &infoTonemapped),
+            GetImageWrite(m_fxaaSets[i], 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &infoOverlay),
+            GetImageWrite(m_fxaaSets[i], 2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, &infoPresent),
+        };
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+    }
 }
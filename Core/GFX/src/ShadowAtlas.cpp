@@ -0,0 +1,86 @@
+#include "include/ShadowAtlas.h"
+
+#include <algorithm>
+#include <bit>
+
+#include <Debug.h>
+
+ShadowAtlas::ShadowAtlas(uint32_t size, uint32_t minTileSize) {
+    DEBUG_ASSERT(std::has_single_bit(size) && std::has_single_bit(minTileSize) && minTileSize <= size);
+
+    m_size        = size;
+    m_minTileSize = minTileSize;
+    m_freeTiles.resize(GetLevel(minTileSize) + 1);
+    Clear();
+}
+
+std::optional<AtlasTile> ShadowAtlas::Allocate(uint32_t size) {
+    size = std::clamp(std::bit_ceil(size), m_minTileSize, m_size);
+    return AllocateLevel(GetLevel(size));
+}
+
+void ShadowAtlas::Free(const AtlasTile &tile) {
+    uint32_t  level   = GetLevel(tile.size);
+    AtlasTile current = tile;
+
+    // Merge with the three siblings while they are all free
+    while (level > 0) {
+        const uint32_t parentSize = current.size * 2;
+        const uint32_t parentX    = current.x / parentSize * parentSize;
+        const uint32_t parentY    = current.y / parentSize * parentSize;
+
+        std::vector<AtlasTile> &freeTiles = m_freeTiles[level];
+        uint32_t                freeCount = 0;
+        for (const auto &other: freeTiles) {
+            if (other.x / parentSize * parentSize == parentX && other.y / parentSize * parentSize == parentY) {
+                freeCount++;
+            }
+        }
+        if (freeCount < 3) {
+            break;
+        }
+
+        std::erase_if(freeTiles, [parentX, parentY, parentSize](const AtlasTile &other) {
+            return other.x / parentSize * parentSize == parentX && other.y / parentSize * parentSize == parentY;
+        });
+        current = {.x = parentX, .y = parentY, .size = parentSize};
+        level--;
+    }
+
+    m_freeTiles[level].push_back(current);
+}
+
+void ShadowAtlas::Clear() {
+    for (auto &freeTiles: m_freeTiles) {
+        freeTiles.clear();
+    }
+    m_freeTiles[0].push_back({.x = 0, .y = 0, .size = m_size});
+}
+
+uint32_t ShadowAtlas::GetLevel(uint32_t size) const {
+    return static_cast<uint32_t>(std::countr_zero(m_size) - std::countr_zero(size));
+}
+
+std::optional<AtlasTile> ShadowAtlas::AllocateLevel(uint32_t level) {
+    std::vector<AtlasTile> &freeTiles = m_freeTiles[level];
+    if (!freeTiles.empty()) {
+        const AtlasTile tile = freeTiles.back();
+        freeTiles.pop_back();
+        return tile;
+    }
+    if (level == 0) {
+        return std::nullopt;
+    }
+
+    // Split a parent, keep one quadrant and free the other three
+    const std::optional<AtlasTile> parent = AllocateLevel(level - 1);
+    if (!parent.has_value()) {
+        return std::nullopt;
+    }
+
+    const uint32_t size = parent->size / 2;
+    freeTiles.push_back({.x = parent->x + size, .y = parent->y, .size = size});
+    freeTiles.push_back({.x = parent->x, .y = parent->y + size, .size = size});
+    freeTiles.push_back({.x = parent->x + size, .y = parent->y + size, .size = size});
+    return AtlasTile{.x = parent->x, .y = parent->y, .size = size};
+}
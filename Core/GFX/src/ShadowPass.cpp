@@ -2,28 +2,47 @@
 
 #include <include/Camera.h>
 #include <include/Descriptor.h>
+#include <include/LightManager.h>
 #include <include/PbrRenderer.h>
 #include <include/PipelineManager.h>
+#include <include/SamplerCache.h>
 #include <include/VulkanState.h>
 #include <include/VulkanUtil.h>
 
+namespace {
+const SamplerConfig SHADOW_SAMPLER{
+    .filter        = VK_FILTER_NEAREST,
+    .mipmapMode    = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+    .addressMode   = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
+    .compareEnable = VK_TRUE,
+    .compareOp     = VK_COMPARE_OP_GREATER_OR_EQUAL,
+    .maxLod        = 1.0f,
+    .borderColor   = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
+};
+
+// Every cascade is one view of the multiview pass
+constexpr uint32_t CASCADE_VIEW_MASK = (1u << CASCADE_COUNT) - 1;
+} // namespace
+
 ShadowPass::ShadowPass() {
-    m_extent = {.width = 3200, .height = 1800};
+    m_extent = {.width = SHADOW_MAP_RESOLUTION, .height = SHADOW_MAP_RESOLUTION};
     CreateShadowMapImage();
     CreateCSMSet();
 }
 
 ShadowPass::~ShadowPass() {
     if (m_shadowSet != VK_NULL_HANDLE) {
-        vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_shadowSet);
-        vkDestroySampler(VulkanState::GetInstance().GetDevice(), m_sampler, nullptr);
+        vk_util::FreeDescriptorSet(m_shadowSet);
+        SamplerCache::GetInstance().Release(SHADOW_SAMPLER);
     }
 
     m_shadowSet = VK_NULL_HANDLE;
     m_sampler   = VK_NULL_HANDLE;
 
     m_shadowMap        = {};
+    m_staticCache      = {};
     m_shadowAttachment = {};
+    m_staticAttachment = {};
 }
 
 void ShadowPass::CreateRenderingInfo(const RenderingConfig &config, const DrawContent &content) {
@@ -39,29 +58,152 @@ void ShadowPass::CreateRenderingInfo(const RenderingConfig &config, const DrawCo
         .minDepth = 0.f,
         .maxDepth = 1.f
     };
-    m_infoRendering = vk_util::GetRenderingInfo(area, nullptr, &m_shadowAttachment);
-    m_viewport      = viewport;
+    m_infoRendering          = vk_util::GetRenderingInfo(area, nullptr, m_renderingStatic ? &m_staticAttachment : &m_shadowAttachment);
+    m_infoRendering.viewMask = CASCADE_VIEW_MASK;
+    m_viewport               = viewport;
 }
 
 void ShadowPass::DrawCalls(const DrawContent &content, VkPipelineLayout layout) {
-    for (const auto &prefab: content.deferredPrefabs) {
-        prefab.BindAndDrawMesh(layout);
+    const DrawPass pass = m_renderingStatic ? DrawPass::StaticShadow : DrawPass::Shadow;
+
+    content.drawList->Record(pass, content, [&content](const DrawPacket &packet) {
+        if (content.shadowCulling != nullptr) {
+            content.shadowCulling->DrawBatch(packet.batch, 0);
+        } else {
+            content.batches[packet.batch].object->GetMesh()->Draw(packet.range.count, packet.range.first);
+        }
+    });
+}
+
+ShadowUpdate ShadowPass::Update(const LightsData &lights, bool castersMoved, bool staticChanged, bool caching) {
+    bool cascadesMoved = false;
+    for (size_t i = 0; i < CASCADE_COUNT; i++) {
+        cascadesMoved |= lights.cascadeMatrices[i] != m_cascadeMatrices[i];
+        m_cascadeMatrices[i] = lights.cascadeMatrices[i];
+    }
+
+    // Snapped cascades stay put while the camera only moves within a texel, m_cacheValid follows the caching toggle
+    if (m_valid && !cascadesMoved && !castersMoved && !staticChanged && caching == m_cacheValid) {
+        return ShadowUpdate::Skip;
+    }
+    m_valid = true;
+
+    if (!caching) {
+        m_cacheValid = false;
+        return ShadowUpdate::All;
     }
 
-    for (const auto &prefab: content.frontPrefabs) {
-        prefab.BindAndDrawMesh(layout);
+    // The cascades are fitted to the camera, so the cache only outlives frames where the camera stays within a texel
+    if (!m_cacheValid || cascadesMoved || staticChanged) {
+        m_cacheValid = true;
+        return ShadowUpdate::Full;
     }
+    return ShadowUpdate::Dynamic;
+}
+
+void ShadowPass::PreRenderStatic() {
+    m_renderingStatic = true;
+
+    vk_util::CmdImageLayoutTransition(
+        VulkanState::GetInstance().GetCommandBuffer(),
+        m_staticCache.GetImage(),
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        0,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        0,
+        1,
+        0,
+        CASCADE_COUNT
+    );
 }
 
-void ShadowPass::PreRender() {
+void ShadowPass::PostRenderStatic() {
+    m_renderingStatic = false;
+
+    // The cache stays a copy source until it is redrawn
     vk_util::CmdImageLayoutTransition(
         VulkanState::GetInstance().GetCommandBuffer(),
+        m_staticCache.GetImage(),
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        VK_ACCESS_TRANSFER_READ_BIT,
+        0,
+        1,
+        0,
+        CASCADE_COUNT
+    );
+}
+
+void ShadowPass::PreRender(ShadowUpdate update) {
+    const VkCommandBuffer cmdBuf = VulkanState::GetInstance().GetCommandBuffer();
+
+    if (update == ShadowUpdate::All) {
+        m_shadowAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        vk_util::CmdImageLayoutTransition(
+            cmdBuf,
+            m_shadowMap.GetImage(),
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_ASPECT_DEPTH_BIT,
+            0,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            0,
+            1,
+            0,
+            CASCADE_COUNT
+        );
+        return;
+    }
+
+    // Start from the static casters, the dynamic ones are drawn on top
+    m_shadowAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    vk_util::CmdImageLayoutTransition(
+        cmdBuf,
         m_shadowMap.GetImage(),
         VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        0,
+        1,
+        0,
+        CASCADE_COUNT
+    );
+
+    VkImageCopy region{
+        .srcSubresource = vk_util::GetImageSubresourceLayers(VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, CASCADE_COUNT),
+        .srcOffset      = {0, 0, 0},
+        .dstSubresource = vk_util::GetImageSubresourceLayers(VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, CASCADE_COUNT),
+        .dstOffset      = {0, 0, 0},
+        .extent         = {m_extent.width, m_extent.height, 1},
+    };
+    vkCmdCopyImage(
+        cmdBuf,
+        m_staticCache.GetImage(),
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        m_shadowMap.GetImage(),
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &region
+    );
+
+    vk_util::CmdImageLayoutTransition(
+        cmdBuf,
+        m_shadowMap.GetImage(),
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
         VK_IMAGE_ASPECT_DEPTH_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
         0,
-        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+        1,
+        0,
+        CASCADE_COUNT
     );
 }
 
@@ -73,7 +215,11 @@ void ShadowPass::PostRender() {
         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         VK_IMAGE_ASPECT_DEPTH_BIT,
         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-        VK_ACCESS_SHADER_READ_BIT
+        VK_ACCESS_SHADER_READ_BIT,
+        0,
+        1,
+        0,
+        CASCADE_COUNT
     );
 }
 
@@ -84,9 +230,12 @@ void ShadowPass::CreateShadowMapImage() {
 
     VulkanImage shadowMap(
         VK_FORMAT_D32_SFLOAT,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
         {m_extent.width, m_extent.height, 1},
-        VK_IMAGE_ASPECT_DEPTH_BIT
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        VK_SAMPLE_COUNT_1_BIT,
+        1,
+        CASCADE_COUNT
     );
 
     m_shadowMap = std::move(shadowMap);
@@ -101,33 +250,34 @@ void ShadowPass::CreateShadowMapImage() {
         VK_NULL_HANDLE,
         VK_IMAGE_LAYOUT_UNDEFINED
     );
+
+    // Static casters only, copied into the shadow map every frame something dynamic moves
+    VulkanImage staticCache(
+        VK_FORMAT_D32_SFLOAT,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        {m_extent.width, m_extent.height, 1},
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        VK_SAMPLE_COUNT_1_BIT,
+        1,
+        CASCADE_COUNT
+    );
+
+    m_staticCache = std::move(staticCache);
+
+    m_staticAttachment = vk_util::GetRenderingAttachmentInfo(
+        m_staticCache.GetImageView(),
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        &colorClear,
+        VK_ATTACHMENT_LOAD_OP_CLEAR,
+        VK_ATTACHMENT_STORE_OP_STORE,
+        VK_RESOLVE_MODE_NONE,
+        VK_NULL_HANDLE,
+        VK_IMAGE_LAYOUT_UNDEFINED
+    );
 }
 
 void ShadowPass::CreateCSMSet() {
-    {
-        VkSamplerCreateInfo infoSampler = {
-            .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-            .pNext                   = nullptr,
-            .flags                   = 0,
-            .magFilter               = VK_FILTER_NEAREST,
-            .minFilter               = VK_FILTER_NEAREST,
-            .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST,
-            .addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
-            .addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
-            .addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
-            .mipLodBias              = 0.0f,
-            .anisotropyEnable        = VK_FALSE,
-            .maxAnisotropy           = 1.0f,
-            .compareEnable           = VK_TRUE,
-            .compareOp               = VK_COMPARE_OP_GREATER_OR_EQUAL,
-            .minLod                  = 0.0f,
-            .maxLod                  = 1.0f,
-            .borderColor             = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
-            .unnormalizedCoordinates = VK_FALSE, // Always normalized
-        };
-
-        vkCreateSampler(VulkanState::GetInstance().GetDevice(), &infoSampler, nullptr, &m_sampler);
-    }
+    m_sampler = SamplerCache::GetInstance().Acquire(SHADOW_SAMPLER);
 
     m_shadowSet =
         vk_util::CreateDescriptorSet(PipelineManager::GetInstance().Load("lighting_gfx")->GetDescriptorSetLayouts()[descriptor::SHADOW_SET]);
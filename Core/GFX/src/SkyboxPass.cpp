@@ -22,7 +22,7 @@ SkyboxPass::SkyboxPass(const std::string &file, VkDescriptorSetLayout layout) {
 
 SkyboxPass::~SkyboxPass() {
     if (m_textureSet != VK_NULL_HANDLE) {
-        vkFreeDescriptorSets(VulkanState::GetInstance().GetDevice(), VulkanState::GetInstance().GetDescriptorPool(), 1, &m_textureSet);
+        vk_util::FreeDescriptorSet(m_textureSet);
     }
 
     m_textureSet = VK_NULL_HANDLE;
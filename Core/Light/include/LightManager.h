@@ -11,29 +11,42 @@
 #include "Light.h"
 #include "include/Camera.h"
 
-inline constexpr size_t MAX_LIGHT_COUNT = 16;
+inline constexpr size_t   MAX_LIGHT_COUNT       = 4096;
+inline constexpr uint32_t SHADOW_MAP_RESOLUTION = 2048; // Per cascade
 
+static_assert(CASCADE_COUNT == 4, "Cascade splits are packed into a vec4");
+
+// The lights themselves are uploaded separately into the clustered light list
 struct alignas(16) LightsData {
     int32_t                  lightCount = 0;
     [[maybe_unused]] int32_t padding0   = 0;
     [[maybe_unused]] int32_t padding1   = 0;
     [[maybe_unused]] int32_t padding2   = 0;
-    glm::mat4                lightSpaceMatrix;
-    Light                    lights[MAX_LIGHT_COUNT];
+    glm::mat4                cascadeMatrices[CASCADE_COUNT];
+    glm::vec4                cascadeSplits; // Far view space distance of each cascade
 };
 
 class LightManager : public Singleton<LightManager> {
 public:
+    // Fits the shadow cascades to the current camera
     LightsData Update();
 
     void UpdateLight(uint32_t index, Light &light);
 
     void AddLight(LightType type);
 
+    // Scatters point lights with random colors inside the box
+    void AddPointLights(uint32_t count, const glm::vec3 &min, const glm::vec3 &max, float range);
+
     void RemoveLight(size_t index);
 
     [[nodiscard]] size_t GetLightCount() const { return m_lights.size(); }
 
+    [[nodiscard]] const std::vector<Light> &GetLights() const { return m_lights; }
+
+    // Encloses every cascade, shadow casters are culled against it
+    [[nodiscard]] const glm::mat4 &GetShadowCullMatrix() const { return m_shadowCullMatrix; }
+
     [[nodiscard]] const Light &GetLight(size_t index) const {
         DEBUG_ASSERT(index < m_lights.size());
         return m_lights[index];
@@ -46,4 +59,5 @@ protected:
 
 private:
     std::vector<Light> m_lights;
+    glm::mat4          m_shadowCullMatrix = glm::mat4(1.0f);
 };
@@ -1,11 +1,12 @@
 #pragma once
 
+#include <array>
+
 #include <glm/glm.hpp>
 
 #include <include/Camera.h>
 
 namespace light_util {
-glm::mat4 GetLightSpaceMatrix(
-    const glm::vec3                                 &lightDir
-);
+// Orthographic light matrix around the bounding sphere of the corners, snapped to whole texels so edges do not shimmer as the camera moves
+glm::mat4 GetCascadeMatrix(const glm::vec3 &lightDir, const std::array<glm::vec3, FRUSTUM_CORNER_NUM> &corners, float resolution);
 } // namespace light_util
@@ -1,5 +1,7 @@
 #include "include/LightManager.h"
 
+#include <random>
+
 #include <include/LightUtil.h>
 
 namespace {
@@ -17,12 +19,19 @@ LightManager::~LightManager() {
 LightsData LightManager::Update() {
     LightsData data = {};
 
-    data.lightCount = m_lights.size();
-    for (size_t i = 0; i < m_lights.size(); ++i) {
-        data.lights[i] = m_lights[i];
+    data.lightCount = static_cast<int32_t>(m_lights.size());
+
+    const Camera   &camera    = Camera::GetInstance();
+    const glm::vec3 direction = m_lights[DIRECTIONAL_INDEX].direction;
+    const auto      splits    = camera.GetCascadeSplits();
+    for (size_t i = 0; i < CASCADE_COUNT; i++) {
+        data.cascadeMatrices[i] =
+            light_util::GetCascadeMatrix(direction, camera.GetFrustumCorners(splits[i], splits[i + 1]), SHADOW_MAP_RESOLUTION);
+        data.cascadeSplits[static_cast<glm::length_t>(i)] = splits[i + 1];
     }
 
-  data.lightSpaceMatrix = light_util::GetLightSpaceMatrix(m_lights[DIRECTIONAL_INDEX].direction);
+    m_shadowCullMatrix =
+        light_util::GetCascadeMatrix(direction, camera.GetFrustumCorners(splits[0], splits[CASCADE_COUNT]), SHADOW_MAP_RESOLUTION);
 
     return data;
 }
@@ -41,6 +50,20 @@ void LightManager::AddLight(LightType type) {
     m_lights.push_back(light);
 }
 
+void LightManager::AddPointLights(uint32_t count, const glm::vec3 &min, const glm::vec3 &max, float range) {
+    static std::mt19937                   engine(0);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (uint32_t i = 0; i < count && m_lights.size() < MAX_LIGHT_COUNT; i++) {
+        Light light;
+        light.type     = static_cast<uint32_t>(LightType::Point);
+        light.position = glm::mix(min, max, glm::vec3(unit(engine), unit(engine), unit(engine)));
+        light.color    = glm::vec3(unit(engine), unit(engine), unit(engine));
+        light.range    = range;
+        m_lights.push_back(light);
+    }
+}
+
 void LightManager::RemoveLight(size_t index) {
     m_lights.erase(m_lights.begin() + index);
 }
@@ -1,22 +1,43 @@
 #include "include/LightUtil.h"
 
-#include <array>
+#include <cmath>
 
-namespace {} // namespace
+#include <glm/gtc/matrix_transform.hpp>
 
-glm::mat4 light_util::GetLightSpaceMatrix(const glm::vec3 &lightDir) {
-    static constexpr float halfExtent = 2.0f;
-    static constexpr float pullback   = halfExtent * 2.0f;
-    static constexpr float near       = 0.1f;
-    static constexpr float far        = halfExtent * 2.0f + pullback;
+namespace {
+// Casters this far behind a cascade still land in its depth range
+constexpr float CASTER_DISTANCE = 4.0f;
+// The radius only grows in these steps, keeping the texel size stable while the camera turns
+constexpr float RADIUS_STEP = 1.0f / 16.0f;
+} // namespace
 
-    static constexpr glm::vec3 up     = glm::vec3(0.0f, 1.0f, 0.0f);
-    static constexpr glm::vec3 center = glm::vec3(0.0f);
+glm::mat4 light_util::GetCascadeMatrix(const glm::vec3 &lightDir, const std::array<glm::vec3, FRUSTUM_CORNER_NUM> &corners, float resolution) {
+    glm::vec3 center = glm::vec3(0.0f);
+    for (const auto &corner: corners) {
+        center += corner;
+    }
+    center /= static_cast<float>(corners.size());
 
-    glm::vec3 eye = center - lightDir * pullback;
+    float radius = 0.0f;
+    for (const auto &corner: corners) {
+        radius = std::max(radius, glm::length(corner - center));
+    }
+    radius = std::ceil(radius / RADIUS_STEP) * RADIUS_STEP;
 
-    glm::mat4 lightProjection = glm::ortho(-halfExtent, halfExtent, -halfExtent, halfExtent, near, far);
-    glm::mat4 lightView       = glm::lookAt(eye, center, up);
+    const glm::vec3 up = std::abs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+    // Move the center in whole texels across the light's view plane
+    const glm::mat4 rotation    = glm::lookAt(glm::vec3(0.0f), lightDir, up);
+    const float     texelSize   = radius * 2.0f / resolution;
+    glm::vec3       lightCenter = glm::vec3(rotation * glm::vec4(center, 1.0f));
+    lightCenter.x               = std::floor(lightCenter.x / texelSize) * texelSize;
+    lightCenter.y               = std::floor(lightCenter.y / texelSize) * texelSize;
+    center                      = glm::vec3(glm::inverse(rotation) * glm::vec4(lightCenter, 1.0f));
+
+    const glm::vec3 eye = center - lightDir * (radius + CASTER_DISTANCE);
+
+    const glm::mat4 lightProjection = glm::ortho(-radius, radius, -radius, radius, 0.0f, radius * 2.0f + CASTER_DISTANCE);
+    const glm::mat4 lightView       = glm::lookAt(eye, center, up);
 
     return lightProjection * lightView;
 }
@@ -3,6 +3,10 @@
 namespace descriptor {
 inline constexpr uint32_t MAX_SET_COUNT = 1024;
 
+// Set capacity of an allocator's first pool, each chained pool doubles it up to the max
+inline constexpr uint32_t SETS_PER_POOL     = 64;
+inline constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
 inline constexpr uint32_t UNIFORM_SET = 0;
 inline constexpr uint32_t TEXTURE_SET = 1;
 inline constexpr uint32_t IBL_SET = 2;
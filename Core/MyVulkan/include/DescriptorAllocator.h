@@ -0,0 +1,54 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Allocates sets from a chain of pools sized per descriptor type from the reflected set layouts,
+// a larger pool is chained whenever the existing ones are exhausted
+class DescriptorAllocator {
+public:
+    DescriptorAllocator() = default;
+
+    ~DescriptorAllocator() { Destroy(); }
+
+    DescriptorAllocator(const DescriptorAllocator &)            = delete;
+    DescriptorAllocator(DescriptorAllocator &&)                 = delete;
+    DescriptorAllocator &operator=(const DescriptorAllocator &) = delete;
+    DescriptorAllocator &operator=(DescriptorAllocator &&)      = delete;
+
+    void Init(VkDevice device);
+
+    void Destroy();
+
+    // Adds the descriptor counts of a set layout to the per type pool sizes
+    void AddLayout(const VkDescriptorSetLayoutCreateInfo &info);
+
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+
+    void Free(VkDescriptorSet set);
+
+    [[nodiscard]] size_t GetPoolCount() const;
+
+private:
+    VkDevice m_device      = VK_NULL_HANDLE;
+    uint32_t m_setsPerPool = 0;
+
+    // Summed over every added layout, divided by m_layoutCount for the average set
+    std::map<VkDescriptorType, uint32_t> m_typeCounts;
+    uint32_t                             m_layoutCount = 0;
+
+    std::vector<VkDescriptorPool> m_pools;
+    size_t                        m_currentPool = 0;
+
+    std::unordered_map<VkDescriptorSet, VkDescriptorPool> m_setPools;
+
+    mutable std::mutex m_mutex;
+
+    VkDescriptorPool CreatePool();
+
+    VkDescriptorSet TryAllocate(VkDescriptorPool pool, VkDescriptorSetLayout layout);
+};
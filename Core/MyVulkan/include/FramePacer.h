@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+#include <Singleton.h>
+
+#include "PresentSettings.h"
+
+inline constexpr size_t LATENCY_HISTORY = 256;
+
+// Milliseconds, ring buffer
+struct LatencyHistory {
+    std::array<float, LATENCY_HISTORY> samples     = {};
+    size_t                             sampleCount = 0;
+    size_t                             next        = 0;
+
+    void Add(float milliseconds);
+
+    [[nodiscard]] float GetLast() const { return sampleCount == 0 ? 0.0f : samples[(next + LATENCY_HISTORY - 1) % LATENCY_HISTORY]; }
+
+    [[nodiscard]] float GetAverage() const;
+};
+
+// Frame limiting and latency reduction around input polling, with input to present latency measurements
+class FramePacer : public Singleton<FramePacer> {
+public:
+    void Init(const PresentSettings &settings);
+
+    // Called right before input is polled, so the input stays as fresh as possible
+    // Sleeps out the frame limit, then with low latency waits until the last frame is displayed
+    void WaitForNextFrame();
+
+    // Called after VulkanState::EndFrame, pairs the input time with the queued present
+    void EndFrame();
+
+    [[nodiscard]] float GetFrameLimit() const { return m_frameLimit; }
+
+    void SetFrameLimit(float framesPerSecond) { m_frameLimit = framesPerSecond; }
+
+    [[nodiscard]] bool IsLowLatency() const { return m_lowLatency; }
+
+    void SetLowLatency(bool lowLatency) { m_lowLatency = lowLatency; }
+
+    // Until the present call, always measured
+    [[nodiscard]] const LatencyHistory &GetInputToSubmit() const { return m_inputToSubmit; }
+
+    // Until the display, only measured with present wait and sampled once a frame unless waiting for low latency
+    [[nodiscard]] const LatencyHistory &GetInputToPresent() const { return m_inputToPresent; }
+
+protected:
+    FramePacer()  = default;
+    ~FramePacer() = default;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingPresent {
+        uint64_t          presentId = 0;
+        Clock::time_point input;
+    };
+
+    float m_frameLimit = 0.0f;
+    bool  m_lowLatency = false;
+
+    Clock::time_point          m_nextFrame;
+    Clock::time_point          m_inputTime;
+    std::deque<PendingPresent> m_pending; // Oldest first, presents complete in order
+    uint64_t                   m_swapchainGeneration = 0; // Of the swapchain the pending presents went to
+
+    LatencyHistory m_inputToSubmit;
+    LatencyHistory m_inputToPresent;
+
+    void CollectPresented(uint64_t timeout);
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include <Singleton.h>
+
+// Frames between recording a zone and reading it back, the CPU never waits on queries
+inline constexpr uint32_t GPU_PROFILER_FRAME_LATENCY = 3;
+inline constexpr uint32_t MAX_GPU_ZONE_COUNT         = 64; // Per frame
+inline constexpr size_t   GPU_ZONE_HISTORY           = 256;
+inline constexpr uint32_t INVALID_GPU_ZONE           = UINT32_MAX;
+
+enum class PipelineStatistic : uint8_t {
+    InputPrimitives,
+    VertexInvocations,
+    ClippingPrimitives,
+    FragmentInvocations,
+    ComputeInvocations,
+};
+
+inline constexpr size_t PIPELINE_STATISTIC_COUNT = 5;
+
+// Every zone of one name, zones recorded several times a frame are summed
+struct GpuZoneStats {
+    std::string                                    name;
+    std::array<float, GPU_ZONE_HISTORY>            history       = {}; // Milliseconds, ring buffer
+    size_t                                         sampleCount   = 0;
+    size_t                                         next          = 0;
+    std::array<uint64_t, PIPELINE_STATISTIC_COUNT> statistics    = {}; // Of the last read frame
+    bool                                           hasStatistics = false;
+
+    [[nodiscard]] float GetLast() const { return sampleCount == 0 ? 0.0f : history[(next + GPU_ZONE_HISTORY - 1) % GPU_ZONE_HISTORY]; }
+
+    // Rolling average over the history
+    [[nodiscard]] float GetAverage() const;
+
+    // percentile in [0, 1]
+    [[nodiscard]] float GetPercentile(float percentile) const;
+};
+
+// Timestamps and pipeline statistics around named zones of the frame's command buffers
+class GpuProfiler : public Singleton<GpuProfiler> {
+public:
+    void Init();
+
+    void Destroy();
+
+    // Reads back the oldest frame and resets its queries, after the render fence is waited
+    void BeginFrame();
+
+    // Statistics are only gathered for the outermost zone, queries of one type cannot nest
+    // Must be begun and ended on the same side of dynamic rendering
+    uint32_t BeginZone(VkCommandBuffer cmdBuf, const char *name);
+
+    void EndZone(VkCommandBuffer cmdBuf, uint32_t zone);
+
+    [[nodiscard]] const std::vector<GpuZoneStats> &GetZones() const { return m_zones; }
+
+    // Milliseconds from the first zone's start to the last zone's end of the frame read back by the last BeginFrame
+    [[nodiscard]] float GetFrameTime() const { return m_frameTime; }
+
+    [[nodiscard]] bool IsSupported() const { return m_timestampPool != VK_NULL_HANDLE; }
+
+    // One row per zone sample of the history
+    [[nodiscard]] bool ExportCsv(const std::string &path) const;
+
+    // Averages, percentiles and statistics per zone
+    [[nodiscard]] bool ExportJson(const std::string &path) const;
+
+protected:
+    GpuProfiler()  = default;
+    ~GpuProfiler() = default;
+
+private:
+    struct ZoneRecord {
+        const char *name       = nullptr;
+        bool        statistics = false;
+    };
+
+    struct FrameRecord {
+        std::vector<ZoneRecord> zones;
+    };
+
+    VkQueryPool m_timestampPool   = VK_NULL_HANDLE;
+    VkQueryPool m_statisticsPool  = VK_NULL_HANDLE;
+    float       m_timestampPeriod = 1.0f; // Nanoseconds per tick
+    float       m_frameTime       = 0.0f;
+
+    std::array<FrameRecord, GPU_PROFILER_FRAME_LATENCY> m_frames;
+    uint32_t                                            m_frameIndex       = 0;
+    bool                                                m_statisticsActive = false;
+
+    std::vector<GpuZoneStats>               m_zones;
+    std::unordered_map<std::string, size_t> m_zoneIndices;
+
+    void ReadFrame(uint32_t frame);
+    size_t GetZoneIndex(const char *name);
+};
+
+// Profiles the commands recorded during its scope
+class GpuZone {
+public:
+    GpuZone(VkCommandBuffer cmdBuf, const char *name)
+        : m_cmdBuf(cmdBuf), m_zone(GpuProfiler::GetInstance().BeginZone(cmdBuf, name)) {}
+
+    ~GpuZone() { GpuProfiler::GetInstance().EndZone(m_cmdBuf, m_zone); }
+
+    GpuZone(const GpuZone &)            = delete;
+    GpuZone(GpuZone &&)                 = delete;
+    GpuZone &operator=(const GpuZone &) = delete;
+    GpuZone &operator=(GpuZone &&)      = delete;
+
+private:
+    VkCommandBuffer m_cmdBuf = VK_NULL_HANDLE;
+    uint32_t        m_zone   = INVALID_GPU_ZONE;
+};
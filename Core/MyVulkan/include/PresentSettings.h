@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+// How frames reach the display, chosen at launch
+struct PresentSettings {
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR; // Falls back to FIFO when the surface lacks it
+    uint32_t         imageCount  = 2;                        // Clamped to the surface limits, mailbox wants at least 3
+    float            frameLimit  = 0.0f;                     // Frames per second, unlimited when 0
+    bool             lowLatency  = false;                    // Wait for the last frame to be displayed before polling input
+
+    // Picks --present fifo|relaxed|mailbox|immediate, --swapchain-images N, --fps-limit N and --low-latency out of the arguments
+    static PresentSettings FromArgs(int argc, char *argv[]);
+
+    static const char *GetPresentModeName(VkPresentModeKHR presentMode);
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// What a submit waits for before the given stages run
+struct SubmitWait {
+    VkSemaphore          semaphore = VK_NULL_HANDLE;
+    uint64_t             value     = 0; // Ignored for binary semaphores
+    VkPipelineStageFlags stage     = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+};
+
+// A queue and a timeline semaphore that every submit to it signals with the next value,
+// so a value is reached once everything submitted up to it has completed
+// Submits and presents are serialized, threads can share the queue
+class QueueTimeline {
+public:
+    QueueTimeline() = default;
+
+    ~QueueTimeline() { Destroy(); }
+
+    QueueTimeline(const QueueTimeline &)            = delete;
+    QueueTimeline(QueueTimeline &&)                 = delete;
+    QueueTimeline &operator=(const QueueTimeline &) = delete;
+    QueueTimeline &operator=(QueueTimeline &&)      = delete;
+
+    void Init(VkDevice device, VkQueue queue);
+
+    void Destroy();
+
+    // Returns the value signaled once cmdBuf completes, binary signals are for the presentation engine only
+    uint64_t Submit(VkCommandBuffer cmdBuf, const std::vector<SubmitWait> &waits = {}, const std::vector<VkSemaphore> &binarySignals = {});
+
+    // Presents wait on binary semaphores, but go through the queue all the same
+    VkResult Present(const VkPresentInfoKHR &info);
+
+    // Blocks on this queue's progress only, other queues and threads keep going
+    void WaitFor(uint64_t value) const;
+
+    [[nodiscard]] bool IsComplete(uint64_t value) const;
+
+    [[nodiscard]] uint64_t GetCompletedValue() const;
+
+    // Of the last submit, the timeline reaches it once the queue drains
+    [[nodiscard]] uint64_t GetSubmittedValue() const { return m_submitted.load(std::memory_order_acquire); }
+
+    // Waits on another queue's timeline reaching value
+    [[nodiscard]] SubmitWait After(uint64_t value, VkPipelineStageFlags stage) const { return {m_semaphore, value, stage}; }
+
+    [[nodiscard]] bool IsValid() const { return m_semaphore != VK_NULL_HANDLE; }
+
+private:
+    VkDevice    m_device    = VK_NULL_HANDLE;
+    VkQueue     m_queue     = VK_NULL_HANDLE;
+    VkSemaphore m_semaphore = VK_NULL_HANDLE;
+
+    std::atomic<uint64_t>         m_submitted = 0;
+    mutable std::atomic<uint64_t> m_completed = 0; // Last value read back, saves the query for values known to be reached
+
+    std::mutex m_mutex;
+};
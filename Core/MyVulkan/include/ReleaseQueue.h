@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+#include "DescriptorAllocator.h"
+#include "QueueTimeline.h"
+
+inline constexpr size_t RELEASE_QUEUE_CAPACITY = 4096;
+
+// Frames in flight never exceed two, the graphics work of a frame waits for the previous post chain
+inline constexpr size_t RELEASE_FRAME_HISTORY = 4;
+
+// Destroys Vulkan objects once every frame and submit that may still use them has retired
+// Entries are plain handles in a fixed ring, releasing never allocates
+class ReleaseQueue {
+public:
+    ReleaseQueue() = default;
+
+    ReleaseQueue(const ReleaseQueue &)            = delete;
+    ReleaseQueue(ReleaseQueue &&)                 = delete;
+    ReleaseQueue &operator=(const ReleaseQueue &) = delete;
+    ReleaseQueue &operator=(ReleaseQueue &&)      = delete;
+
+    // Missing queues are passed as timelines that were never initialized
+    void Init(
+        VkDevice             device,
+        const QueueTimeline &graphics,
+        const QueueTimeline &compute,
+        const QueueTimeline &transfer,
+        DescriptorAllocator &descriptorAllocator
+    );
+
+    // Descriptor sets go back to the persistent allocator, device memory is freed, everything else destroyed
+    template<class Handle>
+    void Release(VkObjectType type, Handle handle) {
+        if (handle != VK_NULL_HANDLE) {
+            Push(type, reinterpret_cast<uint64_t>(handle));
+        }
+    }
+
+    // A frame started recording, objects released from now on may be in its command buffers
+    void BeginFrame();
+
+    // The frame is submitted, it retires once both values are reached
+    void EndFrame(uint64_t graphicsValue, uint64_t computeValue);
+
+    // Destroys what has retired, oldest first
+    void Collect();
+
+    // Destroys everything, the device has to be idle
+    void Flush();
+
+    [[nodiscard]] size_t GetPendingCount() const;
+
+private:
+    struct Entry {
+        VkObjectType type          = VK_OBJECT_TYPE_UNKNOWN;
+        uint64_t     handle        = 0;
+        uint64_t     frame         = 0; // Frames begun when released, the last one may still be recording
+        uint64_t     graphicsValue = 0; // Submitted to each queue when released
+        uint64_t     computeValue  = 0;
+        uint64_t     transferValue = 0;
+    };
+
+    struct FrameValues {
+        uint64_t graphics = 0;
+        uint64_t compute  = 0;
+    };
+
+    VkDevice             m_device              = VK_NULL_HANDLE;
+    const QueueTimeline *m_graphics            = nullptr;
+    const QueueTimeline *m_compute             = nullptr;
+    const QueueTimeline *m_transfer            = nullptr;
+    DescriptorAllocator *m_descriptorAllocator = nullptr;
+
+    std::array<Entry, RELEASE_QUEUE_CAPACITY> m_entries;
+    size_t                                    m_first = 0;
+    size_t                                    m_count = 0;
+
+    std::array<FrameValues, RELEASE_FRAME_HISTORY> m_frames;
+    uint64_t                                       m_begunFrames     = 0;
+    uint64_t                                       m_submittedFrames = 0;
+
+    mutable std::mutex m_mutex;
+
+    void Push(VkObjectType type, uint64_t handle);
+
+    void CollectLocked();
+
+    [[nodiscard]] bool IsRetired(const Entry &entry) const;
+
+    void Destroy(const Entry &entry);
+};
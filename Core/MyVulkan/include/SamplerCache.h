@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include <Singleton.h>
+
+// Key of a shared sampler, unnormalized coordinates are never used
+struct SamplerConfig {
+    VkFilter             filter           = VK_FILTER_LINEAR;
+    VkSamplerMipmapMode  mipmapMode       = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    VkSamplerAddressMode addressMode      = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkBool32             anisotropyEnable = VK_FALSE;
+    float                maxAnisotropy    = 1.0f;
+    VkBool32             compareEnable    = VK_FALSE;
+    VkCompareOp          compareOp        = VK_COMPARE_OP_ALWAYS;
+    float                minLod           = 0.0f;
+    float                maxLod           = VK_LOD_CLAMP_NONE;
+    VkBorderColor        borderColor      = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    bool operator==(const SamplerConfig &) const = default;
+};
+
+struct SamplerConfigHash {
+    size_t operator()(const SamplerConfig &config) const;
+};
+
+// Hands out one reference counted sampler per distinct config
+class SamplerCache : public Singleton<SamplerCache> {
+public:
+    // Every acquire must be paired with a release of an equal config
+    VkSampler Acquire(const SamplerConfig &config);
+
+    // Hands the sampler to the release queue once its last user releases it
+    void Release(const SamplerConfig &config);
+
+    [[nodiscard]] size_t GetSamplerCount() const;
+
+protected:
+    SamplerCache()  = default;
+    ~SamplerCache() = default;
+
+private:
+    struct Entry {
+        VkSampler sampler  = VK_NULL_HANDLE;
+        uint32_t  refCount = 0;
+    };
+
+    std::unordered_map<SamplerConfig, Entry, SamplerConfigHash> m_samplers;
+    mutable std::mutex                                          m_mutex;
+
+    static VkSampler CreateSampler(const SamplerConfig &config);
+};
@@ -30,6 +30,8 @@ public:
 
     void Upload(size_t size, const void *data);
 
+    void Download(size_t size, void *data) const;
+
     [[nodiscard]] const VkBuffer &GetBuffer() const { return m_buffer; }
 
 private:
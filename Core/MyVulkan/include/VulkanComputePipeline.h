@@ -7,8 +7,12 @@ class VulkanComputePipeline : public VulkanPipeline {
 public:
     VulkanComputePipeline() = delete;
 
-    explicit VulkanComputePipeline(const std::vector<std::string> &paths)
-        : VulkanPipeline(paths) {
+    explicit VulkanComputePipeline(
+        const ShaderCompiler                       &shaderCompiler,
+        std::shared_ptr<const VulkanPipelineLayout> pipelineLayout = nullptr,
+        uint32_t                                    id             = 0
+    )
+        : VulkanPipeline(shaderCompiler, std::move(pipelineLayout), id) {
         CreatePipeline();
     }
 
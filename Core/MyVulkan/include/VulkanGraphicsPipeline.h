@@ -17,6 +17,9 @@ struct GraphicsPipelineOption {
 
     std::vector<VkFormat> colorFormats{};
 
+    // Multiview, one bit per rendered layer
+    uint32_t viewMask = 0;
+
     // Depth stencil
     VkBool32    depthTestEnable  = VK_FALSE;
     VkBool32    depthWriteEnable = VK_FALSE;
@@ -38,8 +41,13 @@ class VulkanGraphicsPipeline : public VulkanPipeline {
 public:
     VulkanGraphicsPipeline() = delete;
 
-    VulkanGraphicsPipeline(const std::vector<std::string> &paths, const GraphicsPipelineOption &option)
-        : VulkanPipeline(paths) {
+    VulkanGraphicsPipeline(
+        const ShaderCompiler                       &shaderCompiler,
+        const GraphicsPipelineOption               &option,
+        std::shared_ptr<const VulkanPipelineLayout> pipelineLayout = nullptr,
+        uint32_t                                    id             = 0
+    )
+        : VulkanPipeline(shaderCompiler, std::move(pipelineLayout), id) {
         CreatePipeline(option);
     }
 
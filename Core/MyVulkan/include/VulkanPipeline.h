@@ -1,10 +1,41 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <include/ShaderCompiler.h>
 
+// Descriptor set layouts and the pipeline layout, shared by a pipeline and its reloads
+// Descriptor sets allocated from the first build stay valid for every later one
+class VulkanPipelineLayout {
+public:
+    explicit VulkanPipelineLayout(const ShaderCompiler &shaderCompiler);
+
+    ~VulkanPipelineLayout();
+
+    VulkanPipelineLayout(const VulkanPipelineLayout &)            = delete;
+    VulkanPipelineLayout(VulkanPipelineLayout &&)                 = delete;
+    VulkanPipelineLayout &operator=(const VulkanPipelineLayout &) = delete;
+    VulkanPipelineLayout &operator=(VulkanPipelineLayout &&)      = delete;
+
+    [[nodiscard]] const std::vector<VkDescriptorSetLayout> &GetDescriptorSetLayouts() const { return m_descriptorSetLayouts; };
+
+    [[nodiscard]] const VkPipelineLayout &GetLayout() const { return m_layout; };
+
+    // The reflected descriptor sets and push constants match, so shaders compiled by it can use this layout
+    [[nodiscard]] bool IsCompatible(const ShaderCompiler &shaderCompiler) const;
+
+private:
+    VkPipelineLayout                                       m_layout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSetLayout>                     m_descriptorSetLayouts;
+    std::vector<std::vector<VkDescriptorSetLayoutBinding>> m_descriptorSetBindings;
+    std::vector<VkPushConstantRange>                       m_pushConstantRanges;
+
+    void CreateDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutCreateInfo> &infos);
+    void CreateLayout();
+};
+
 class VulkanPipeline {
 public:
     VulkanPipeline(const VulkanPipeline &)            = delete;
@@ -14,28 +45,33 @@ public:
 
     virtual ~VulkanPipeline() { Destroy(); };
 
-    [[nodiscard]] const std::vector<VkDescriptorSetLayout> &GetDescriptorSetLayouts() const { return m_descriptorSetLayouts; };
+    [[nodiscard]] const std::vector<VkDescriptorSetLayout> &GetDescriptorSetLayouts() const { return m_pipelineLayout->GetDescriptorSetLayouts(); };
 
     [[nodiscard]] const VkPipeline &GetPipeline() const { return m_pipeline; };
 
     [[nodiscard]] const VkPipelineLayout &GetLayout() const { return m_layout; };
 
+    [[nodiscard]] const std::shared_ptr<const VulkanPipelineLayout> &GetPipelineLayout() const { return m_pipelineLayout; };
+
+    // Unique per pipeline, 0 is never used
+    [[nodiscard]] uint32_t GetId() const { return m_id; };
+
 protected:
     VulkanPipeline() = default;
 
-    VulkanPipeline(const std::vector<std::string> &paths);
+    // Without a layout one is created from the reflected sets and a new id picked
+    // Reloads pass the layout and id of the pipeline they replace, the layout has to be compatible
+    VulkanPipeline(const ShaderCompiler &shaderCompiler, std::shared_ptr<const VulkanPipelineLayout> pipelineLayout, uint32_t id);
 
     void Destroy();
 
-    VkPipelineLayout                                m_layout   = VK_NULL_HANDLE;
+    uint32_t                                        m_id       = 0;
+    VkPipelineLayout                                m_layout   = VK_NULL_HANDLE; // Owned by m_pipelineLayout
     VkPipeline                                      m_pipeline = VK_NULL_HANDLE;
     std::map<VkShaderStageFlagBits, VkShaderModule> m_shaderModules;
 
-    std::vector<VkDescriptorSetLayout> m_descriptorSetLayouts;
-    std::vector<VkPushConstantRange>   m_pushConstantRanges;
+    std::shared_ptr<const VulkanPipelineLayout> m_pipelineLayout;
 
-    void                                         CreateLayout();
     void                                         CreateShaderModules(const ShaderCompiler &shaderCompiler);
-    void                                         CreateDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutCreateInfo> &infos);
     std::vector<VkPipelineShaderStageCreateInfo> CreateShaderStages();
 };
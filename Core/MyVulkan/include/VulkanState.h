@@ -1,10 +1,12 @@
 #pragma once
 
+#include <array>
 #include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -12,12 +14,17 @@
 #include <Singleton.h>
 #include <include/VulkanPrefab.h>
 
+#include "DescriptorAllocator.h"
+#include "PresentSettings.h"
+#include "QueueTimeline.h"
+#include "ReleaseQueue.h"
 #include "VulkanImage.h"
 
 inline constexpr size_t MIN_SWAPCHAIN_IMG_COUNT = 2;
 inline constexpr size_t MAX_SWAPCHAIN_IMG_COUNT = 16;
 
-inline constexpr uint32_t POINT_ONE_SECOND = 100000000;
+// The async post chain waits on the acquire semaphore while the next frame already acquires
+inline constexpr size_t ACQUIRE_SEMAPHORE_COUNT = 2;
 
 struct VulkanSwapchain {
     VkSwapchainKHR swapchain                       = VK_NULL_HANDLE;
@@ -26,6 +33,12 @@ struct VulkanSwapchain {
     uint32_t       count                           = 0;
 };
 
+// Picked at device creation, the transfer family is the graphics one when the device has no dedicated family for it
+struct QueueFamilies {
+    uint32_t graphics = 0;
+    uint32_t transfer = 0;
+};
+
 struct DeletionQueue {
     std::deque<std::function<void()>> deletors;
 
@@ -43,24 +56,65 @@ struct DeletionQueue {
 
 class VulkanState : public Singleton<VulkanState> {
 public:
-    void Init();
+    void Init(const PresentSettings &settings = {});
+
+    // No window, surface or swapchain, frames go to a single offscreen image instead
+    void InitHeadless(uint32_t width, uint32_t height);
 
+    // Drains every queue, only for shutdown, frame and upload paths wait on their own timeline values
     void WaitIdle();
-    void BeginFrame();
+
+    // False when there is nothing to render into, the window is minimized or the swapchain could not be recreated
+    // The frame is skipped then, no command buffer is begun
+    bool BeginFrame();
     void EndFrame();
-    void CopyToPresentImage(const VulkanImage &image);
 
+    // Recreates the swapchain at this size before the next frame, 0 while the window is minimized
+    void Resize(uint32_t width, uint32_t height);
+
+    // Bumped on every swapchain recreation, size dependent resources compare it against the one they were made for
+    [[nodiscard]] uint64_t GetSwapchainGeneration() const { return m_swapchainGeneration; }
+
+    // Waits for the last frame's graphics work and its async post chain, without stalling uploads on other queues
+    void WaitForLastFrame();
+
+    // True once the present with this id is displayed, false on timeout
+    [[nodiscard]] bool WaitForPresent(uint64_t presentId, uint64_t timeout) const;
+
+    // Begins this frame's async compute command buffer, submitted after the graphics work so it overlaps the next frame
+    // Expects the recorded work to write the swapchain image and leave it in present layout
+    VkCommandBuffer BeginAsyncCompute();
+
+    // Waits for its own graphics timeline value only, frames in flight before it are the one thing it can block on
+    // Records from the upload pool, so loading threads can call it while the render thread records frames
     template<class Func>
     void ImmediateSubmit(Func &&func) {
-        std::scoped_lock<std::mutex> lock(m_mutex);
-        DEBUG_VK_ASSERT(vkResetCommandBuffer(m_immediateCmdBuf, 0));
-
-        BeginCommandBuffer(m_immediateCmdBuf, 0);
-        func(m_immediateCmdBuf);
-        EndAndSubmitCommandBuffer(m_immediateCmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_immediateFence, VK_NULL_HANDLE, VK_NULL_HANDLE);
-        WaitAndResetFence(m_immediateFence);
+        uint64_t value = 0;
+        {
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            UploadCommands              &commands = AcquireUploadCommands();
+
+            BeginCommandBuffer(commands.graphics, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            func(commands.graphics);
+            DEBUG_VK_ASSERT(vkEndCommandBuffer(commands.graphics));
+            value = commands.value = m_graphicsTimeline.Submit(commands.graphics);
+        }
+        m_graphicsTimeline.WaitFor(value);
     }
 
+    // Records copies on the dedicated transfer queue, then acquires what they wrote on the graphics queue and records use there
+    // The barriers describe the hand over from the copies to their first use, queue family indices are filled in here
+    // Without a transfer queue everything is one graphics submit and the barriers only order the copies before use
+    // Never blocks on the GPU, returns the graphics value the upload completes at. Frames submitted after the call are
+    // ordered behind it on the graphics queue, work on other queues has to wait for the value
+    uint64_t UploadSubmit(
+        const std::function<void(VkCommandBuffer)> &copy,
+        std::vector<VkBufferMemoryBarrier>          bufferBarriers,
+        std::vector<VkImageMemoryBarrier>           imageBarriers,
+        VkPipelineStageFlags                        dstStage,
+        const std::function<void(VkCommandBuffer)> &use = {}
+    );
+
     [[nodiscard]] const VkPhysicalDevice &GetPhysicalDevice() const { return m_physicalDevice; };
 
     [[nodiscard]] const VkDevice &GetDevice() const { return m_device; };
@@ -69,14 +123,57 @@ public:
 
     [[nodiscard]] const VkCommandBuffer &GetCommandBuffer() const { return m_cmdBuf; };
 
-    [[nodiscard]] const VkDescriptorPool &GetDescriptorPool() const { return m_descriptorPool; }
+    // Sets live until they are freed, passes rewrite theirs in place when what they bind changes
+    [[nodiscard]] DescriptorAllocator &GetDescriptorAllocator() { return m_descriptorAllocator; }
+
+    // Objects that recorded frames or submits may still use are destroyed through this
+    [[nodiscard]] ReleaseQueue &GetReleaseQueue() { return m_releaseQueue; }
+
+    // Sizes the allocator's pools for sets of this layout
+    void AddDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo &info);
 
     [[nodiscard]] const VkQueue &GetQueue() const { return m_queue; };
 
+    [[nodiscard]] uint32_t GetGraphicsFamily() const { return m_queueFamilies.graphics; }
+
+    // Graphics progress, resources used by a frame can be released once its value is reached
+    [[nodiscard]] const QueueTimeline &GetGraphicsTimeline() const { return m_graphicsTimeline; }
+
+    // Graphics value of the last submitted frame
+    [[nodiscard]] uint64_t GetFrameValue() const { return m_frameValue; }
+
+    // A queue of a family without graphics, uploads go through the graphics queue when missing
+    [[nodiscard]] bool HasTransferQueue() const { return m_transferQueue != VK_NULL_HANDLE; }
+
+    // A second queue of the graphics family, missing when the family exposes only one
+    [[nodiscard]] bool HasAsyncCompute() const { return m_computeQueue != VK_NULL_HANDLE; }
+
+    [[nodiscard]] bool HasPipelineStatistics() const { return m_pipelineStatistics; }
+
+    [[nodiscard]] bool IsHeadless() const { return m_headless; }
+
+    // VK_KHR_present_wait, every present then carries an id
+    [[nodiscard]] bool HasPresentWait() const { return m_waitForPresent != nullptr; }
+
+    [[nodiscard]] uint64_t GetLastPresentId() const { return m_presentId; }
+
+    [[nodiscard]] VkPresentModeKHR GetPresentMode() const { return m_presentMode; }
+
+    // Layout the post chain leaves the present image in, headless frames are read back with transfers
+    [[nodiscard]] VkImageLayout GetPresentLayout() const {
+        return m_headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    }
+
     [[nodiscard]] const VkImageView &GetPresentImageView() const { return m_swapchain.views[m_presentImageIndex]; }
 
     [[nodiscard]] const VkImage &GetPresentImage() const { return m_swapchain.images[m_presentImageIndex]; }
 
+    [[nodiscard]] uint32_t GetPresentImageIndex() const { return m_presentImageIndex; }
+
+    [[nodiscard]] uint32_t GetSwapchainImageCount() const { return m_swapchain.count; }
+
+    [[nodiscard]] const VkImageView &GetSwapchainImageView(uint32_t index) const { return m_swapchain.views[index]; }
+
     [[nodiscard]] uint32_t GetWidth() const { return m_width; }
 
     [[nodiscard]] uint32_t GetHeight() const { return m_height; }
@@ -93,22 +190,64 @@ private:
     VkQueue          m_queue          = VK_NULL_HANDLE;
     VkCommandPool    m_commandPool    = VK_NULL_HANDLE;
     VkSurfaceKHR     m_surface        = VK_NULL_HANDLE;
+    QueueFamilies    m_queueFamilies;
 
-    VulkanSwapchain m_swapchain;
-    uint32_t        m_presentImageIndex = 0;
-
-    VkFence         m_renderFence      = VK_NULL_HANDLE;
-    VkSemaphore     m_renderSemaphore  = VK_NULL_HANDLE;
-    VkSemaphore     m_presentSemaphore = VK_NULL_HANDLE;
-    VkCommandBuffer m_cmdBuf           = VK_NULL_HANDLE;
-
-    VkCommandBuffer m_immediateCmdBuf = VK_NULL_HANDLE;
-    VkFence         m_immediateFence  = VK_NULL_HANDLE;
+    bool m_pipelineStatistics = false;
 
-    VkDescriptorPool m_descriptorPool      = VK_NULL_HANDLE;
-    VkDescriptorPool m_imguiDescriptorPool = VK_NULL_HANDLE;
-
-    DeletionQueue m_deletionQueue;
+    VulkanSwapchain m_swapchain;
+    uint32_t        m_presentImageIndex   = 0;
+    uint64_t        m_swapchainGeneration = 0;
+    bool            m_swapchainDirty      = false; // Out of date or resized, recreated before the next acquire
+    uint32_t        m_requestedWidth      = 0;
+    uint32_t        m_requestedHeight     = 0;
+    bool            m_headless            = false;
+    VulkanImage     m_offscreenImage; // Stands in for the swapchain when headless
+
+    PresentSettings         m_presentSettings;
+    VkPresentModeKHR        m_presentMode    = VK_PRESENT_MODE_FIFO_KHR; // The mode in use, the requested one may be unsupported
+    uint64_t                m_presentId      = 0;                        // Of the last present, ids start at 1
+    PFN_vkWaitForPresentKHR m_waitForPresent = nullptr;                  // Extension entry points are not exported by the loader
+
+    // Binary, the presentation engine does not take timeline semaphores
+    // An acquire semaphore is reused once the submit that waited on it, graphics or the async post chain, has run
+    struct AcquireSemaphore {
+        VkSemaphore          semaphore = VK_NULL_HANDLE;
+        const QueueTimeline *waiter    = nullptr;
+        uint64_t             value     = 0;
+    };
+
+    VkSemaphore                                           m_renderSemaphore = VK_NULL_HANDLE;
+    std::array<AcquireSemaphore, ACQUIRE_SEMAPHORE_COUNT> m_acquireSemaphores;
+    size_t                                                m_acquireIndex = 0;
+    VkCommandBuffer                                       m_cmdBuf       = VK_NULL_HANDLE;
+    QueueTimeline   m_graphicsTimeline;
+    uint64_t        m_frameValue = 0; // Graphics work of the last frame is done
+
+    // Command buffers of one upload, reusable once the graphics side retires since it waited for the transfer side
+    struct UploadCommands {
+        VkCommandBuffer graphics = VK_NULL_HANDLE;
+        VkCommandBuffer transfer = VK_NULL_HANDLE; // Only with a transfer queue
+        uint64_t        value    = 0;              // Graphics value of its last submit
+    };
+
+    VkCommandPool               m_uploadCommandPool = VK_NULL_HANDLE; // Graphics family, frames record from m_commandPool
+    std::vector<UploadCommands> m_uploads;                            // Guarded by m_mutex like both upload pools
+
+    VkQueue       m_transferQueue       = VK_NULL_HANDLE;
+    VkCommandPool m_transferCommandPool = VK_NULL_HANDLE;
+    QueueTimeline m_transferTimeline;
+
+    VkQueue         m_computeQueue      = VK_NULL_HANDLE;
+    VkCommandBuffer m_computeCmdBuf     = VK_NULL_HANDLE;
+    QueueTimeline   m_computeTimeline;
+    uint64_t        m_postValue         = 0; // The last async post chain no longer reads the scene images
+    bool            m_asyncComputeFrame = false;
+
+    DescriptorAllocator m_descriptorAllocator;
+    VkDescriptorPool    m_imguiDescriptorPool = VK_NULL_HANDLE;
+
+    ReleaseQueue  m_releaseQueue;  // Objects released while running
+    DeletionQueue m_deletionQueue; // Objects living as long as the device, torn down in reverse creation order
 
     SDL_Window *m_window = nullptr;
     uint32_t    m_width;
@@ -122,33 +261,43 @@ private:
 
     void CreateDevice();
 
+    [[nodiscard]] QueueFamilies ChooseQueueFamilies() const;
+
     void CreateCommandPool();
 
     void CreateSurface(SDL_Window *window);
 
-    void CreateSwapchain(uint32_t width, uint32_t height);
+    void CreateSwapchain(uint32_t width, uint32_t height, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
 
-    void CreateCommandBuffer();
+    // Waits for the last frame, hands the old swapchain over to the new one and destroys it, false at zero size
+    bool RecreateSwapchain();
 
-    VkSemaphore CreateSemaphore();
+    // The surface's current extent, or the requested size clamped to its limits when the surface leaves it to the swapchain
+    [[nodiscard]] VkExtent2D ChooseSwapchainExtent() const;
 
-    VkFence CreateFence(VkFenceCreateFlags flag);
+    void DestroySwapchainViews();
 
-    void CreateDescriptorPool();
+    [[nodiscard]] VkPresentModeKHR ChoosePresentMode() const;
 
-    void WaitAndResetFence(VkFence fence, uint64_t timeout = POINT_ONE_SECOND);
+    [[nodiscard]] bool SupportsPresentWait() const;
 
-    static void BeginCommandBuffer(VkCommandBuffer cmdBuf, VkCommandBufferUsageFlags flag);
+    void CreateOffscreenTarget(uint32_t width, uint32_t height);
 
-    void EndAndSubmitCommandBuffer(
-        VkCommandBuffer      cmdBuf,
-        VkPipelineStageFlags waitStageMask,
-        VkFence              fence,
-        VkSemaphore          waitSemaphore,
-        VkSemaphore          signalSemaphore
-    );
+    void CreateSyncObjects();
+
+    void CreateCommandBuffer();
+
+    // Resets the command buffers of a retired upload or allocates new ones, m_mutex has to be held
+    UploadCommands &AcquireUploadCommands();
+
+    VkSemaphore CreateSemaphore();
+
+    void CreateDescriptorPools();
+
+    static void BeginCommandBuffer(VkCommandBuffer cmdBuf, VkCommandBufferUsageFlags flag);
 
     void QueuePresent(VkSemaphore waitSemaphore);
 
-    void AcquireNextImage();
+    // False when the swapchain is out of date, nothing is acquired then
+    bool AcquireNextImage();
 };
@@ -4,6 +4,7 @@
 #include <vulkan/vulkan_core.h>
 
 namespace vk_util {
+// Stages are derived from the access masks, a source access of 0 only orders after work in the stages of the destination access
 void CmdImageLayoutTransition(
     VkCommandBuffer    cmdBuf,
     VkImage            image,
@@ -18,6 +19,14 @@ void CmdImageLayoutTransition(
     uint32_t           arrayLayers = 1
 );
 
+void CmdMemoryBarrier(
+    VkCommandBuffer      cmdBuf,
+    VkPipelineStageFlags srcStage,
+    VkPipelineStageFlags dstStage,
+    VkAccessFlags        srcAccess,
+    VkAccessFlags        dstAccess
+);
+
 VkImageSubresourceRange GetSubresourceRange(
     VkImageAspectFlags aspect,
     uint32_t           baseLevel  = 0,
@@ -72,5 +81,12 @@ VkRenderingInfo GetRenderingInfo(
 
 VkDescriptorSet CreateDescriptorSet(const VkDescriptorSetLayout &layout);
 
+// Goes back to the allocator once the frames that may have bound it retired
+void FreeDescriptorSet(VkDescriptorSet set);
+
 void CmdBlitMipmap(VkCommandBuffer cmdBuf, VkImage image, VkExtent3D srcExtent, VkExtent3D dstExtent, VkImageAspectFlags aspect, uint32_t baseLevel);
+
+// Size to allocate a window sized target at, passes then draw into its top left required extent
+// Keeps the current size while it fits and is not mostly unused, so dragging the window edge does not reallocate every frame
+VkExtent2D GetTargetExtent(VkExtent2D current, VkExtent2D required);
 } // namespace vk_util
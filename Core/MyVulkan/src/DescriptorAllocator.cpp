@@ -0,0 +1,146 @@
+#include "include/DescriptorAllocator.h"
+
+#include <algorithm>
+
+#include <Debug.h>
+
+#include "include/Descriptor.h"
+
+namespace {
+// Types every pool holds some of, even before a layout using them is added
+constexpr VkDescriptorType BASE_TYPES[] = {
+    VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+    VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+};
+} // namespace
+
+void DescriptorAllocator::Init(VkDevice device) {
+    m_device      = device;
+    m_setsPerPool = descriptor::SETS_PER_POOL;
+}
+
+void DescriptorAllocator::Destroy() {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+
+    for (const auto pool: m_pools) {
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+    }
+
+    m_pools.clear();
+    m_setPools.clear();
+    m_currentPool = 0;
+}
+
+void DescriptorAllocator::AddLayout(const VkDescriptorSetLayoutCreateInfo &info) {
+    // Update after bind layouts need their own pools
+    if (info.flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT) {
+        return;
+    }
+
+    std::scoped_lock<std::mutex> lk(m_mutex);
+
+    for (uint32_t i = 0; i < info.bindingCount; i++) {
+        m_typeCounts[info.pBindings[i].descriptorType] += info.pBindings[i].descriptorCount;
+    }
+    m_layoutCount++;
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(VkDescriptorSetLayout layout) {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+
+    // Pools before the current one were exhausted, freed sets are only reused once every later pool is full as well
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    for (; m_currentPool < m_pools.size(); m_currentPool++) {
+        set = TryAllocate(m_pools[m_currentPool], layout);
+        if (set != VK_NULL_HANDLE) {
+            break;
+        }
+    }
+    if (set == VK_NULL_HANDLE) {
+        for (m_currentPool = 0; m_currentPool < m_pools.size(); m_currentPool++) {
+            set = TryAllocate(m_pools[m_currentPool], layout);
+            if (set != VK_NULL_HANDLE) {
+                break;
+            }
+        }
+    }
+    if (set == VK_NULL_HANDLE) {
+        m_pools.push_back(CreatePool());
+        m_currentPool = m_pools.size() - 1;
+        set           = TryAllocate(m_pools[m_currentPool], layout);
+        DEBUG_ASSERT_LOG(set != VK_NULL_HANDLE, "A single descriptor set does not fit in a new pool");
+    }
+
+    m_setPools.emplace(set, m_pools[m_currentPool]);
+    return set;
+}
+
+void DescriptorAllocator::Free(VkDescriptorSet set) {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+
+    auto pair = m_setPools.find(set);
+    DEBUG_ASSERT(pair != m_setPools.end());
+
+    DEBUG_VK_ASSERT(vkFreeDescriptorSets(m_device, pair->second, 1, &set));
+    m_setPools.erase(pair);
+}
+
+size_t DescriptorAllocator::GetPoolCount() const {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+    return m_pools.size();
+}
+
+VkDescriptorPool DescriptorAllocator::CreatePool() {
+    std::map<VkDescriptorType, uint32_t> typeCounts;
+    for (const auto type: BASE_TYPES) {
+        typeCounts[type] = m_setsPerPool;
+    }
+    // Enough descriptors of each type for m_setsPerPool average sets
+    const uint32_t layoutCount = std::max(m_layoutCount, 1u);
+    for (const auto &[type, count]: m_typeCounts) {
+        typeCounts[type] = std::max(typeCounts[type], (count * m_setsPerPool + layoutCount - 1) / layoutCount);
+    }
+
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    for (const auto &[type, count]: typeCounts) {
+        poolSizes.push_back({.type = type, .descriptorCount = count});
+    }
+
+    VkDescriptorPoolCreateInfo infoPool{
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext         = nullptr,
+        .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+        .maxSets       = m_setsPerPool,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes    = poolSizes.data(),
+    };
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    DEBUG_VK_ASSERT(vkCreateDescriptorPool(m_device, &infoPool, nullptr, &pool));
+
+    // Each chained pool is larger than the last
+    m_setsPerPool = std::min(m_setsPerPool * 2, descriptor::MAX_SETS_PER_POOL);
+
+    return pool;
+}
+
+VkDescriptorSet DescriptorAllocator::TryAllocate(VkDescriptorPool pool, VkDescriptorSetLayout layout) {
+    VkDescriptorSetAllocateInfo infoSet{
+        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext              = nullptr,
+        .descriptorPool     = pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts        = &layout,
+    };
+
+    VkDescriptorSet set    = VK_NULL_HANDLE;
+    const VkResult  result = vkAllocateDescriptorSets(m_device, &infoSet, &set);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        return VK_NULL_HANDLE;
+    }
+    DEBUG_VK_ASSERT(result);
+
+    return set;
+}
@@ -0,0 +1,110 @@
+#include "include/FramePacer.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+#include <include/CpuProfiler.h>
+
+#include "include/VulkanState.h"
+
+namespace {
+// Sleeps overshoot by up to a scheduler tick, so the last stretch is spun
+constexpr std::chrono::microseconds SPIN_TIME(1000);
+
+// A frame that takes longer than this to reach the display is not waited for any further
+constexpr uint64_t PRESENT_WAIT_TIMEOUT = 100000000; // Nanoseconds
+
+// Presents a driver never reports on are dropped past this
+constexpr size_t MAX_PENDING_PRESENTS = 8;
+
+float ToMilliseconds(std::chrono::steady_clock::duration duration) { return std::chrono::duration<float, std::milli>(duration).count(); }
+} // namespace
+
+void LatencyHistory::Add(float milliseconds) {
+    samples[next] = milliseconds;
+    next          = (next + 1) % LATENCY_HISTORY;
+    sampleCount   = std::min(sampleCount + 1, LATENCY_HISTORY);
+}
+
+float LatencyHistory::GetAverage() const {
+    if (sampleCount == 0) {
+        return 0.0f;
+    }
+    return std::accumulate(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(sampleCount), 0.0f) / static_cast<float>(sampleCount);
+}
+
+void FramePacer::Init(const PresentSettings &settings) {
+    m_frameLimit = settings.frameLimit;
+    m_lowLatency = settings.lowLatency;
+    m_nextFrame  = Clock::now();
+    m_inputTime  = m_nextFrame;
+}
+
+void FramePacer::WaitForNextFrame() {
+    PROFILE_ZONE("FramePacer::WaitForNextFrame");
+
+    if (m_frameLimit > 0.0f) {
+        const auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_frameLimit));
+
+        // A frame that ran long moves the schedule instead of letting the next ones catch up in a burst
+        const Clock::time_point now = Clock::now();
+        if (m_nextFrame + interval < now) {
+            m_nextFrame = now;
+        }
+        if (m_nextFrame - now > SPIN_TIME) {
+            std::this_thread::sleep_until(m_nextFrame - SPIN_TIME);
+        }
+        while (Clock::now() < m_nextFrame) {
+            std::this_thread::yield();
+        }
+        m_nextFrame += interval;
+    }
+
+    if (m_lowLatency) {
+        if (VulkanState::GetInstance().HasPresentWait()) {
+            CollectPresented(PRESENT_WAIT_TIMEOUT);
+        } else {
+            // Without present wait the GPU finishing the last frame is the closest point available
+            VulkanState::GetInstance().WaitForLastFrame();
+        }
+    }
+    CollectPresented(0);
+
+    m_inputTime = Clock::now();
+}
+
+void FramePacer::EndFrame() {
+    m_inputToSubmit.Add(ToMilliseconds(Clock::now() - m_inputTime));
+
+    if (!VulkanState::GetInstance().HasPresentWait()) {
+        return;
+    }
+
+    // Ids presented to a retired swapchain are never reported by the new one
+    if (m_swapchainGeneration != VulkanState::GetInstance().GetSwapchainGeneration()) {
+        m_swapchainGeneration = VulkanState::GetInstance().GetSwapchainGeneration();
+        m_pending.clear();
+    }
+    m_pending.push_back({VulkanState::GetInstance().GetLastPresentId(), m_inputTime});
+    if (m_pending.size() > MAX_PENDING_PRESENTS) {
+        m_pending.pop_front();
+    }
+}
+
+void FramePacer::CollectPresented(uint64_t timeout) {
+    if (m_pending.empty()) {
+        return;
+    }
+
+    // Waiting for the newest present covers every older one
+    if (timeout > 0 && !VulkanState::GetInstance().WaitForPresent(m_pending.back().presentId, timeout)) {
+        return;
+    }
+
+    const Clock::time_point now = Clock::now();
+    while (!m_pending.empty() && VulkanState::GetInstance().WaitForPresent(m_pending.front().presentId, 0)) {
+        m_inputToPresent.Add(ToMilliseconds(now - m_pending.front().input));
+        m_pending.pop_front();
+    }
+}
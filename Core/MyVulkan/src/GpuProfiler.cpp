@@ -0,0 +1,306 @@
+#include "include/GpuProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+#include <SDL3/SDL_log.h>
+
+#include <Debug.h>
+
+#include "include/VulkanState.h"
+
+namespace {
+// Results come back in bit order, which PipelineStatistic follows
+constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTIC_FLAGS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+constexpr const char *PIPELINE_STATISTIC_NAMES[PIPELINE_STATISTIC_COUNT] = {
+    "input_primitives",
+    "vertex_invocations",
+    "clipping_primitives",
+    "fragment_invocations",
+    "compute_invocations",
+};
+
+// Value followed by its availability
+struct TimestampResult {
+    uint64_t value     = 0;
+    uint64_t available = 0;
+};
+
+struct StatisticsResult {
+    uint64_t values[PIPELINE_STATISTIC_COUNT] = {};
+    uint64_t available                        = 0;
+};
+} // namespace
+
+float GpuZoneStats::GetAverage() const {
+    const size_t count = std::min(sampleCount, GPU_ZONE_HISTORY);
+    if (count == 0) {
+        return 0.0f;
+    }
+    return std::accumulate(history.begin(), history.begin() + count, 0.0f) / static_cast<float>(count);
+}
+
+float GpuZoneStats::GetPercentile(float percentile) const {
+    const size_t count = std::min(sampleCount, GPU_ZONE_HISTORY);
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    std::vector<float> samples(history.begin(), history.begin() + count);
+    const auto         nth = samples.begin() + static_cast<ptrdiff_t>(std::clamp(percentile, 0.0f, 1.0f) * static_cast<float>(count - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+void GpuProfiler::Init() {
+    const VkDevice device = VulkanState::GetInstance().GetDevice();
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanState::GetInstance().GetPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanState::GetInstance().GetPhysicalDevice(), &familyCount, families.data());
+
+    if (families[VulkanState::GetInstance().GetGraphicsFamily()].timestampValidBits == 0) {
+        SDL_Log("Timestamps unsupported on the graphics queue, GPU profiler disabled");
+        return;
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(VulkanState::GetInstance().GetPhysicalDevice(), &properties);
+    m_timestampPeriod = properties.limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo infoTimestamps{
+        .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .pNext      = nullptr,
+        .flags      = 0,
+        .queryType  = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = GPU_PROFILER_FRAME_LATENCY * MAX_GPU_ZONE_COUNT * 2,
+    };
+    DEBUG_VK_ASSERT(vkCreateQueryPool(device, &infoTimestamps, nullptr, &m_timestampPool));
+
+    if (VulkanState::GetInstance().HasPipelineStatistics()) {
+        VkQueryPoolCreateInfo infoStatistics{
+            .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext              = nullptr,
+            .flags              = 0,
+            .queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+            .queryCount         = GPU_PROFILER_FRAME_LATENCY * MAX_GPU_ZONE_COUNT,
+            .pipelineStatistics = PIPELINE_STATISTIC_FLAGS,
+        };
+        DEBUG_VK_ASSERT(vkCreateQueryPool(device, &infoStatistics, nullptr, &m_statisticsPool));
+    }
+}
+
+void GpuProfiler::Destroy() {
+    const VkDevice device = VulkanState::GetInstance().GetDevice();
+
+    if (m_timestampPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device, m_timestampPool, nullptr);
+    }
+    if (m_statisticsPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device, m_statisticsPool, nullptr);
+    }
+    m_timestampPool  = VK_NULL_HANDLE;
+    m_statisticsPool = VK_NULL_HANDLE;
+
+    m_zones.clear();
+    m_zoneIndices.clear();
+}
+
+void GpuProfiler::BeginFrame() {
+    if (!IsSupported()) {
+        return;
+    }
+
+    // The slot about to be reused was recorded GPU_PROFILER_FRAME_LATENCY frames ago and has retired
+    m_frameIndex = (m_frameIndex + 1) % GPU_PROFILER_FRAME_LATENCY;
+    ReadFrame(m_frameIndex);
+    m_frames[m_frameIndex].zones.clear();
+
+    const VkCommandBuffer cmdBuf = VulkanState::GetInstance().GetCommandBuffer();
+    vkCmdResetQueryPool(cmdBuf, m_timestampPool, m_frameIndex * MAX_GPU_ZONE_COUNT * 2, MAX_GPU_ZONE_COUNT * 2);
+    if (m_statisticsPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(cmdBuf, m_statisticsPool, m_frameIndex * MAX_GPU_ZONE_COUNT, MAX_GPU_ZONE_COUNT);
+    }
+}
+
+uint32_t GpuProfiler::BeginZone(VkCommandBuffer cmdBuf, const char *name) {
+    FrameRecord &frame = m_frames[m_frameIndex];
+    if (!IsSupported() || frame.zones.size() >= MAX_GPU_ZONE_COUNT) {
+        return INVALID_GPU_ZONE;
+    }
+
+    const auto zone  = static_cast<uint32_t>(frame.zones.size());
+    const auto query = m_frameIndex * MAX_GPU_ZONE_COUNT + zone;
+
+    const bool statistics = m_statisticsPool != VK_NULL_HANDLE && !m_statisticsActive;
+    frame.zones.push_back({.name = name, .statistics = statistics});
+
+    vkCmdWriteTimestamp(cmdBuf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestampPool, query * 2);
+    if (statistics) {
+        vkCmdBeginQuery(cmdBuf, m_statisticsPool, query, 0);
+        m_statisticsActive = true;
+    }
+
+    return zone;
+}
+
+void GpuProfiler::EndZone(VkCommandBuffer cmdBuf, uint32_t zone) {
+    if (zone == INVALID_GPU_ZONE) {
+        return;
+    }
+
+    const auto query = m_frameIndex * MAX_GPU_ZONE_COUNT + zone;
+
+    if (m_frames[m_frameIndex].zones[zone].statistics) {
+        vkCmdEndQuery(cmdBuf, m_statisticsPool, query);
+        m_statisticsActive = false;
+    }
+    vkCmdWriteTimestamp(cmdBuf, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampPool, query * 2 + 1);
+}
+
+void GpuProfiler::ReadFrame(uint32_t frame) {
+    m_frameTime = 0.0f;
+
+    const std::vector<ZoneRecord> &records = m_frames[frame].zones;
+    if (records.empty()) {
+        return;
+    }
+
+    const VkDevice device = VulkanState::GetInstance().GetDevice();
+    const auto     count  = static_cast<uint32_t>(records.size());
+
+    // Never waits, a zone whose queries are not available yet is dropped for this frame
+    std::vector<TimestampResult> timestamps(count * 2);
+    vkGetQueryPoolResults(
+        device,
+        m_timestampPool,
+        frame * MAX_GPU_ZONE_COUNT * 2,
+        count * 2,
+        sizeof(TimestampResult) * timestamps.size(),
+        timestamps.data(),
+        sizeof(TimestampResult),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+    );
+
+    std::vector<StatisticsResult> statistics(count);
+    if (m_statisticsPool != VK_NULL_HANDLE) {
+        vkGetQueryPoolResults(
+            device,
+            m_statisticsPool,
+            frame * MAX_GPU_ZONE_COUNT,
+            count,
+            sizeof(StatisticsResult) * statistics.size(),
+            statistics.data(),
+            sizeof(StatisticsResult),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+        );
+    }
+
+    // Sum the zones sharing a name before they become one sample
+    std::unordered_map<size_t, float>                                          times;
+    std::unordered_map<size_t, std::array<uint64_t, PIPELINE_STATISTIC_COUNT>> sums;
+    uint64_t                                                                   frameBegin = UINT64_MAX;
+    uint64_t                                                                   frameEnd   = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const TimestampResult &begin = timestamps[i * 2];
+        const TimestampResult &end   = timestamps[i * 2 + 1];
+        if (begin.available == 0 || end.available == 0) {
+            continue;
+        }
+        frameBegin = std::min(frameBegin, begin.value);
+        frameEnd   = std::max(frameEnd, end.value);
+
+        const size_t index = GetZoneIndex(records[i].name);
+        times[index] += static_cast<float>(end.value - begin.value) * m_timestampPeriod * 1e-6f;
+
+        if (records[i].statistics && statistics[i].available != 0) {
+            auto &sum = sums[index];
+            for (size_t j = 0; j < PIPELINE_STATISTIC_COUNT; j++) {
+                sum[j] += statistics[i].values[j];
+            }
+        }
+    }
+
+    if (frameEnd > frameBegin) {
+        m_frameTime = static_cast<float>(frameEnd - frameBegin) * m_timestampPeriod * 1e-6f;
+    }
+
+    for (const auto &[index, time]: times) {
+        GpuZoneStats &zone = m_zones[index];
+        zone.history[zone.next] = time;
+        zone.next               = (zone.next + 1) % GPU_ZONE_HISTORY;
+        zone.sampleCount++;
+    }
+    for (const auto &[index, sum]: sums) {
+        m_zones[index].statistics    = sum;
+        m_zones[index].hasStatistics = true;
+    }
+}
+
+size_t GpuProfiler::GetZoneIndex(const char *name) {
+    const auto it = m_zoneIndices.find(name);
+    if (it != m_zoneIndices.end()) {
+        return it->second;
+    }
+
+    m_zoneIndices.emplace(name, m_zones.size());
+    m_zones.push_back({.name = name});
+    return m_zones.size() - 1;
+}
+
+bool GpuProfiler::ExportCsv(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file) {
+        SDL_Log("Failed to open %s", path.c_str());
+        return false;
+    }
+
+    file << "zone,sample,milliseconds\n";
+    for (const auto &zone: m_zones) {
+        // Oldest sample first
+        const size_t count = std::min(zone.sampleCount, GPU_ZONE_HISTORY);
+        const size_t first = zone.sampleCount > GPU_ZONE_HISTORY ? zone.next : 0;
+        for (size_t i = 0; i < count; i++) {
+            file << zone.name << ',' << i << ',' << zone.history[(first + i) % GPU_ZONE_HISTORY] << '\n';
+        }
+    }
+
+    SDL_Log("GPU profile written to %s", path.c_str());
+    return true;
+}
+
+bool GpuProfiler::ExportJson(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file) {
+        SDL_Log("Failed to open %s", path.c_str());
+        return false;
+    }
+
+    file << "{\n  \"zones\": [";
+    for (size_t i = 0; i < m_zones.size(); i++) {
+        const GpuZoneStats &zone = m_zones[i];
+
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    {\"name\": \"" << zone.name << "\", \"samples\": " << std::min(zone.sampleCount, GPU_ZONE_HISTORY);
+        file << ", \"average_ms\": " << zone.GetAverage() << ", \"p50_ms\": " << zone.GetPercentile(0.5f);
+        file << ", \"p95_ms\": " << zone.GetPercentile(0.95f) << ", \"p99_ms\": " << zone.GetPercentile(0.99f);
+        if (zone.hasStatistics) {
+            file << ", \"statistics\": {";
+            for (size_t j = 0; j < PIPELINE_STATISTIC_COUNT; j++) {
+                file << (j == 0 ? "" : ", ") << '"' << PIPELINE_STATISTIC_NAMES[j] << "\": " << zone.statistics[j];
+            }
+            file << '}';
+        }
+        file << '}';
+    }
+    file << "\n  ]\n}\n";
+
+    SDL_Log("GPU profile written to %s", path.c_str());
+    return true;
+}
@@ -0,0 +1,66 @@
+#include "include/PresentSettings.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include <Debug.h>
+
+namespace {
+constexpr std::pair<const char *, VkPresentModeKHR> PRESENT_MODES[] = {
+    {"fifo",      VK_PRESENT_MODE_FIFO_KHR        },
+    {"relaxed",   VK_PRESENT_MODE_FIFO_RELAXED_KHR},
+    {"mailbox",   VK_PRESENT_MODE_MAILBOX_KHR     },
+    {"immediate", VK_PRESENT_MODE_IMMEDIATE_KHR   },
+};
+
+// The whole value has to be a number, malformed ones are reported instead of throwing
+template<typename T>
+T ParseNumber(const std::string &arg, const char *value) {
+    T           number{};
+    const char *end           = value + std::strlen(value);
+    const auto [last, result] = std::from_chars(value, end, number);
+    DEBUG_ASSERT_LOG(result == std::errc() && last == end, (arg + " expects a number, got " + value).c_str());
+    return number;
+}
+} // namespace
+
+PresentSettings PresentSettings::FromArgs(int argc, char *argv[]) {
+    PresentSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg   = argv[i];
+        const char       *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (arg == "--low-latency") {
+            settings.lowLatency = true;
+        } else if (arg == "--present") {
+            DEBUG_ASSERT_LOG(value != nullptr, "--present expects fifo, relaxed, mailbox or immediate");
+            i++;
+            const auto mode = std::ranges::find_if(PRESENT_MODES, [value](const auto &pair) { return value == std::string(pair.first); });
+            DEBUG_ASSERT_LOG(mode != std::end(PRESENT_MODES), ("Unknown present mode " + std::string(value)).c_str());
+            settings.presentMode = mode->second;
+        } else if (arg == "--swapchain-images") {
+            DEBUG_ASSERT_LOG(value != nullptr, "--swapchain-images expects a count");
+            i++;
+            settings.imageCount = ParseNumber<uint32_t>(arg, value);
+        } else if (arg == "--fps-limit") {
+            DEBUG_ASSERT_LOG(value != nullptr, "--fps-limit expects frames per second");
+            i++;
+            settings.frameLimit = ParseNumber<float>(arg, value);
+        }
+    }
+    return settings;
+}
+
+const char *PresentSettings::GetPresentModeName(VkPresentModeKHR presentMode) {
+    for (const auto &[name, mode]: PRESENT_MODES) {
+        if (mode == presentMode) {
+            return name;
+        }
+    }
+    return "unknown";
+}
@@ -0,0 +1,114 @@
+#include "include/QueueTimeline.h"
+
+#include <Debug.h>
+
+void QueueTimeline::Init(VkDevice device, VkQueue queue) {
+    m_device = device;
+    m_queue  = queue;
+
+    VkSemaphoreTypeCreateInfo infoType{
+        .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .pNext         = nullptr,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue  = 0,
+    };
+    VkSemaphoreCreateInfo infoSemaphore{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &infoType,
+        .flags = 0,
+    };
+    DEBUG_VK_ASSERT(vkCreateSemaphore(m_device, &infoSemaphore, nullptr, &m_semaphore));
+}
+
+void QueueTimeline::Destroy() {
+    if (m_semaphore != VK_NULL_HANDLE) {
+        vkDestroySemaphore(m_device, m_semaphore, nullptr);
+    }
+    m_semaphore = VK_NULL_HANDLE;
+    m_queue     = VK_NULL_HANDLE;
+}
+
+uint64_t QueueTimeline::Submit(VkCommandBuffer cmdBuf, const std::vector<SubmitWait> &waits, const std::vector<VkSemaphore> &binarySignals) {
+    DEBUG_ASSERT(IsValid());
+
+    std::vector<VkSemaphore>          waitSemaphores;
+    std::vector<uint64_t>             waitValues;
+    std::vector<VkPipelineStageFlags> waitStages;
+    for (const SubmitWait &wait: waits) {
+        waitSemaphores.push_back(wait.semaphore);
+        waitValues.push_back(wait.value);
+        waitStages.push_back(wait.stage);
+    }
+
+    // The timeline goes last, binary semaphores ignore their value
+    std::vector<VkSemaphore> signalSemaphores = binarySignals;
+    std::vector<uint64_t>    signalValues(binarySignals.size(), 0);
+    signalSemaphores.push_back(m_semaphore);
+
+    // Values have to be signaled in submission order, so picking one and submitting it is a single step
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    const uint64_t               value = m_submitted.load(std::memory_order_relaxed) + 1;
+    signalValues.push_back(value);
+
+    VkTimelineSemaphoreSubmitInfo infoTimeline{
+        .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext                     = nullptr,
+        .waitSemaphoreValueCount   = static_cast<uint32_t>(waitValues.size()),
+        .pWaitSemaphoreValues      = waitValues.data(),
+        .signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size()),
+        .pSignalSemaphoreValues    = signalValues.data(),
+    };
+    VkSubmitInfo infoSubmit{
+        .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext                = &infoTimeline,
+        .waitSemaphoreCount   = static_cast<uint32_t>(waitSemaphores.size()),
+        .pWaitSemaphores      = waitSemaphores.data(),
+        .pWaitDstStageMask    = waitStages.data(),
+        .commandBufferCount   = 1,
+        .pCommandBuffers      = &cmdBuf,
+        .signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size()),
+        .pSignalSemaphores    = signalSemaphores.data(),
+    };
+    DEBUG_VK_ASSERT(vkQueueSubmit(m_queue, 1, &infoSubmit, VK_NULL_HANDLE));
+
+    m_submitted.store(value, std::memory_order_release);
+    return value;
+}
+
+VkResult QueueTimeline::Present(const VkPresentInfoKHR &info) {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    return vkQueuePresentKHR(m_queue, &info);
+}
+
+void QueueTimeline::WaitFor(uint64_t value) const {
+    DEBUG_ASSERT(value <= GetSubmittedValue());
+    if (IsComplete(value)) {
+        return;
+    }
+
+    VkSemaphoreWaitInfo infoWait{
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext          = nullptr,
+        .flags          = 0,
+        .semaphoreCount = 1,
+        .pSemaphores    = &m_semaphore,
+        .pValues        = &value,
+    };
+    DEBUG_VK_ASSERT(vkWaitSemaphores(m_device, &infoWait, UINT64_MAX));
+    GetCompletedValue();
+}
+
+bool QueueTimeline::IsComplete(uint64_t value) const {
+    return value <= m_completed.load(std::memory_order_acquire) || value <= GetCompletedValue();
+}
+
+uint64_t QueueTimeline::GetCompletedValue() const {
+    uint64_t value = 0;
+    DEBUG_VK_ASSERT(vkGetSemaphoreCounterValue(m_device, m_semaphore, &value));
+
+    // Readers on other threads may have seen a later value already
+    uint64_t cached = m_completed.load(std::memory_order_relaxed);
+    while (cached < value && !m_completed.compare_exchange_weak(cached, value, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return value;
+}
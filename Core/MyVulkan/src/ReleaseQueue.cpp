@@ -0,0 +1,145 @@
+#include "include/ReleaseQueue.h"
+
+#include <Debug.h>
+
+namespace {
+bool IsComplete(const QueueTimeline *timeline, uint64_t value) { return !timeline->IsValid() || timeline->IsComplete(value); }
+} // namespace
+
+void ReleaseQueue::Init(
+    VkDevice             device,
+    const QueueTimeline &graphics,
+    const QueueTimeline &compute,
+    const QueueTimeline &transfer,
+    DescriptorAllocator &descriptorAllocator
+) {
+    m_device              = device;
+    m_graphics            = &graphics;
+    m_compute             = &compute;
+    m_transfer            = &transfer;
+    m_descriptorAllocator = &descriptorAllocator;
+}
+
+void ReleaseQueue::BeginFrame() {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    CollectLocked();
+    m_begunFrames++;
+}
+
+void ReleaseQueue::EndFrame(uint64_t graphicsValue, uint64_t computeValue) {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_submittedFrames++;
+    m_frames[m_submittedFrames % RELEASE_FRAME_HISTORY] = {graphicsValue, computeValue};
+}
+
+void ReleaseQueue::Collect() {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    CollectLocked();
+}
+
+void ReleaseQueue::Flush() {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    for (; m_count > 0; m_count--) {
+        Destroy(m_entries[m_first]);
+        m_first = (m_first + 1) % RELEASE_QUEUE_CAPACITY;
+    }
+}
+
+size_t ReleaseQueue::GetPendingCount() const {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    return m_count;
+}
+
+void ReleaseQueue::Push(VkObjectType type, uint64_t handle) {
+    DEBUG_ASSERT(m_device != VK_NULL_HANDLE);
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    const Entry entry{
+        .type          = type,
+        .handle        = handle,
+        .frame         = m_begunFrames,
+        .graphicsValue = m_graphics->GetSubmittedValue(),
+        .computeValue  = m_compute->IsValid() ? m_compute->GetSubmittedValue() : 0,
+        .transferValue = m_transfer->IsValid() ? m_transfer->GetSubmittedValue() : 0,
+    };
+
+    // Nothing in flight can use it, loading threads before the first frame always end up here
+    if (m_count == 0 && IsRetired(entry)) {
+        Destroy(entry);
+        return;
+    }
+
+    if (m_count == RELEASE_QUEUE_CAPACITY) {
+        CollectLocked();
+    }
+    DEBUG_ASSERT_LOG(m_count < RELEASE_QUEUE_CAPACITY, "Release queue full, more objects released within a frame than RELEASE_QUEUE_CAPACITY");
+
+    m_entries[(m_first + m_count) % RELEASE_QUEUE_CAPACITY] = entry;
+    m_count++;
+}
+
+void ReleaseQueue::CollectLocked() {
+    // Entries are pushed in release order, so the first one still in use ends the scan
+    while (m_count > 0 && IsRetired(m_entries[m_first])) {
+        Destroy(m_entries[m_first]);
+        m_first = (m_first + 1) % RELEASE_QUEUE_CAPACITY;
+        m_count--;
+    }
+}
+
+bool ReleaseQueue::IsRetired(const Entry &entry) const {
+    // Still being recorded
+    if (entry.frame > m_submittedFrames) {
+        return false;
+    }
+
+    // Older frames fell out of the history, they retired long ago
+    if (entry.frame > 0 && entry.frame + RELEASE_FRAME_HISTORY > m_submittedFrames) {
+        const FrameValues &frame = m_frames[entry.frame % RELEASE_FRAME_HISTORY];
+        if (!IsComplete(m_graphics, frame.graphics) || !IsComplete(m_compute, frame.compute)) {
+            return false;
+        }
+    }
+
+    return IsComplete(m_graphics, entry.graphicsValue) && IsComplete(m_compute, entry.computeValue) && IsComplete(m_transfer, entry.transferValue);
+}
+
+void ReleaseQueue::Destroy(const Entry &entry) {
+    switch (entry.type) {
+        case VK_OBJECT_TYPE_BUFFER:
+            vkDestroyBuffer(m_device, reinterpret_cast<VkBuffer>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_IMAGE:
+            vkDestroyImage(m_device, reinterpret_cast<VkImage>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_IMAGE_VIEW:
+            vkDestroyImageView(m_device, reinterpret_cast<VkImageView>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_DEVICE_MEMORY:
+            vkFreeMemory(m_device, reinterpret_cast<VkDeviceMemory>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET:
+            m_descriptorAllocator->Free(reinterpret_cast<VkDescriptorSet>(entry.handle));
+            break;
+        case VK_OBJECT_TYPE_SAMPLER:
+            vkDestroySampler(m_device, reinterpret_cast<VkSampler>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE:
+            vkDestroyPipeline(m_device, reinterpret_cast<VkPipeline>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+            vkDestroyPipelineLayout(m_device, reinterpret_cast<VkPipelineLayout>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+            vkDestroyDescriptorSetLayout(m_device, reinterpret_cast<VkDescriptorSetLayout>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_SHADER_MODULE:
+            vkDestroyShaderModule(m_device, reinterpret_cast<VkShaderModule>(entry.handle), nullptr);
+            break;
+        case VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+            vkDestroySwapchainKHR(m_device, reinterpret_cast<VkSwapchainKHR>(entry.handle), nullptr);
+            break;
+        default:
+            DEBUG_ASSERT_LOG(false, "Unsupported object type released");
+    }
+}
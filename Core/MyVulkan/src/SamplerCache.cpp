@@ -0,0 +1,86 @@
+#include "include/SamplerCache.h"
+
+#include <functional>
+
+#include <Debug.h>
+
+#include "include/VulkanState.h"
+
+namespace {
+template<typename T>
+void HashCombine(size_t &seed, const T &value) {
+    seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+} // namespace
+
+size_t SamplerConfigHash::operator()(const SamplerConfig &config) const {
+    size_t seed = 0;
+    HashCombine(seed, static_cast<uint32_t>(config.filter));
+    HashCombine(seed, static_cast<uint32_t>(config.mipmapMode));
+    HashCombine(seed, static_cast<uint32_t>(config.addressMode));
+    HashCombine(seed, config.anisotropyEnable);
+    HashCombine(seed, config.maxAnisotropy);
+    HashCombine(seed, config.compareEnable);
+    HashCombine(seed, static_cast<uint32_t>(config.compareOp));
+    HashCombine(seed, config.minLod);
+    HashCombine(seed, config.maxLod);
+    HashCombine(seed, static_cast<uint32_t>(config.borderColor));
+    return seed;
+}
+
+VkSampler SamplerCache::Acquire(const SamplerConfig &config) {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+
+    Entry &entry = m_samplers[config];
+    if (entry.sampler == VK_NULL_HANDLE) {
+        entry.sampler = CreateSampler(config);
+    }
+    entry.refCount++;
+
+    return entry.sampler;
+}
+
+void SamplerCache::Release(const SamplerConfig &config) {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+
+    auto pair = m_samplers.find(config);
+    DEBUG_ASSERT(pair != m_samplers.end() && pair->second.refCount > 0);
+
+    // Frames in flight may still sample with it, a later acquire of the config creates a new one
+    if (--pair->second.refCount == 0) {
+        VulkanState::GetInstance().GetReleaseQueue().Release(VK_OBJECT_TYPE_SAMPLER, pair->second.sampler);
+        m_samplers.erase(pair);
+    }
+}
+
+size_t SamplerCache::GetSamplerCount() const {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+    return m_samplers.size();
+}
+
+VkSampler SamplerCache::CreateSampler(const SamplerConfig &config) {
+    VkSamplerCreateInfo infoSampler{
+        .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .pNext                   = nullptr,
+        .flags                   = 0,
+        .magFilter               = config.filter,
+        .minFilter               = config.filter,
+        .mipmapMode              = config.mipmapMode,
+        .addressModeU            = config.addressMode,
+        .addressModeV            = config.addressMode,
+        .addressModeW            = config.addressMode,
+        .mipLodBias              = 0.0f,
+        .anisotropyEnable        = config.anisotropyEnable,
+        .maxAnisotropy           = config.maxAnisotropy,
+        .compareEnable           = config.compareEnable,
+        .compareOp               = config.compareOp,
+        .minLod                  = config.minLod,
+        .maxLod                  = config.maxLod,
+        .borderColor             = config.borderColor,
+        .unnormalizedCoordinates = VK_FALSE, // Always normalized
+    };
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    DEBUG_VK_ASSERT(vkCreateSampler(VulkanState::GetInstance().GetDevice(), &infoSampler, nullptr, &sampler));
+    return sampler;
+}
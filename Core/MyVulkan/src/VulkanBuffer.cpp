@@ -17,8 +17,9 @@ void VulkanBuffer::Swap(VulkanBuffer &other) noexcept {
 
 void VulkanBuffer::Destroy() {
     if (m_buffer != VK_NULL_HANDLE) {
-        vkFreeMemory(VulkanState::GetInstance().GetDevice(), m_memory, nullptr);
-        vkDestroyBuffer(VulkanState::GetInstance().GetDevice(), m_buffer, nullptr);
+        ReleaseQueue &releaseQueue = VulkanState::GetInstance().GetReleaseQueue();
+        releaseQueue.Release(VK_OBJECT_TYPE_BUFFER, m_buffer);
+        releaseQueue.Release(VK_OBJECT_TYPE_DEVICE_MEMORY, m_memory);
     }
 
     m_buffer = VK_NULL_HANDLE;
@@ -66,4 +67,21 @@ void VulkanBuffer::Upload(size_t size, const void *data) {
     DEBUG_VK_ASSERT(vkMapMemory(VulkanState::GetInstance().GetDevice(), m_memory, 0, VK_WHOLE_SIZE, 0, &mappedData));
     memcpy(mappedData, data, size);
     vkUnmapMemory(VulkanState::GetInstance().GetDevice(), m_memory);
+}
+
+void VulkanBuffer::Download(size_t size, void *data) const {
+    void *mappedData;
+    DEBUG_VK_ASSERT(vkMapMemory(VulkanState::GetInstance().GetDevice(), m_memory, 0, VK_WHOLE_SIZE, 0, &mappedData));
+
+    // The memory may not be host coherent
+    VkMappedMemoryRange range{
+        .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .pNext  = nullptr,
+        .memory = m_memory,
+        .offset = 0,
+        .size   = VK_WHOLE_SIZE,
+    };
+    DEBUG_VK_ASSERT(vkInvalidateMappedMemoryRanges(VulkanState::GetInstance().GetDevice(), 1, &range));
+    memcpy(data, mappedData, size);
+    vkUnmapMemory(VulkanState::GetInstance().GetDevice(), m_memory);
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ void VulkanGraphicsPipeline::CreatePipeline(const GraphicsPipelineOption &option
     VkPipelineRenderingCreateInfo infoRendering{
         .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
         .pNext                   = nullptr,
-        .viewMask                = 0,
+        .viewMask                = option.viewMask,
         .colorAttachmentCount    = static_cast<uint32_t>(option.colorFormats.size()),
         .pColorAttachmentFormats = option.colorFormats.data(),
         .depthAttachmentFormat   = option.depthFormat,
@@ -24,9 +24,10 @@ VulkanImage::VulkanImage(
 
 void VulkanImage::Destroy() {
     if (m_image != VK_NULL_HANDLE) {
-        vkDestroyImageView(VulkanState::GetInstance().GetDevice(), m_view, nullptr);
-        vkFreeMemory(VulkanState::GetInstance().GetDevice(), m_memory, nullptr);
-        vkDestroyImage(VulkanState::GetInstance().GetDevice(), m_image, nullptr);
+        ReleaseQueue &releaseQueue = VulkanState::GetInstance().GetReleaseQueue();
+        releaseQueue.Release(VK_OBJECT_TYPE_IMAGE_VIEW, m_view);
+        releaseQueue.Release(VK_OBJECT_TYPE_IMAGE, m_image);
+        releaseQueue.Release(VK_OBJECT_TYPE_DEVICE_MEMORY, m_memory);
     }
 
     m_image  = VK_NULL_HANDLE;
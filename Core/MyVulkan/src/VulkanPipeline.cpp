@@ -1,56 +1,58 @@
 #include "include/VulkanPipeline.h"
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
+#include <span>
 
 #include <include/ShaderCompiler.h>
 #include <include/VulkanState.h>
 #include <include/VulkanUtil.h>
 
-VulkanPipeline::VulkanPipeline(const std::vector<std::string> &paths) {
-    ShaderCompiler shaderCompiler(paths);
+namespace {
+// Pipelines are created on the thread pool
+std::atomic<uint32_t> nextId = 1;
+} // namespace
+
+VulkanPipelineLayout::VulkanPipelineLayout(const ShaderCompiler &shaderCompiler) {
     CreateDescriptorSetLayout(shaderCompiler.GetDescriptorSetLayoutInfos());
     m_pushConstantRanges = shaderCompiler.GetPushConstantRanges();
     CreateLayout();
-    CreateShaderModules(shaderCompiler);
 }
 
-void VulkanPipeline::Destroy() {
-    if (m_pipeline != VK_NULL_HANDLE) {
-        for (auto &shaderModule: m_shaderModules) {
-            vkDestroyShaderModule(VulkanState::GetInstance().GetDevice(), shaderModule.second, nullptr);
-        }
-
-        vkDestroyPipeline(VulkanState::GetInstance().GetDevice(), m_pipeline, nullptr);
-        vkDestroyPipelineLayout(VulkanState::GetInstance().GetDevice(), m_layout, nullptr);
-        for (size_t i = 0; i < m_descriptorSetLayouts.size(); i++) {
-            vkDestroyDescriptorSetLayout(VulkanState::GetInstance().GetDevice(), m_descriptorSetLayouts[i], nullptr);
-        }
+VulkanPipelineLayout::~VulkanPipelineLayout() {
+    // The last pipeline using the layout may still be bound by frames in flight
+    ReleaseQueue &releaseQueue = VulkanState::GetInstance().GetReleaseQueue();
+    releaseQueue.Release(VK_OBJECT_TYPE_PIPELINE_LAYOUT, m_layout);
+    for (VkDescriptorSetLayout setLayout: m_descriptorSetLayouts) {
+        releaseQueue.Release(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, setLayout);
     }
-
-    m_descriptorSetLayouts.clear();
-    m_pushConstantRanges.clear();
-    m_shaderModules.clear();
-    m_pipeline = VK_NULL_HANDLE;
-    m_layout   = VK_NULL_HANDLE;
 }
 
-void VulkanPipeline::CreateShaderModules(const ShaderCompiler &shaderCompiler) {
-    for (const auto shaderCode: shaderCompiler.CompileToSpirv()) {
-        VkShaderModule           shaderModule = VK_NULL_HANDLE;
-        VkShaderModuleCreateInfo infoModule{
-            .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-            .pNext    = nullptr,
-            .flags    = 0,
-            .codeSize = shaderCode.second.size() * sizeof(uint32_t),
-            .pCode    = shaderCode.second.data()
-        };
-        DEBUG_VK_ASSERT(vkCreateShaderModule(VulkanState::GetInstance().GetDevice(), &infoModule, nullptr, &shaderModule));
+bool VulkanPipelineLayout::IsCompatible(const ShaderCompiler &shaderCompiler) const {
+    auto sameRange = [](const VkPushConstantRange &a, const VkPushConstantRange &b) {
+        return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+    };
+    auto sameBinding = [](const VkDescriptorSetLayoutBinding &a, const VkDescriptorSetLayoutBinding &b) {
+        return a.binding == b.binding && a.descriptorType == b.descriptorType && a.descriptorCount == b.descriptorCount &&
+               a.stageFlags == b.stageFlags;
+    };
 
-        m_shaderModules.emplace(shaderCode.first, std::move(shaderModule));
+    const std::vector<VkDescriptorSetLayoutCreateInfo> infos = shaderCompiler.GetDescriptorSetLayoutInfos();
+    if (!std::ranges::equal(m_pushConstantRanges, shaderCompiler.GetPushConstantRanges(), sameRange) ||
+        m_descriptorSetBindings.size() != infos.size()) {
+        return false;
     }
+    for (size_t i = 0; i < infos.size(); i++) {
+        const std::span<const VkDescriptorSetLayoutBinding> bindings(infos[i].pBindings, infos[i].bindingCount);
+        if (!std::ranges::equal(m_descriptorSetBindings[i], bindings, sameBinding)) {
+            return false;
+        }
+    }
+    return true;
 }
 
-void VulkanPipeline::CreateLayout() {
+void VulkanPipelineLayout::CreateLayout() {
     VkPipelineLayoutCreateInfo infoLayout{
         .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .pNext                  = nullptr,
@@ -63,12 +65,60 @@ void VulkanPipeline::CreateLayout() {
     vkCreatePipelineLayout(VulkanState::GetInstance().GetDevice(), &infoLayout, nullptr, &m_layout);
 }
 
-void VulkanPipeline::CreateDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutCreateInfo> &infos) {
+void VulkanPipelineLayout::CreateDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutCreateInfo> &infos) {
     VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
 
+    // Only layouts created here size the descriptor pools, reloads share them
     for (size_t i = 0; i < infos.size(); i++) {
         DEBUG_VK_ASSERT(vkCreateDescriptorSetLayout(VulkanState::GetInstance().GetDevice(), &infos[i], nullptr, &setLayout));
+        VulkanState::GetInstance().AddDescriptorSetLayout(infos[i]);
         m_descriptorSetLayouts.push_back(std::move(setLayout));
+        m_descriptorSetBindings.emplace_back(infos[i].pBindings, infos[i].pBindings + infos[i].bindingCount);
+    }
+}
+
+VulkanPipeline::VulkanPipeline(const ShaderCompiler &shaderCompiler, std::shared_ptr<const VulkanPipelineLayout> pipelineLayout, uint32_t id) {
+    DEBUG_ASSERT(shaderCompiler.IsValid());
+    if (pipelineLayout) {
+        DEBUG_ASSERT(pipelineLayout->IsCompatible(shaderCompiler));
+        m_pipelineLayout = std::move(pipelineLayout);
+        m_id             = id;
+    } else {
+        m_pipelineLayout = std::make_shared<const VulkanPipelineLayout>(shaderCompiler);
+        m_id             = nextId++;
+    }
+    m_layout = m_pipelineLayout->GetLayout();
+
+    CreateShaderModules(shaderCompiler);
+}
+
+void VulkanPipeline::Destroy() {
+    // A reload replaces the pipeline while frames in flight may still bind it, the layouts are kept for the next one
+    ReleaseQueue &releaseQueue = VulkanState::GetInstance().GetReleaseQueue();
+    for (auto &shaderModule: m_shaderModules) {
+        releaseQueue.Release(VK_OBJECT_TYPE_SHADER_MODULE, shaderModule.second);
+    }
+    releaseQueue.Release(VK_OBJECT_TYPE_PIPELINE, m_pipeline);
+
+    m_pipelineLayout.reset();
+    m_shaderModules.clear();
+    m_pipeline = VK_NULL_HANDLE;
+    m_layout   = VK_NULL_HANDLE;
+}
+
+void VulkanPipeline::CreateShaderModules(const ShaderCompiler &shaderCompiler) {
+    for (const auto shaderCode: shaderCompiler.CompileToSpirv()) {
+        VkShaderModule           shaderModule = VK_NULL_HANDLE;
+        VkShaderModuleCreateInfo infoModule{
+            .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .pNext    = nullptr,
+            .flags    = 0,
+            .codeSize = shaderCode.second.size() * sizeof(uint32_t),
+            .pCode    = shaderCode.second.data()
+        };
+        DEBUG_VK_ASSERT(vkCreateShaderModule(VulkanState::GetInstance().GetDevice(), &infoModule, nullptr, &shaderModule));
+
+        m_shaderModules.emplace(shaderCode.first, std::move(shaderModule));
     }
 }
 
@@ -2,6 +2,9 @@
 
 #include "include/ThreadPool.h"
 
+#include <algorithm>
+#include <optional>
+#include <string_view>
 #include <vector>
 
 #include <SDL3/SDL_vulkan.h>
@@ -12,10 +15,11 @@
 #include <include/Descriptor.h>
 #include <include/Window.h>
 
-void VulkanState::Init() {
-    m_window = Window::GetInstance().GetSDLWindow();
-    m_width  = Window::GetInstance().GetWidth();
-    m_height = Window::GetInstance().GetHeight();
+void VulkanState::Init(const PresentSettings &settings) {
+    m_window          = Window::GetInstance().GetSDLWindow();
+    m_requestedWidth  = Window::GetInstance().GetWidth();
+    m_requestedHeight = Window::GetInstance().GetHeight();
+    m_presentSettings = settings;
 
     CreateInstance();
     CreatePhysicalDevice();
@@ -23,14 +27,47 @@ void VulkanState::Init() {
     CreateCommandPool();
     CreateCommandBuffer();
     CreateSurface(Window::GetInstance().GetSDLWindow());
-    CreateSwapchain(Window::GetInstance().GetWidth(), Window::GetInstance().GetHeight());
+    const VkExtent2D extent = ChooseSwapchainExtent();
+    CreateSwapchain(extent.width, extent.height);
+    CreateSyncObjects();
+    CreateDescriptorPools();
+    m_releaseQueue.Init(m_device, m_graphicsTimeline, m_computeTimeline, m_transferTimeline, m_descriptorAllocator);
+}
+
+void VulkanState::InitHeadless(uint32_t width, uint32_t height) {
+    m_headless = true;
+    m_width    = width;
+    m_height   = height;
+
+    CreateInstance();
+    CreatePhysicalDevice();
+    CreateDevice();
+    CreateCommandPool();
+    CreateCommandBuffer();
+    CreateOffscreenTarget(width, height);
+    CreateSyncObjects();
+    CreateDescriptorPools();
+    m_releaseQueue.Init(m_device, m_graphicsTimeline, m_computeTimeline, m_transferTimeline, m_descriptorAllocator);
+}
+
+void VulkanState::CreateSyncObjects() {
+    m_renderSemaphore = CreateSemaphore();
+    for (AcquireSemaphore &acquire: m_acquireSemaphores) {
+        acquire.semaphore = CreateSemaphore();
+    }
+
+    m_graphicsTimeline.Init(m_device, m_queue);
+    m_deletionQueue.PushFunction([&]() { m_graphicsTimeline.Destroy(); });
 
-    m_renderFence      = CreateFence(VK_FENCE_CREATE_SIGNALED_BIT);
-    m_immediateFence   = CreateFence(0);
-    m_renderSemaphore  = CreateSemaphore();
-    m_presentSemaphore = CreateSemaphore();
+    if (HasAsyncCompute()) {
+        m_computeTimeline.Init(m_device, m_computeQueue);
+        m_deletionQueue.PushFunction([&]() { m_computeTimeline.Destroy(); });
+    }
 
-    CreateDescriptorPool();
+    if (HasTransferQueue()) {
+        m_transferTimeline.Init(m_device, m_transferQueue);
+        m_deletionQueue.PushFunction([&]() { m_transferTimeline.Destroy(); });
+    }
 }
 
 VulkanState::~VulkanState() {
@@ -40,62 +77,246 @@ VulkanState::~VulkanState() {
 
     WaitIdle();
 
-    for (size_t i = 0; i < m_swapchain.count; i++) {
-        vkDestroyImageView(m_device, m_swapchain.views[i], nullptr);
+    // The offscreen target owns its view
+    if (!m_headless) {
+        DestroySwapchainViews();
     }
 
+    m_releaseQueue.Flush();
     m_deletionQueue.Flush();
 
     m_device = VK_NULL_HANDLE;
 }
 
-void VulkanState::BeginFrame() {
-    // Reset fence and command buffer
-    WaitAndResetFence(m_renderFence);
+bool VulkanState::BeginFrame() {
+    // The async post chain of the last frame keeps running, only the graphics work has to be done
+    m_graphicsTimeline.WaitFor(m_frameValue);
+
+    if (!m_headless) {
+        if (m_swapchainDirty && !RecreateSwapchain()) {
+            return false;
+        }
+        // The frame two back waited on it, its post chain finished before the last frame's graphics work, so this rarely blocks
+        m_acquireIndex                 = (m_acquireIndex + 1) % ACQUIRE_SEMAPHORE_COUNT;
+        const AcquireSemaphore &acquire = m_acquireSemaphores[m_acquireIndex];
+        if (acquire.waiter != nullptr) {
+            acquire.waiter->WaitFor(acquire.value);
+        }
+
+        // The surface may change between the resize event and the acquire, the new swapchain gets one more try
+        if (!AcquireNextImage() && (!RecreateSwapchain() || !AcquireNextImage())) {
+            return false;
+        }
+    }
+
     DEBUG_VK_ASSERT(vkResetCommandBuffer(m_cmdBuf, 0));
 
-    AcquireNextImage();
+    m_releaseQueue.BeginFrame();
 
     BeginCommandBuffer(m_cmdBuf, 0);
+    return true;
 }
 
 void VulkanState::EndFrame() {
-    // Layout transition for presenting
-    vk_util::CmdImageLayoutTransition(
-        m_cmdBuf,
-        m_swapchain.images[m_presentImageIndex],
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-        VK_IMAGE_ASPECT_COLOR_BIT,
-        VK_ACCESS_TRANSFER_WRITE_BIT,
-        0
-    );
+    DEBUG_VK_ASSERT(vkEndCommandBuffer(m_cmdBuf));
+
+    // The last async post chain may still read what this frame draws into
+    std::vector<SubmitWait> waits;
+    if (m_postValue > 0) {
+        waits.push_back(m_computeTimeline.After(
+            m_postValue, m_asyncComputeFrame ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
+        ));
+    }
 
-    EndAndSubmitCommandBuffer(m_cmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_renderFence, m_presentSemaphore, m_renderSemaphore);
+    // Headless frames have no image to acquire or present, so neither semaphore is used
+    std::vector<VkSemaphore> presentSignals;
+    if (!m_headless) {
+        presentSignals.push_back(m_renderSemaphore);
+    }
+
+    AcquireSemaphore &acquire = m_acquireSemaphores[m_acquireIndex];
+    if (!m_asyncComputeFrame) {
+        if (!m_headless) {
+            waits.push_back({acquire.semaphore, 0, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT});
+        }
+        m_frameValue   = m_graphicsTimeline.Submit(m_cmdBuf, waits, presentSignals);
+        acquire.waiter = &m_graphicsTimeline;
+        acquire.value  = m_frameValue;
+    } else {
+        m_frameValue = m_graphicsTimeline.Submit(m_cmdBuf, waits);
+
+        // Only the graphics value is waited by the next frame, so its graphics work overlaps this submit
+        std::vector<SubmitWait> computeWaits{m_graphicsTimeline.After(m_frameValue, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT)};
+        if (!m_headless) {
+            computeWaits.push_back({acquire.semaphore, 0, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT});
+        }
+
+        DEBUG_VK_ASSERT(vkEndCommandBuffer(m_computeCmdBuf));
+        m_postValue         = m_computeTimeline.Submit(m_computeCmdBuf, computeWaits, presentSignals);
+        m_asyncComputeFrame = false;
+        acquire.waiter      = &m_computeTimeline;
+        acquire.value       = m_postValue;
+    }
+    m_releaseQueue.EndFrame(m_frameValue, m_postValue);
 
-    QueuePresent(m_renderSemaphore);
+    if (!m_headless) {
+        QueuePresent(m_renderSemaphore);
+    }
+}
+
+void VulkanState::Resize(uint32_t width, uint32_t height) {
+    DEBUG_ASSERT(!m_headless);
+    m_requestedWidth  = width;
+    m_requestedHeight = height;
+    m_swapchainDirty  = true;
+}
+
+void VulkanState::WaitForLastFrame() {
+    m_graphicsTimeline.WaitFor(m_frameValue);
+    if (HasAsyncCompute()) {
+        m_computeTimeline.WaitFor(m_postValue);
+    }
 }
 
-void VulkanState::CopyToPresentImage(const VulkanImage &image) {
-    vk_util::CmdImageLayoutTransition(
-        m_cmdBuf,
-        m_swapchain.images[m_presentImageIndex],
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_ASPECT_COLOR_BIT,
+bool VulkanState::WaitForPresent(uint64_t presentId, uint64_t timeout) const {
+    DEBUG_ASSERT(HasPresentWait());
+    const VkResult result = m_waitForPresent(m_device, m_swapchain.swapchain, presentId, timeout);
+    return result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR;
+}
+
+VkCommandBuffer VulkanState::BeginAsyncCompute() {
+    DEBUG_ASSERT(HasAsyncCompute());
+
+    // The previous post chain has to retire before its command buffer is reused
+    m_computeTimeline.WaitFor(m_postValue);
+    DEBUG_VK_ASSERT(vkResetCommandBuffer(m_computeCmdBuf, 0));
+    BeginCommandBuffer(m_computeCmdBuf, 0);
+
+    m_asyncComputeFrame = true;
+    return m_computeCmdBuf;
+}
+
+uint64_t VulkanState::UploadSubmit(
+    const std::function<void(VkCommandBuffer)> &copy,
+    std::vector<VkBufferMemoryBarrier>          bufferBarriers,
+    std::vector<VkImageMemoryBarrier>           imageBarriers,
+    VkPipelineStageFlags                        dstStage,
+    const std::function<void(VkCommandBuffer)> &use
+) {
+    // Staging buffers of earlier uploads are released once their submits retire
+    m_releaseQueue.Collect();
+
+    if (!HasTransferQueue()) {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        UploadCommands              &commands = AcquireUploadCommands();
+
+        BeginCommandBuffer(commands.graphics, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        copy(commands.graphics);
+        vkCmdPipelineBarrier(
+            commands.graphics,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            dstStage,
+            0,
+            0,
+            nullptr,
+            static_cast<uint32_t>(bufferBarriers.size()),
+            bufferBarriers.data(),
+            static_cast<uint32_t>(imageBarriers.size()),
+            imageBarriers.data()
+        );
+        if (use) {
+            use(commands.graphics);
+        }
+        DEBUG_VK_ASSERT(vkEndCommandBuffer(commands.graphics));
+        commands.value = m_graphicsTimeline.Submit(commands.graphics);
+        return commands.value;
+    }
+
+    // The release makes the copies available, the destination access only applies to the acquire on the graphics queue
+    const auto split = [this](auto &acquires) {
+        auto releases = acquires;
+        for (size_t i = 0; i < acquires.size(); i++) {
+            releases[i].srcQueueFamilyIndex = acquires[i].srcQueueFamilyIndex = m_queueFamilies.transfer;
+            releases[i].dstQueueFamilyIndex = acquires[i].dstQueueFamilyIndex = m_queueFamilies.graphics;
+            releases[i].dstAccessMask       = 0;
+            acquires[i].srcAccessMask       = 0;
+        }
+        return releases;
+    };
+    const std::vector<VkBufferMemoryBarrier> releaseBuffers = split(bufferBarriers);
+    const std::vector<VkImageMemoryBarrier>  releaseImages  = split(imageBarriers);
+
+    // The upload pools are shared by every uploading thread
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    UploadCommands              &commands = AcquireUploadCommands();
+
+    BeginCommandBuffer(commands.transfer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    copy(commands.transfer);
+    vkCmdPipelineBarrier(
+        commands.transfer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
         0,
-        VK_ACCESS_TRANSFER_WRITE_BIT
+        nullptr,
+        static_cast<uint32_t>(releaseBuffers.size()),
+        releaseBuffers.data(),
+        static_cast<uint32_t>(releaseImages.size()),
+        releaseImages.data()
     );
-
-    // Copy draw image to the current swapchain image
-    vk_util::CmdCopyImageToImage(
-        m_cmdBuf,
-        image.GetImage(),
-        m_swapchain.images[m_presentImageIndex],
-        image.GetExtent(),
-        {m_width, m_height, 1},
-        VK_IMAGE_ASPECT_COLOR_BIT
+    DEBUG_VK_ASSERT(vkEndCommandBuffer(commands.transfer));
+    const uint64_t copied = m_transferTimeline.Submit(commands.transfer);
+
+    // The acquire waits for the copies at the stage it runs in, so its layout transition is ordered after the release
+    BeginCommandBuffer(commands.graphics, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    vkCmdPipelineBarrier(
+        commands.graphics,
+        dstStage,
+        dstStage,
+        0,
+        0,
+        nullptr,
+        static_cast<uint32_t>(bufferBarriers.size()),
+        bufferBarriers.data(),
+        static_cast<uint32_t>(imageBarriers.size()),
+        imageBarriers.data()
     );
+    if (use) {
+        use(commands.graphics);
+    }
+    DEBUG_VK_ASSERT(vkEndCommandBuffer(commands.graphics));
+
+    // The graphics side waits for the transfer side, so its value covers both command buffers
+    commands.value = m_graphicsTimeline.Submit(commands.graphics, {m_transferTimeline.After(copied, dstStage)});
+    return commands.value;
+}
+
+VulkanState::UploadCommands &VulkanState::AcquireUploadCommands() {
+    const auto retired =
+        std::ranges::find_if(m_uploads, [this](const UploadCommands &commands) { return m_graphicsTimeline.IsComplete(commands.value); });
+    if (retired != m_uploads.end()) {
+        DEBUG_VK_ASSERT(vkResetCommandBuffer(retired->graphics, 0));
+        if (retired->transfer != VK_NULL_HANDLE) {
+            DEBUG_VK_ASSERT(vkResetCommandBuffer(retired->transfer, 0));
+        }
+        return *retired;
+    }
+
+    // Every upload in flight holds its own command buffers, so the pools grow to the most uploads ever in flight at once
+    UploadCommands              commands;
+    VkCommandBufferAllocateInfo infoCmdBuffer{
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext              = nullptr,
+        .commandPool        = m_uploadCommandPool,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1,
+    };
+    DEBUG_VK_ASSERT(vkAllocateCommandBuffers(m_device, &infoCmdBuffer, &commands.graphics));
+    if (HasTransferQueue()) {
+        infoCmdBuffer.commandPool = m_transferCommandPool;
+        DEBUG_VK_ASSERT(vkAllocateCommandBuffers(m_device, &infoCmdBuffer, &commands.transfer));
+    }
+    return m_uploads.emplace_back(commands);
 }
 
 void VulkanState::CreateInstance() {
@@ -108,14 +329,28 @@ void VulkanState::CreateInstance() {
         .apiVersion         = VK_API_VERSION_1_4,
     };
 
-    // Enable validation layer
-    std::vector<const char *> layers{
-        "VK_LAYER_KHRONOS_validation",
-    };
+    // Enable validation layer, build machines running headless may not have it installed
+    uint32_t layerCount = 0;
+    DEBUG_VK_ASSERT(vkEnumerateInstanceLayerProperties(&layerCount, nullptr));
+    std::vector<VkLayerProperties> availableLayers(layerCount);
+    DEBUG_VK_ASSERT(vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data()));
+
+    std::vector<const char *> layers;
+    if (std::ranges::any_of(availableLayers, [](const VkLayerProperties &layer) {
+            return std::string_view(layer.layerName) == "VK_LAYER_KHRONOS_validation";
+        })) {
+        layers.push_back("VK_LAYER_KHRONOS_validation");
+    } else {
+        SDL_Log("Validation layer unavailable");
+    }
 
-    uint32_t                  sdlExtensionCount = 0;
-    const char * const       *sdlExtensions     = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
-    std::vector<const char *> extensions(sdlExtensions, sdlExtensions + sdlExtensionCount);
+    // Headless runs never touch SDL video, so only windowed runs ask it for surface extensions
+    std::vector<const char *> extensions;
+    if (!m_headless) {
+        uint32_t           sdlExtensionCount = 0;
+        const char * const *sdlExtensions    = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
+        extensions.assign(sdlExtensions, sdlExtensions + sdlExtensionCount);
+    }
     extensions.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 
     VkInstanceCreateInfo infoInstance{
@@ -166,41 +401,144 @@ void VulkanState::CreatePhysicalDevice() {
     );
 }
 
+QueueFamilies VulkanState::ChooseQueueFamilies() const {
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, families.data());
+
+    const auto find = [&families](VkQueueFlags required, VkQueueFlags excluded) -> std::optional<uint32_t> {
+        for (uint32_t i = 0; i < families.size(); i++) {
+            if ((families[i].queueFlags & required) == required && (families[i].queueFlags & excluded) == 0) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    };
+
+    // Culling and the post chain run compute on the graphics queue
+    const std::optional<uint32_t> graphics = find(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0);
+    DEBUG_ASSERT_LOG(graphics.has_value(), "No queue family supports both graphics and compute");
+
+    // A pure copy engine runs next to the graphics work, a compute family is the next best thing
+    std::optional<uint32_t> transfer = find(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+    if (!transfer) {
+        transfer = find(VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+    }
+
+    return {
+        .graphics = *graphics,
+        .transfer = transfer.value_or(*graphics),
+    };
+}
+
 void VulkanState::CreateDevice() {
-    float                   priority = 1.0f;
-    // Only use one queue, and use the first one
-    VkDeviceQueueCreateInfo infoQueue{
+    m_queueFamilies = ChooseQueueFamilies();
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, families.data());
+
+    // A second queue of the graphics family for async compute when it has one, plus one of the transfer family
+    const uint32_t                       queueCount    = std::min(families[m_queueFamilies.graphics].queueCount, 2u);
+    const bool                           transferQueue = m_queueFamilies.transfer != m_queueFamilies.graphics;
+    const float                          priorities[2] = {1.0f, 1.0f};
+    std::vector<VkDeviceQueueCreateInfo> infoQueues;
+    infoQueues.push_back({
         .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
         .pNext            = nullptr,
         .flags            = 0,
-        .queueFamilyIndex = 0,
-        .queueCount       = 1,
-        .pQueuePriorities = &priority,
-    };
+        .queueFamilyIndex = m_queueFamilies.graphics,
+        .queueCount       = queueCount,
+        .pQueuePriorities = priorities,
+    });
+    if (transferQueue) {
+        infoQueues.push_back({
+            .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .pNext            = nullptr,
+            .flags            = 0,
+            .queueFamilyIndex = m_queueFamilies.transfer,
+            .queueCount       = 1,
+            .pQueuePriorities = priorities,
+        });
+    }
 
-    // Enable swapchain extension for presenting on screen
     std::vector<const char *> extensions{
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         "VK_KHR_create_renderpass2",
         "VK_KHR_depth_stencil_resolve",
         "VK_KHR_dynamic_rendering",
         "VK_KHR_depth_stencil_resolve"
     };
+    // Enable swapchain extension for presenting on screen
+    if (!m_headless) {
+        extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+
+    // Present wait lets the frame pacer know when a frame reached the display
+    const bool presentWait = !m_headless && SupportsPresentWait();
+    if (presentWait) {
+        extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
 
-    VkPhysicalDeviceFeatures feature{.geometryShader = VK_TRUE, .sampleRateShading = VK_TRUE};
+    // Pipeline statistics only feed the GPU profiler, so they are optional
+    VkPhysicalDeviceFeatures supported;
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supported);
+    m_pipelineStatistics = supported.pipelineStatisticsQuery == VK_TRUE;
+
+    VkPhysicalDeviceFeatures feature{
+        .geometryShader                    = VK_TRUE,
+        .sampleRateShading                 = VK_TRUE,
+        .multiDrawIndirect                 = VK_TRUE,
+        .drawIndirectFirstInstance         = VK_TRUE,
+        .pipelineStatisticsQuery           = supported.pipelineStatisticsQuery,
+        .shaderStorageImageExtendedFormats = VK_TRUE,
+    };
+
+    // Multiview renders every shadow cascade in one pass
+    VkPhysicalDeviceVulkan11Features feature11{
+        .sType     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+        .pNext     = nullptr,
+        .multiview = VK_TRUE,
+    };
+
+    // Descriptor indexing backs the bindless texture table, timeline semaphores track each queue's progress
+    VkPhysicalDeviceVulkan12Features feature12{
+        .sType                                        = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext                                        = &feature11,
+        .drawIndirectCount                            = VK_TRUE,
+        .descriptorIndexing                           = VK_TRUE,
+        .shaderSampledImageArrayNonUniformIndexing    = VK_TRUE,
+        .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingPartiallyBound              = VK_TRUE,
+        .runtimeDescriptorArray                       = VK_TRUE,
+        .timelineSemaphore                            = VK_TRUE,
+    };
 
     VkPhysicalDeviceVulkan13Features feature13{
         .sType            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
-        .pNext            = nullptr,
+        .pNext            = &feature12,
         .dynamicRendering = VK_TRUE,
     };
 
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeature{
+        .sType     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+        .pNext     = &feature13,
+        .presentId = VK_TRUE,
+    };
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeature{
+        .sType       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+        .pNext       = &presentIdFeature,
+        .presentWait = VK_TRUE,
+    };
+
     VkDeviceCreateInfo infoDevice{
         .sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .pNext                   = &feature13,
+        .pNext                   = presentWait ? static_cast<void *>(&presentWaitFeature) : static_cast<void *>(&feature13),
         .flags                   = 0,
-        .queueCreateInfoCount    = 1,
-        .pQueueCreateInfos       = &infoQueue,
+        .queueCreateInfoCount    = static_cast<uint32_t>(infoQueues.size()),
+        .pQueueCreateInfos       = infoQueues.data(),
         .enabledLayerCount       = 0,
         .ppEnabledLayerNames     = nullptr,
         .enabledExtensionCount   = static_cast<uint32_t>(extensions.size()),
@@ -210,7 +548,25 @@ void VulkanState::CreateDevice() {
     DEBUG_VK_ASSERT(vkCreateDevice(m_physicalDevice, &infoDevice, nullptr, &m_device));
 
     // Get queue
-    vkGetDeviceQueue(m_device, 0, 0, &m_queue);
+    vkGetDeviceQueue(m_device, m_queueFamilies.graphics, 0, &m_queue);
+    if (queueCount > 1) {
+        vkGetDeviceQueue(m_device, m_queueFamilies.graphics, 1, &m_computeQueue);
+    }
+    if (transferQueue) {
+        vkGetDeviceQueue(m_device, m_queueFamilies.transfer, 0, &m_transferQueue);
+    }
+    SDL_Log("Graphics queue family %u", m_queueFamilies.graphics);
+    SDL_Log("Async compute %s", HasAsyncCompute() ? "available" : "unavailable, post-processing runs on the graphics queue");
+    if (HasTransferQueue()) {
+        SDL_Log("Transfer queue family %u", m_queueFamilies.transfer);
+    } else {
+        SDL_Log("Transfer queue unavailable, uploads run on the graphics queue");
+    }
+
+    if (presentWait) {
+        m_waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(m_device, "vkWaitForPresentKHR"));
+    }
+    SDL_Log("Present wait %s", HasPresentWait() ? "available" : "unavailable, low latency waits for the GPU instead");
 
     m_deletionQueue.PushFunction([&]() { vkDestroyDevice(m_device, nullptr); });
 }
@@ -220,11 +576,24 @@ void VulkanState::CreateCommandPool() {
         .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
         .pNext            = nullptr,
         .flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-        .queueFamilyIndex = 0,
+        .queueFamilyIndex = m_queueFamilies.graphics,
     };
     DEBUG_VK_ASSERT(vkCreateCommandPool(m_device, &infoCommandPool, nullptr, &m_commandPool));
 
     m_deletionQueue.PushFunction([&]() { vkDestroyCommandPool(m_device, m_commandPool, nullptr); });
+
+    // Uploads record on loading threads while the render thread records frames, a pool is used by one thread at a time
+    DEBUG_VK_ASSERT(vkCreateCommandPool(m_device, &infoCommandPool, nullptr, &m_uploadCommandPool));
+
+    m_deletionQueue.PushFunction([&]() { vkDestroyCommandPool(m_device, m_uploadCommandPool, nullptr); });
+
+    // Command buffers are tied to the family of their pool
+    if (HasTransferQueue()) {
+        infoCommandPool.queueFamilyIndex = m_queueFamilies.transfer;
+        DEBUG_VK_ASSERT(vkCreateCommandPool(m_device, &infoCommandPool, nullptr, &m_transferCommandPool));
+
+        m_deletionQueue.PushFunction([&]() { vkDestroyCommandPool(m_device, m_transferCommandPool, nullptr); });
+    }
 }
 
 void VulkanState::CreateSurface(SDL_Window *window) {
@@ -233,13 +602,24 @@ void VulkanState::CreateSurface(SDL_Window *window) {
     m_deletionQueue.PushFunction([&]() { vkDestroySurfaceKHR(m_instance, m_surface, nullptr); });
 }
 
-void VulkanState::CreateSwapchain(uint32_t width, uint32_t height) {
+void VulkanState::CreateSwapchain(uint32_t width, uint32_t height, VkSwapchainKHR oldSwapchain) {
+    VkSurfaceCapabilitiesKHR capabilities;
+    DEBUG_VK_ASSERT(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physicalDevice, m_surface, &capabilities));
+
+    // No maximum is reported as 0
+    uint32_t imageCount = std::max({m_presentSettings.imageCount, capabilities.minImageCount, static_cast<uint32_t>(MIN_SWAPCHAIN_IMG_COUNT)});
+    imageCount          = std::min(imageCount, static_cast<uint32_t>(MAX_SWAPCHAIN_IMG_COUNT));
+    if (capabilities.maxImageCount > 0) {
+        imageCount = std::min(imageCount, capabilities.maxImageCount);
+    }
+    m_presentMode = ChoosePresentMode();
+
     VkSwapchainCreateInfoKHR infoSwapchain{
         .sType                 = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
         .pNext                 = nullptr,
         .flags                 = 0,
         .surface               = m_surface,
-        .minImageCount         = MIN_SWAPCHAIN_IMG_COUNT,
+        .minImageCount         = imageCount,
         .imageFormat           = VK_FORMAT_R16G16B16A16_SFLOAT,
         .imageColorSpace       = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR,
         .imageExtent           = {width, height},
@@ -250,15 +630,20 @@ void VulkanState::CreateSwapchain(uint32_t width, uint32_t height) {
         .pQueueFamilyIndices   = nullptr,
         .preTransform          = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
         .compositeAlpha        = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
-        .presentMode           = VK_PRESENT_MODE_FIFO_KHR,
+        .presentMode           = m_presentMode,
         .clipped               = false,
-        .oldSwapchain          = nullptr,
+        .oldSwapchain          = oldSwapchain,
     };
     DEBUG_VK_ASSERT(vkCreateSwapchainKHR(m_device, &infoSwapchain, nullptr, &m_swapchain.swapchain));
+    m_width  = width;
+    m_height = height;
 
     // Get swapchain images
     DEBUG_VK_ASSERT(vkGetSwapchainImagesKHR(m_device, m_swapchain.swapchain, &m_swapchain.count, nullptr));
     DEBUG_VK_ASSERT(vkGetSwapchainImagesKHR(m_device, m_swapchain.swapchain, &m_swapchain.count, m_swapchain.images));
+    SDL_Log(
+        "Swapchain of %u %ux%u images presenting with %s", m_swapchain.count, width, height, PresentSettings::GetPresentModeName(m_presentMode)
+    );
 
     // Create image view for each swapchain image
     {
@@ -279,7 +664,117 @@ void VulkanState::CreateSwapchain(uint32_t width, uint32_t height) {
         }
     }
 
-    m_deletionQueue.PushFunction([&]() { vkDestroySwapchainKHR(m_device, m_swapchain.swapchain, nullptr); });
+    // Recreations destroy the old swapchain themselves, this destroys whichever is current at shutdown
+    if (oldSwapchain == VK_NULL_HANDLE) {
+        m_deletionQueue.PushFunction([&]() { vkDestroySwapchainKHR(m_device, m_swapchain.swapchain, nullptr); });
+    }
+}
+
+bool VulkanState::RecreateSwapchain() {
+    const VkExtent2D extent = ChooseSwapchainExtent();
+    if (extent.width == 0 || extent.height == 0) {
+        // Minimized, stays dirty until the window has a size again
+        m_swapchainDirty = true;
+        return false;
+    }
+
+    // Old images and views go through the release queue, but size dependent descriptor sets are rewritten in place
+    // after this, so the last frame and its async post chain have to be done reading them
+    WaitForLastFrame();
+    DestroySwapchainViews();
+
+    // Handing the old swapchain over lets the presentation engine reuse its resources, it is retired but still has to be destroyed
+    const VkSwapchainKHR oldSwapchain = m_swapchain.swapchain;
+    CreateSwapchain(extent.width, extent.height, oldSwapchain);
+    m_releaseQueue.Release(VK_OBJECT_TYPE_SWAPCHAIN_KHR, oldSwapchain);
+
+    m_swapchainDirty = false;
+    m_swapchainGeneration++;
+    return true;
+}
+
+VkExtent2D VulkanState::ChooseSwapchainExtent() const {
+    VkSurfaceCapabilitiesKHR capabilities;
+    DEBUG_VK_ASSERT(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physicalDevice, m_surface, &capabilities));
+
+    // Surfaces sized by the swapchain report no current extent, the window's pixel size is used then
+    if (capabilities.currentExtent.width != UINT32_MAX) {
+        return capabilities.currentExtent;
+    }
+    return {
+        std::clamp(m_requestedWidth, capabilities.minImageExtent.width, capabilities.maxImageExtent.width),
+        std::clamp(m_requestedHeight, capabilities.minImageExtent.height, capabilities.maxImageExtent.height),
+    };
+}
+
+void VulkanState::DestroySwapchainViews() {
+    for (size_t i = 0; i < m_swapchain.count; i++) {
+        m_releaseQueue.Release(VK_OBJECT_TYPE_IMAGE_VIEW, m_swapchain.views[i]);
+        m_swapchain.views[i] = VK_NULL_HANDLE;
+    }
+}
+
+VkPresentModeKHR VulkanState::ChoosePresentMode() const {
+    uint32_t modeCount = 0;
+    DEBUG_VK_ASSERT(vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &modeCount, nullptr));
+    std::vector<VkPresentModeKHR> modes(modeCount);
+    DEBUG_VK_ASSERT(vkGetPhysicalDeviceSurfacePresentModesKHR(m_physicalDevice, m_surface, &modeCount, modes.data()));
+
+    // FIFO is the only mode every surface supports
+    if (std::ranges::find(modes, m_presentSettings.presentMode) == modes.end()) {
+        SDL_Log("Present mode %s unsupported, falling back to fifo", PresentSettings::GetPresentModeName(m_presentSettings.presentMode));
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+    return m_presentSettings.presentMode;
+}
+
+bool VulkanState::SupportsPresentWait() const {
+    uint32_t extensionCount = 0;
+    DEBUG_VK_ASSERT(vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr));
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    DEBUG_VK_ASSERT(vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, extensions.data()));
+
+    const auto hasExtension = [&extensions](std::string_view name) {
+        return std::ranges::any_of(extensions, [name](const VkExtensionProperties &extension) { return name == extension.extensionName; });
+    };
+    if (!hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) || !hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        return false;
+    }
+
+    VkPhysicalDevicePresentIdFeaturesKHR presentId{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+        .pNext = nullptr,
+    };
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWait{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+        .pNext = &presentId,
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &presentWait,
+    };
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features);
+    return presentId.presentId == VK_TRUE && presentWait.presentWait == VK_TRUE;
+}
+
+void VulkanState::CreateOffscreenTarget(uint32_t width, uint32_t height) {
+    VulkanImage image(
+        VK_FORMAT_R16G16B16A16_SFLOAT,
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+        {width, height, 1},
+        VK_IMAGE_ASPECT_COLOR_BIT
+    );
+    m_offscreenImage = std::move(image);
+
+    // Passes index the present image the same way as swapchain images
+    m_swapchain.images[0] = m_offscreenImage.GetImage();
+    m_swapchain.views[0]  = m_offscreenImage.GetImageView();
+    m_swapchain.count     = 1;
+
+    m_deletionQueue.PushFunction([&]() {
+        m_offscreenImage.Destroy();
+        m_releaseQueue.Flush();
+    });
 }
 
 VkSemaphore VulkanState::CreateSemaphore() {
@@ -297,20 +792,6 @@ VkSemaphore VulkanState::CreateSemaphore() {
     return semaphore;
 }
 
-VkFence VulkanState::CreateFence(const VkFenceCreateFlags flag) {
-    VkFence           fence = VK_NULL_HANDLE;
-    VkFenceCreateInfo createInfo{
-        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-        .pNext = nullptr,
-        .flags = flag,
-    };
-    DEBUG_VK_ASSERT(vkCreateFence(m_device, &createInfo, nullptr, &fence));
-
-    m_deletionQueue.PushFunction([this, fence]() { vkDestroyFence(m_device, fence, nullptr); });
-
-    return fence;
-}
-
 void VulkanState::CreateCommandBuffer() {
     VkCommandBufferAllocateInfo infoCmdBuffer{
         .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
@@ -320,32 +801,18 @@ void VulkanState::CreateCommandBuffer() {
         .commandBufferCount = 1,
     };
     DEBUG_VK_ASSERT(vkAllocateCommandBuffers(m_device, &infoCmdBuffer, &m_cmdBuf));
-    DEBUG_VK_ASSERT(vkAllocateCommandBuffers(m_device, &infoCmdBuffer, &m_immediateCmdBuf));
+    DEBUG_VK_ASSERT(vkAllocateCommandBuffers(m_device, &infoCmdBuffer, &m_computeCmdBuf));
 
     m_deletionQueue.PushFunction([&]() { vkFreeCommandBuffers(m_device, m_commandPool, 1, &m_cmdBuf); });
-    m_deletionQueue.PushFunction([&]() { vkFreeCommandBuffers(m_device, m_commandPool, 1, &m_immediateCmdBuf); });
-}
-
-void VulkanState::CreateDescriptorPool() {
-    VkDescriptorPoolSize poolSize{
-        .type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-        .descriptorCount = 1,
-    };
+    m_deletionQueue.PushFunction([&]() { vkFreeCommandBuffers(m_device, m_commandPool, 1, &m_computeCmdBuf); });
 
-    // TODO: This is just for testing for now
-    // Needs to update in the future
-    VkDescriptorPoolCreateInfo infoPool{
-        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .pNext         = nullptr,
-        .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
-        .maxSets       = descriptor::MAX_SET_COUNT,
-        .poolSizeCount = 1,
-        .pPoolSizes    = &poolSize
-    };
+    // Upload command buffers are allocated on demand and freed with their pools
+}
 
-    DEBUG_VK_ASSERT(vkCreateDescriptorPool(m_device, &infoPool, nullptr, &m_descriptorPool));
+void VulkanState::CreateDescriptorPools() {
+    m_descriptorAllocator.Init(m_device);
 
-    m_deletionQueue.PushFunction([&]() { vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr); });
+    m_deletionQueue.PushFunction([&]() { m_descriptorAllocator.Destroy(); });
 
     // Create descriptor pool for ImGui
     VkDescriptorPoolSize poolSizes[]{
@@ -362,21 +829,25 @@ void VulkanState::CreateDescriptorPool() {
         {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,       1000}
     };
 
-    infoPool.maxSets       = 1000;
-    infoPool.poolSizeCount = static_cast<uint32_t>(std::size(poolSizes));
-    infoPool.pPoolSizes    = poolSizes;
+    VkDescriptorPoolCreateInfo infoPool{
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext         = nullptr,
+        .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+        .maxSets       = 1000,
+        .poolSizeCount = static_cast<uint32_t>(std::size(poolSizes)),
+        .pPoolSizes    = poolSizes,
+    };
 
     DEBUG_VK_ASSERT(vkCreateDescriptorPool(m_device, &infoPool, nullptr, &m_imguiDescriptorPool));
     m_deletionQueue.PushFunction([&]() { vkDestroyDescriptorPool(m_device, m_imguiDescriptorPool, nullptr); });
 }
 
-void VulkanState::WaitIdle() {
-    DEBUG_VK_ASSERT(vkDeviceWaitIdle(m_device));
+void VulkanState::AddDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo &info) {
+    m_descriptorAllocator.AddLayout(info);
 }
 
-void VulkanState::WaitAndResetFence(VkFence fence, uint64_t timeout) {
-    DEBUG_VK_ASSERT(vkWaitForFences(m_device, 1, &fence, true, timeout));
-    DEBUG_VK_ASSERT(vkResetFences(m_device, 1, &fence));
+void VulkanState::WaitIdle() {
+    DEBUG_VK_ASSERT(vkDeviceWaitIdle(m_device));
 }
 
 void VulkanState::BeginCommandBuffer(VkCommandBuffer cmdBuf, VkCommandBufferUsageFlags const flag) {
@@ -389,37 +860,19 @@ void VulkanState::BeginCommandBuffer(VkCommandBuffer cmdBuf, VkCommandBufferUsag
     DEBUG_VK_ASSERT(vkBeginCommandBuffer(cmdBuf, &infoBegin));
 }
 
-void VulkanState::EndAndSubmitCommandBuffer(
-    VkCommandBuffer            cmdBuf,
-    VkPipelineStageFlags const waitStageMask,
-    VkFence                    fence,
-    VkSemaphore                waitSemaphore,
-    VkSemaphore                signalSemaphore
-) {
-    DEBUG_VK_ASSERT(vkEndCommandBuffer(cmdBuf));
-
-    VkSubmitInfo infoSubmit{
-        .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .pNext              = nullptr,
-        .pWaitSemaphores    = &waitSemaphore,
-        .pWaitDstStageMask  = &waitStageMask,
-        .commandBufferCount = 1,
-        .pCommandBuffers    = &cmdBuf,
-        .pSignalSemaphores  = &signalSemaphore,
+void VulkanState::QueuePresent(VkSemaphore waitSemaphore) {
+    // Ids let the frame pacer wait for this present to reach the display
+    m_presentId++;
+    VkPresentIdKHR infoPresentId{
+        .sType          = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+        .pNext          = nullptr,
+        .swapchainCount = 1,
+        .pPresentIds    = &m_presentId,
     };
-    if (waitSemaphore != VK_NULL_HANDLE) {
-        infoSubmit.waitSemaphoreCount = 1;
-    }
-    if (signalSemaphore != VK_NULL_HANDLE) {
-        infoSubmit.signalSemaphoreCount = 1;
-    }
-    DEBUG_VK_ASSERT(vkQueueSubmit(m_queue, 1, &infoSubmit, fence));
-}
 
-void VulkanState::QueuePresent(VkSemaphore waitSemaphore) {
     VkPresentInfoKHR infoPresent{
         .sType           = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .pNext           = nullptr,
+        .pNext           = HasPresentWait() ? &infoPresentId : nullptr,
         .pWaitSemaphores = &waitSemaphore,
         .swapchainCount  = 1,
         .pSwapchains     = &m_swapchain.swapchain,
@@ -429,10 +882,30 @@ void VulkanState::QueuePresent(VkSemaphore waitSemaphore) {
     if (waitSemaphore != VK_NULL_HANDLE) {
         infoPresent.waitSemaphoreCount = 1;
     }
-    DEBUG_VK_ASSERT(vkQueuePresentKHR(m_queue, &infoPresent));
+
+    // A rejected present still waits its semaphore, only the swapchain has to be recreated
+    const VkResult result = m_graphicsTimeline.Present(infoPresent);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        m_swapchainDirty = true;
+        return;
+    }
+    DEBUG_VK_ASSERT(result);
 }
 
-void VulkanState::AcquireNextImage() {
+bool VulkanState::AcquireNextImage() {
     // Acquire next image in the swapchain for presenting
-    DEBUG_VK_ASSERT(vkAcquireNextImageKHR(m_device, m_swapchain.swapchain, POINT_ONE_SECOND, m_presentSemaphore, nullptr, &m_presentImageIndex));
+    // FIFO with a slow display or a deep swapchain can block for several frames, so there is no timeout
+    const VkSemaphore semaphore = m_acquireSemaphores[m_acquireIndex].semaphore;
+    const VkResult    result    = vkAcquireNextImageKHR(m_device, m_swapchain.swapchain, UINT64_MAX, semaphore, VK_NULL_HANDLE, &m_presentImageIndex);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        m_swapchainDirty = true;
+        return false;
+    }
+    DEBUG_ASSERT(result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR);
+
+    // A suboptimal image is still presented, the swapchain is recreated before the next acquire
+    if (result == VK_SUBOPTIMAL_KHR) {
+        m_swapchainDirty = true;
+    }
+    return true;
 }
@@ -2,8 +2,48 @@
 
 #include <SDL3/SDL.h>
 
+#include <algorithm>
+
 #include <include/VulkanState.h>
 
+namespace {
+// Stages able to perform the accesses, shader accesses are limited to the stages the renderer uses
+VkPipelineStageFlags GetAccessStages(VkAccessFlags access) {
+    constexpr VkPipelineStageFlags SHADER_STAGES =
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    VkPipelineStageFlags stages = 0;
+    if (access & VK_ACCESS_INDIRECT_COMMAND_READ_BIT) {
+        stages |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    }
+    if (access & (VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT)) {
+        stages |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    }
+    if (access & (VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT)) {
+        stages |= SHADER_STAGES;
+    }
+    if (access & VK_ACCESS_INPUT_ATTACHMENT_READ_BIT) {
+        stages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    }
+    if (access & (VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT)) {
+        stages |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    }
+    if (access & (VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT)) {
+        stages |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    }
+    if (access & (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT)) {
+        stages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+    if (access & (VK_ACCESS_HOST_READ_BIT | VK_ACCESS_HOST_WRITE_BIT)) {
+        stages |= VK_PIPELINE_STAGE_HOST_BIT;
+    }
+    if (access & (VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT)) {
+        stages |= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    return stages;
+}
+} // namespace
+
 void vk_util::CmdImageLayoutTransition(
     VkCommandBuffer    cmdBuf,
     VkImage            image,
@@ -30,7 +70,35 @@ void vk_util::CmdImageLayoutTransition(
         .subresourceRange    = GetSubresourceRange(aspect, baseLevel, levelCount, baseLayer, arrayLayers),
     };
 
-    vkCmdPipelineBarrier(cmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    // Waiting on ALL_COMMANDS would chain every transition to the wait on the last async post chain,
+    // the source also covers the stages of the new access so the transition still follows a semaphore wait on them
+    VkPipelineStageFlags srcStage = GetAccessStages(srcAccess) | GetAccessStages(dstAccess);
+    VkPipelineStageFlags dstStage = GetAccessStages(dstAccess);
+    if (srcStage == 0) {
+        srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    }
+    if (dstStage == 0) {
+        dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    }
+
+    vkCmdPipelineBarrier(cmdBuf, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void vk_util::CmdMemoryBarrier(
+    VkCommandBuffer      cmdBuf,
+    VkPipelineStageFlags srcStage,
+    VkPipelineStageFlags dstStage,
+    VkAccessFlags        srcAccess,
+    VkAccessFlags        dstAccess
+) {
+    VkMemoryBarrier barrier{
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext         = nullptr,
+        .srcAccessMask = srcAccess,
+        .dstAccessMask = dstAccess,
+    };
+
+    vkCmdPipelineBarrier(cmdBuf, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
 }
 
 VkImageSubresourceRange vk_util::GetSubresourceRange(
@@ -191,19 +259,11 @@ VkRenderingInfo vk_util::GetRenderingInfo(
 }
 
 VkDescriptorSet vk_util::CreateDescriptorSet(const VkDescriptorSetLayout &layout) {
-    VkDescriptorSet set = VK_NULL_HANDLE;
-
-    VkDescriptorSetAllocateInfo infoSet{
-        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-        .pNext              = nullptr,
-        .descriptorPool     = VulkanState::GetInstance().GetDescriptorPool(),
-        .descriptorSetCount = 1,
-        .pSetLayouts        = &layout
-    };
-
-    DEBUG_VK_ASSERT(vkAllocateDescriptorSets(VulkanState::GetInstance().GetDevice(), &infoSet, &set));
+    return VulkanState::GetInstance().GetDescriptorAllocator().Allocate(layout);
+}
 
-    return set;
+void vk_util::FreeDescriptorSet(VkDescriptorSet set) {
+    VulkanState::GetInstance().GetReleaseQueue().Release(VK_OBJECT_TYPE_DESCRIPTOR_SET, set);
 }
 
 void vk_util::CmdBlitMipmap(
@@ -228,3 +288,23 @@ void vk_util::CmdBlitMipmap(
 
     vkCmdBlitImage(cmdBuf, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
 }
+
+VkExtent2D vk_util::GetTargetExtent(VkExtent2D current, VkExtent2D required) {
+    // Grown targets get an eighth of headroom, rounded to whole tiles
+    constexpr uint32_t granularity = 64;
+    constexpr uint32_t minArea     = 2; // Fraction of the target area that has to stay in use
+
+    // The first allocation has nothing to keep headroom for
+    if (current.width == 0 || current.height == 0) {
+        return required;
+    }
+
+    const bool fits   = required.width <= current.width && required.height <= current.height;
+    const bool wasted = static_cast<uint64_t>(required.width) * required.height * minArea < static_cast<uint64_t>(current.width) * current.height;
+    if (fits && !wasted) {
+        return current;
+    }
+
+    const auto grow = [](uint32_t size) { return std::max((size + size / 8 + granularity - 1) / granularity * granularity, granularity); };
+    return {grow(required.width), grow(required.height)};
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include <Singleton.h>
+#include <include/VulkanBuffer.h>
+
+class VulkanTexture;
+
+// Per material texture indices, mirrors bindless.glsl
+struct MaterialData {
+    uint32_t albedo   = 0;
+    uint32_t normal   = 0;
+    uint32_t orm      = 0;
+    uint32_t emissive = 0;
+};
+
+// Every material texture in one update after bind sampler array, indexed by the material buffer
+class BindlessTable : public Singleton<BindlessTable> {
+public:
+    static constexpr uint32_t MAX_MATERIAL_COUNT = 1024;
+
+    // Needs the pipelines loaded
+    void Init();
+
+    void Destroy();
+
+    // Returns the material's index into the material buffer
+    uint32_t AddMaterial(const VulkanTexture *albedo, const VulkanTexture *normal, const VulkanTexture *orm, const VulkanTexture *emissive);
+
+    // Bound once per pass at TEXTURE_SET
+    [[nodiscard]] VkDescriptorSet GetDescriptorSet() const { return m_descriptorSet; }
+
+protected:
+    BindlessTable()  = default;
+    ~BindlessTable() = default;
+
+private:
+    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet  m_descriptorSet  = VK_NULL_HANDLE;
+    VulkanBuffer     m_materialBuffer;
+
+    std::unordered_map<const VulkanTexture *, uint32_t> m_textureIndices;
+    std::vector<MaterialData>                           m_materials;
+    std::mutex                                          m_mutex;
+
+    uint32_t AddTexture(const VulkanTexture *texture);
+};
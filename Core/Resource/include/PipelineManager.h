@@ -1,32 +1,71 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
 
 #include "ResourceManager.h"
 #include <Singleton.h>
+#include <include/FileWatcher.h>
+#include <include/VulkanGraphicsPipeline.h>
 #include <include/VulkanPipeline.h>
 
-class GraphicsPipelineOption;
-
 class PipelineManager
     : public Singleton<PipelineManager>
     , public ResourceManager<PipelineManager, std::unique_ptr<VulkanPipeline>> {
 public:
     void Init();
 
-    void Destroy() { DestroyAll(); }
+    void Destroy();
+
+    // Swaps in pipelines rebuilt since the last call and starts rebuilding those whose shaders or headers changed
+    // Called on the render thread between frames, pipelines loaded before stay valid until the frames using them retire
+    void Update();
 
 protected:
     PipelineManager()  = default;
     ~PipelineManager() = default;
 
 private:
-    std::unique_ptr<VulkanPipeline> CreateResource(
-        const std::string             &key,
-        const std::vector<std::string> files,
-        const GraphicsPipelineOption  &option
+    // What a pipeline is built from, kept to rebuild it
+    struct PipelineSource {
+        std::vector<std::string>              files;
+        std::optional<GraphicsPipelineOption> option; // Compute pipelines have none
+        std::set<std::string>                 includes;
+        uint64_t                              generation = 0; // Bumped per change, rebuilds of older ones are dropped
+    };
+
+    struct RebuiltPipeline {
+        Key                             key;
+        uint64_t                        generation = 0;
+        std::unique_ptr<VulkanPipeline> pipeline;
+        std::set<std::string>           includes;
+    };
+
+    // Complete before the first pipeline is built, workers only fill in the includes of their own entry
+    std::map<Key, PipelineSource> m_sources;
+
+    std::vector<RebuiltPipeline> m_rebuilt;
+    std::mutex                   m_rebuiltMutex;
+
+    file_system::FileWatcher m_watcher;
+
+    std::unique_ptr<VulkanPipeline> CreateResource(const std::string &key);
+
+    void Rebuild(const Key &key, const PipelineSource &source, const std::shared_ptr<const VulkanPipelineLayout> &pipelineLayout, uint32_t id);
+
+    void SwapRebuilt();
+
+    void RebuildChanged();
+
+    static std::unique_ptr<VulkanPipeline> CreatePipeline(
+        const PipelineSource                       &source,
+        const ShaderCompiler                       &shaderCompiler,
+        std::shared_ptr<const VulkanPipelineLayout> pipelineLayout,
+        uint32_t                                    id
     );
-    std::unique_ptr<VulkanPipeline> CreateResource(const std::string &key, const std::vector<std::string> files);
 
     friend class ResourceManager<PipelineManager, std::unique_ptr<VulkanPipeline>>;
-};
\ No newline at end of file
+};
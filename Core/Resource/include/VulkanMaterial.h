@@ -1,20 +1,12 @@
 #pragma once
 
-#include <vulkan/vulkan.h>
-
-#include <include/VulkanGraphicsPipeline.h>
+#include <cstdint>
 
 class VulkanTexture;
 
 class VulkanMaterial {
 public:
-    VulkanMaterial(
-        const VulkanTexture          *albedo,
-        const VulkanTexture          *normal,
-        const VulkanTexture          *orm,
-        const VulkanTexture          *emissive,
-        const VulkanGraphicsPipeline *pipeline
-    );
+    VulkanMaterial(const VulkanTexture *albedo, const VulkanTexture *normal, const VulkanTexture *orm, const VulkanTexture *emissive);
 
     VulkanMaterial() = delete;
 
@@ -38,15 +30,18 @@ public:
 
     void Destroy();
 
-    void Bind(VkPipelineLayout layout, uint32_t firstSet) const;
+    // Unique per material, 0 is never used
+    [[nodiscard]] uint32_t GetId() const { return m_id; }
+
+    // Index into the bindless material buffer, read by shaders through the instance data
+    [[nodiscard]] uint32_t GetIndex() const { return m_index; }
 
 private:
+    uint32_t m_id    = 0;
+    uint32_t m_index = 0;
+
     const VulkanTexture *m_albedo   = nullptr;
     const VulkanTexture *m_normal   = nullptr;
     const VulkanTexture *m_orm      = nullptr;
     const VulkanTexture *m_emissive = nullptr;
-
-    VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
-
-    void OneTimeUpdateDescriptorSets();
-};
\ No newline at end of file
+};
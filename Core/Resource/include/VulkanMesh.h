@@ -2,13 +2,14 @@
 
 #include <string>
 
+#include <include/Bounds.h>
 #include <include/VulkanBuffer.h>
 
 class VulkanMesh {
 public:
     VulkanMesh() = default;
 
-    VulkanMesh(std::string name, size_t vertexCount, size_t vertexSize, const void *data);
+    VulkanMesh(std::string name, size_t vertexCount, size_t vertexSize, const void *data, const Bounds &bounds = {});
 
     ~VulkanMesh() { Destroy(); }
 
@@ -32,11 +33,24 @@ public:
 
     void BindAndDraw() const;
 
+    void Bind() const;
+
+    void Draw(uint32_t instanceCount, uint32_t firstInstance) const;
+
     [[nodiscard]] const std::string& GetName() const { return m_name; }
 
+    [[nodiscard]] const Bounds &GetBounds() const { return m_bounds; }
+
+    [[nodiscard]] uint32_t GetVertexCount() const { return static_cast<uint32_t>(m_vertexCount); }
+
+    // Unique per mesh, 0 is never used
+    [[nodiscard]] uint32_t GetId() const { return m_id; }
+
 private:
     VulkanBuffer m_vertexBuffer;
+    uint32_t     m_id          = 0;
     size_t       m_vertexCount = 0;
     size_t       m_vertexSize  = 0;
     std::string  m_name;
+    Bounds       m_bounds;
 };
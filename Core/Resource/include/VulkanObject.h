@@ -37,12 +37,15 @@ public:
     void Swap(VulkanObject &other) noexcept;
     void Destroy();
 
-    void BindAndDraw(VkPipelineLayout layout) const;
-
-    void BindAndDrawMesh(VkPipelineLayout layout) const;
+    // Instances select their transforms and materials through the instance index buffer
+    void BindAndDrawMesh(uint32_t instanceCount, uint32_t firstInstance) const;
 
     [[nodiscard]] const std::string &GetName() const { return m_mesh->GetName(); }
 
+    [[nodiscard]] const VulkanMesh *GetMesh() const { return m_mesh; }
+
+    [[nodiscard]] const VulkanMaterial *GetMaterial() const { return m_material; }
+
 private:
     const VulkanMesh     *m_mesh     = nullptr;
     const VulkanMaterial *m_material = nullptr;
@@ -49,10 +49,6 @@ public:
 
     void Reset();
 
-    void BindAndDraw(VkPipelineLayout pipeline) const;
-
-    void BindAndDrawMesh(VkPipelineLayout pipeline) const;
-
     [[nodiscard]] const std::string GetName() const { return m_object->GetName(); }
 
     [[nodiscard]] const glm::vec3 GetLocation() const { return m_location; }
@@ -61,6 +57,12 @@ public:
 
     [[nodiscard]] const glm::vec3 GetPitchYawRoll() const { return m_pitchYawRoll; }
 
+    [[nodiscard]] const glm::mat4 &GetTransformation() const { return m_transformation; }
+
+    [[nodiscard]] const Bounds &GetBounds() const { return m_object->GetMesh()->GetBounds(); }
+
+    [[nodiscard]] const VulkanObject *GetObject() const { return m_object; }
+
 private:
     const VulkanObject *m_object;
 
@@ -1,21 +1,8 @@
 #pragma once
 
+#include <include/SamplerCache.h>
 #include <include/VulkanImage.h>
 
-// TODO: add more config if needed
-struct SamplerConfig {
-    VkFilter             filter           = VK_FILTER_LINEAR;
-    VkSamplerMipmapMode  mipmapMode       = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    VkSamplerAddressMode addressMode      = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    VkBool32             anisotropyEnable = VK_FALSE;
-    float                maxAnisotropy    = 1.0f;
-    VkBool32             compareEnable    = VK_FALSE;
-    VkCompareOp          compareOp        = VK_COMPARE_OP_ALWAYS;
-    float                minLod           = 0.0f;
-    float                maxLod           = VK_LOD_CLAMP_NONE;
-    VkBorderColor        borderColor      = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-};
-
 class VulkanTexture {
 public:
     VulkanTexture() = default;
@@ -43,17 +30,17 @@ public:
 
     void Swap(VulkanTexture &other) noexcept;
 
+    // Shared with every texture of an equal sampler config
     [[nodiscard]] VkSampler GetSampler() const { return m_sampler; }
 
     [[nodiscard]] VkImageView GetImageView() const { return m_image.GetImageView(); }
 
 private:
-    VulkanImage m_image;
-    VkSampler   m_sampler = VK_NULL_HANDLE;
+    VulkanImage   m_image;
+    SamplerConfig m_samplerConfig;
+    VkSampler     m_sampler = VK_NULL_HANDLE;
 
     void CreateImage(uint32_t width, uint32_t height, VkFormat format, size_t formatSize, const void *data);
 
-    void CreateSampler(SamplerConfig config);
-
     void GenerateMipmaps(VkCommandBuffer cmdBuf, VkImage image, uint32_t width, uint32_t height, VkFormat format, uint32_t mipLevels);
 };
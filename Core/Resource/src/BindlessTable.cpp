@@ -0,0 +1,130 @@
+#include "include/BindlessTable.h"
+
+#include <iterator>
+
+#include <Debug.h>
+#include <include/CpuProfiler.h>
+#include <include/Descriptor.h>
+#include <include/PipelineManager.h>
+#include <include/ShaderCompiler.h>
+#include <include/VulkanState.h>
+#include <include/VulkanTexture.h>
+
+void BindlessTable::Init() {
+    PROFILE_ZONE("BindlessTable::Init");
+    const VkDevice device = VulkanState::GetInstance().GetDevice();
+
+    VkDescriptorPoolSize poolSizes[]{
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, ShaderCompiler::RUNTIME_ARRAY_SIZE},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         1                                 },
+    };
+
+    VkDescriptorPoolCreateInfo infoPool{
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext         = nullptr,
+        .flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets       = 1,
+        .poolSizeCount = static_cast<uint32_t>(std::size(poolSizes)),
+        .pPoolSizes    = poolSizes,
+    };
+    DEBUG_VK_ASSERT(vkCreateDescriptorPool(device, &infoPool, nullptr, &m_descriptorPool));
+
+    // The G-buffer and forward pipelines declare the same set through bindless.glsl
+    const VkDescriptorSetLayout layout = PipelineManager::GetInstance().Load("gbuffer_gfx")->GetDescriptorSetLayouts()[descriptor::TEXTURE_SET];
+
+    VkDescriptorSetAllocateInfo infoSet{
+        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext              = nullptr,
+        .descriptorPool     = m_descriptorPool,
+        .descriptorSetCount = 1,
+        .pSetLayouts        = &layout,
+    };
+    DEBUG_VK_ASSERT(vkAllocateDescriptorSets(device, &infoSet, &m_descriptorSet));
+
+    VulkanBuffer materialBuffer(sizeof(MaterialData) * MAX_MATERIAL_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_materialBuffer = std::move(materialBuffer);
+
+    VkDescriptorBufferInfo infoBuffer{.buffer = m_materialBuffer.GetBuffer(), .offset = 0, .range = VK_WHOLE_SIZE};
+
+    VkWriteDescriptorSet writeSet{
+        .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext            = nullptr,
+        .dstSet           = m_descriptorSet,
+        .dstBinding       = 1,
+        .dstArrayElement  = 0,
+        .descriptorCount  = 1,
+        .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pImageInfo       = nullptr,
+        .pBufferInfo      = &infoBuffer,
+        .pTexelBufferView = nullptr,
+    };
+    vkUpdateDescriptorSets(device, 1, &writeSet, 0, nullptr);
+}
+
+void BindlessTable::Destroy() {
+    m_materialBuffer.Destroy();
+
+    if (m_descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(VulkanState::GetInstance().GetDevice(), m_descriptorPool, nullptr);
+    }
+    m_descriptorPool = VK_NULL_HANDLE;
+    m_descriptorSet  = VK_NULL_HANDLE;
+
+    m_textureIndices.clear();
+    m_materials.clear();
+}
+
+uint32_t BindlessTable::AddMaterial(
+    const VulkanTexture *albedo,
+    const VulkanTexture *normal,
+    const VulkanTexture *orm,
+    const VulkanTexture *emissive
+) {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+
+    DEBUG_ASSERT(m_materials.size() < MAX_MATERIAL_COUNT);
+
+    m_materials.push_back({
+        .albedo   = AddTexture(albedo),
+        .normal   = AddTexture(normal),
+        .orm      = AddTexture(orm),
+        .emissive = AddTexture(emissive),
+    });
+    m_materialBuffer.Upload(sizeof(MaterialData) * m_materials.size(), m_materials.data());
+
+    return static_cast<uint32_t>(m_materials.size() - 1);
+}
+
+uint32_t BindlessTable::AddTexture(const VulkanTexture *texture) {
+    // Textures shared between materials take one slot
+    auto pair = m_textureIndices.find(texture);
+    if (pair != m_textureIndices.end()) {
+        return pair->second;
+    }
+
+    const auto index = static_cast<uint32_t>(m_textureIndices.size());
+    DEBUG_ASSERT(index < ShaderCompiler::RUNTIME_ARRAY_SIZE);
+
+    VkDescriptorImageInfo infoImage{
+        .sampler     = texture->GetSampler(),
+        .imageView   = texture->GetImageView(),
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
+
+    VkWriteDescriptorSet writeSet{
+        .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext            = nullptr,
+        .dstSet           = m_descriptorSet,
+        .dstBinding       = 0,
+        .dstArrayElement  = index,
+        .descriptorCount  = 1,
+        .descriptorType   = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .pImageInfo       = &infoImage,
+        .pBufferInfo      = nullptr,
+        .pTexelBufferView = nullptr,
+    };
+    vkUpdateDescriptorSets(VulkanState::GetInstance().GetDevice(), 1, &writeSet, 0, nullptr);
+
+    m_textureIndices.emplace(texture, index);
+    return index;
+}
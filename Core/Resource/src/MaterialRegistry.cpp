@@ -4,24 +4,24 @@
 #include <vector>
 
 #include <include/ThreadPool.h>
+#include <include/CpuProfiler.h>
 #include <include/FileSystem.h>
 #include <include/JsonInput.h>
-#include <include/PipelineManager.h>
 #include <include/TextureManager.h>
-#include <include/VulkanGraphicsPipeline.h>
 
 VulkanMaterial MaterialRegistry::CreateResource(const std::string &key) {
+    PROFILE_ZONE("MaterialRegistry::CreateResource");
     file_system::MaterialConfig config(key);
     return VulkanMaterial(
         TextureManager::GetInstance().Load(config.albedo),
         TextureManager::GetInstance().Load(config.normal),
         TextureManager::GetInstance().Load(config.orm),
-        TextureManager::GetInstance().Load(config.emissive),
-        dynamic_cast<VulkanGraphicsPipeline *>(PipelineManager::GetInstance().Load("lighting_gfx"))
+        TextureManager::GetInstance().Load(config.emissive)
     );
 }
 
 void MaterialRegistry::Init() {
+    PROFILE_ZONE("MaterialRegistry::Init");
     std::vector<std::string> keys = file_system::GetFilesWithExtension("../Assets/Materials", ".json");
 
     for (const auto &key: keys) {
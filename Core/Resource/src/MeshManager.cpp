@@ -5,6 +5,7 @@
 #include <SDL3/SDL.h>
 #include <glm/glm.hpp>
 
+#include <include/CpuProfiler.h>
 #include <include/FileSystem.h>
 #include <include/MeshLoader.h>
 #include <include/ThreadPool.h>
@@ -12,12 +13,15 @@
 #include <include/VulkanState.h>
 
 VulkanMesh MeshManager::CreateResource(const std::string &key) {
+    PROFILE_ZONE("MeshManager::CreateResource");
     SDL_Log("Loading mesh from file %s", key.c_str());
     const std::vector<VertexPNTT> vertices = file_system::LoadMesh(key);
-    return VulkanMesh(file_system::GetFileName(key), vertices.size(), sizeof(VertexPNTT), vertices.data());
+    const Bounds                  bounds   = Bounds::FromPositions(vertices.data(), vertices.size(), sizeof(VertexPNTT));
+    return VulkanMesh(file_system::GetFileName(key), vertices.size(), sizeof(VertexPNTT), vertices.data(), bounds);
 }
 
 void MeshManager::Init() {
+    PROFILE_ZONE("MeshManager::Init");
     std::vector<std::string> keys = file_system::GetFilesWithExtension("../Assets/Models", ".obj");
 
     for (const auto &key: keys) {
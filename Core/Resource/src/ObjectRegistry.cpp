@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 
+#include <include/CpuProfiler.h>
 #include <include/FileSystem.h>
 #include <include/JsonInput.h>
 #include <include/MaterialRegistry.h>
@@ -11,11 +12,13 @@
 #include <include/VulkanObject.h>
 
 VulkanObject ObjectRegistry::CreateResource(const std::string &key) {
+    PROFILE_ZONE("ObjectRegistry::CreateResource");
     file_system::ObjectConfig config(key);
     return VulkanObject(MeshManager::GetInstance().Load(config.mesh), MaterialRegistry::GetInstance().Load(config.material));
 }
 
 void ObjectRegistry::Init() {
+    PROFILE_ZONE("ObjectRegistry::Init");
     std::vector<std::string> keys = file_system::GetFilesWithExtension("../Assets/Models", ".json");
 
     for (const auto &key: keys) {
@@ -1,37 +1,52 @@
 #include "include/PipelineManager.h"
 
+#include <algorithm>
+
 #include <SDL3/SDL.h>
 
+#include <include/CpuProfiler.h>
 #include <include/ThreadPool.h>
 #include <include/VertexFormats.h>
 #include <include/VulkanComputePipeline.h>
 #include <include/VulkanGraphicsPipeline.h>
 #include <include/VulkanState.h>
 
-std::unique_ptr<VulkanPipeline> PipelineManager::CreateResource(const std::string &key, const std::vector<std::string> files) {
+std::unique_ptr<VulkanPipeline> PipelineManager::CreateResource(const std::string &key) {
+    PROFILE_ZONE("PipelineManager::CreateResource");
     SDL_Log("Creating %s pipeline", key.c_str());
 
-    return std::make_unique<VulkanComputePipeline>(files);
+    PipelineSource &source = m_sources.at(key);
+    ShaderCompiler  shaderCompiler(source.files);
+    if (!shaderCompiler.IsValid()) {
+        SDL_Log("Failed to compile %s pipeline", key.c_str());
+        exit(EXIT_FAILURE);
+    }
+    source.includes = shaderCompiler.GetIncludes();
+
+    return CreatePipeline(source, shaderCompiler, nullptr, 0);
 }
 
-std::unique_ptr<VulkanPipeline> PipelineManager::CreateResource(
-    const std::string             &key,
-    const std::vector<std::string> files,
-    const GraphicsPipelineOption  &option
+std::unique_ptr<VulkanPipeline> PipelineManager::CreatePipeline(
+    const PipelineSource                       &source,
+    const ShaderCompiler                       &shaderCompiler,
+    std::shared_ptr<const VulkanPipelineLayout> pipelineLayout,
+    uint32_t                                    id
 ) {
-    SDL_Log("Creating %s pipeline", key.c_str());
-
-    return std::make_unique<VulkanGraphicsPipeline>(files, option);
+    if (source.option) {
+        return std::make_unique<VulkanGraphicsPipeline>(shaderCompiler, *source.option, std::move(pipelineLayout), id);
+    }
+    return std::make_unique<VulkanComputePipeline>(shaderCompiler, std::move(pipelineLayout), id);
 }
 
 void PipelineManager::Init() {
+    PROFILE_ZONE("PipelineManager::Init");
     std::vector<std::pair<std::string, std::vector<std::string>>> gfxPipelines{
-        {"skybox_gfx",          {"../Assets/Shaders/skybox.vert", "../Assets/Shaders/skybox.frag"}             },
-        {"gbuffer_gfx",         {"../Assets/Shaders/base.vert", "../Assets/Shaders/gbuffer.frag"}              },
-        {"lighting_gfx",        {"../Assets/Shaders/fullscreen.vert", "../Assets/Shaders/lighting.frag"}       },
-        {"shadow_gfx",          {"../Assets/Shaders/shadow.vert"}                                              },
-        {"forward_gfx",         {"../Assets/Shaders/base.vert", "../Assets/Shaders/forward.frag"}              },
-        {"post_processing_gfx", {"../Assets/Shaders/fullscreen.vert", "../Assets/Shaders/post_processing.frag"}}
+        {"skybox_gfx",       {"../Assets/Shaders/skybox.vert", "../Assets/Shaders/skybox.frag"}      },
+        {"gbuffer_gfx",      {"../Assets/Shaders/base.vert", "../Assets/Shaders/gbuffer.frag"}       },
+        {"lighting_gfx",     {"../Assets/Shaders/fullscreen.vert", "../Assets/Shaders/lighting.frag"}},
+        {"shadow_gfx",       {"../Assets/Shaders/shadow.vert"}                                       },
+        {"point_shadow_gfx", {"../Assets/Shaders/point_shadow.vert"}                                 },
+        {"forward_gfx",      {"../Assets/Shaders/base.vert", "../Assets/Shaders/forward.frag"}       },
     };
     std::vector<GraphicsPipelineOption> gfxOptions{
         {
@@ -63,11 +78,24 @@ void PipelineManager::Init() {
          .cullMode             = VK_CULL_MODE_FRONT_BIT,
          .infoVertex           = VertexPNTT::GetVertexInputStateCreateInfo(),
          .colorFormats         = {},
+         .viewMask             = 0b1111, // One view per shadow cascade
          .depthTestEnable      = VK_TRUE,
          .depthWriteEnable     = VK_TRUE,
          .depthCompareOp       = VK_COMPARE_OP_LESS_OR_EQUAL,
          .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
          },
+        {
+         .cullMode                = VK_CULL_MODE_FRONT_BIT,
+         .infoVertex              = VertexPNTT::GetVertexInputStateCreateInfo(),
+         .colorFormats            = {},
+         .depthTestEnable         = VK_TRUE,
+         .depthWriteEnable        = VK_TRUE,
+         .depthCompareOp          = VK_COMPARE_OP_LESS_OR_EQUAL,
+         .rasterizationSamples    = VK_SAMPLE_COUNT_1_BIT,
+         .depthBiasEnable         = VK_TRUE, // Perspective depth loses precision away from the light
+         .depthBiasConstantFactor = 2.0f,
+         .depthBiasSlopeFactor    = 2.0f,
+         },
         {
          .cullMode             = VK_CULL_MODE_BACK_BIT,
          .infoVertex           = VertexPNTT::GetVertexInputStateCreateInfo(),
@@ -77,17 +105,135 @@ void PipelineManager::Init() {
          .depthCompareOp       = VK_COMPARE_OP_LESS_OR_EQUAL,
          .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
          },
-        {
-         .topology             = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
-         .cullMode             = VK_CULL_MODE_NONE,
-         .infoVertex           = VertexPT2D::GetVertexInputStateCreateInfo(),
-         .colorFormats         = {VK_FORMAT_R16G16B16A16_SFLOAT},
-         },
     };
 
     for (size_t i = 0; i < gfxPipelines.size(); i++) {
-        ThreadPool::GetInstance().Enqueue([this, i, gfxPipelines, gfxOptions]() {
-            Preload(gfxPipelines[i].first, gfxPipelines[i].second, gfxOptions[i]);
+        m_sources[gfxPipelines[i].first] = {.files = gfxPipelines[i].second, .option = gfxOptions[i]};
+    }
+
+    std::vector<std::pair<std::string, std::vector<std::string>>> computePipelines{
+        {"cull_comp",             {"../Assets/Shaders/cull.comp"}            },
+        {"hiz_comp",              {"../Assets/Shaders/hiz.comp"}             },
+        {"cluster_comp",          {"../Assets/Shaders/cluster.comp"}         },
+        {"bloom_downsample_comp", {"../Assets/Shaders/bloom_downsample.comp"}},
+        {"bloom_upsample_comp",   {"../Assets/Shaders/bloom_upsample.comp"}  },
+        {"tonemap_comp",          {"../Assets/Shaders/tonemap.comp"}         },
+        {"fxaa_comp",             {"../Assets/Shaders/fxaa.comp"}            },
+    };
+
+    for (const auto &pipeline: computePipelines) {
+        m_sources[pipeline.first] = {.files = pipeline.second};
+    }
+
+    for (const auto &source: m_sources) {
+        ThreadPool::GetInstance().Enqueue([this, key = source.first]() { Preload(key); });
+    }
+
+    m_watcher.Watch("../Assets/Shaders/");
+    m_watcher.Watch(ShaderCompiler::SHADER_HEADERS_DIR);
+}
+
+void PipelineManager::Destroy() {
+    m_watcher.Stop();
+
+    // Rebuilds still compiling would hand their pipelines over after the cache is gone
+    ThreadPool::GetInstance().WaitIdle();
+    m_rebuilt.clear();
+    DestroyAll();
+}
+
+void PipelineManager::Update() {
+    PROFILE_ZONE("PipelineManager::Update");
+    SwapRebuilt();
+    RebuildChanged();
+}
+
+void PipelineManager::Rebuild(
+    const Key                                         &key,
+    const PipelineSource                              &source,
+    const std::shared_ptr<const VulkanPipelineLayout> &pipelineLayout,
+    uint32_t                                           id
+) {
+    PROFILE_ZONE("PipelineManager::Rebuild");
+    SDL_Log("Rebuilding %s pipeline", key.c_str());
+
+    ShaderCompiler shaderCompiler(source.files);
+    if (!shaderCompiler.IsValid()) {
+        // The current pipeline stays until the next save compiles
+        SDL_Log("Failed to rebuild %s pipeline, keeping the current one", key.c_str());
+        return;
+    }
+
+    // Descriptor sets are allocated once from the layouts of the first build, which every rebuild keeps using
+    if (!pipelineLayout->IsCompatible(shaderCompiler)) {
+        SDL_Log("Rejected %s pipeline, its descriptor sets or push constants changed and need a restart", key.c_str());
+        return;
+    }
+
+    RebuiltPipeline rebuilt{
+        .key        = key,
+        .generation = source.generation,
+        .pipeline   = CreatePipeline(source, shaderCompiler, pipelineLayout, id),
+        .includes   = shaderCompiler.GetIncludes(),
+    };
+
+    std::scoped_lock<std::mutex> lock(m_rebuiltMutex);
+    m_rebuilt.push_back(std::move(rebuilt));
+}
+
+void PipelineManager::SwapRebuilt() {
+    std::vector<RebuiltPipeline> rebuilt;
+    {
+        std::scoped_lock<std::mutex> lock(m_rebuiltMutex);
+        rebuilt.swap(m_rebuilt);
+    }
+
+    for (RebuiltPipeline &pipeline: rebuilt) {
+        PipelineSource &source = m_sources.at(pipeline.key);
+        if (pipeline.generation != source.generation) {
+            continue;
+        }
+        source.includes = std::move(pipeline.includes);
+
+        // The replaced pipeline goes to the release queue, the shared layouts stay
+        m_cache.at(pipeline.key) = std::move(pipeline.pipeline);
+        SDL_Log("Reloaded %s pipeline", pipeline.key.c_str());
+    }
+}
+
+void PipelineManager::RebuildChanged() {
+    const std::vector<std::string> changed = m_watcher.Poll();
+    if (changed.empty()) {
+        return;
+    }
+
+    const std::string headerDir = ShaderCompiler::SHADER_HEADERS_DIR;
+    std::set<Key>     keys;
+    for (const std::string &path: changed) {
+        if (path.starts_with(headerDir)) {
+            const std::string header = path.substr(headerDir.size());
+            ShaderCompiler::InvalidateHeader(header);
+            for (const auto &[key, source]: m_sources) {
+                if (source.includes.contains(header)) {
+                    keys.insert(key);
+                }
+            }
+        } else {
+            for (const auto &[key, source]: m_sources) {
+                if (std::ranges::find(source.files, path) != source.files.end()) {
+                    keys.insert(key);
+                }
+            }
+        }
+    }
+
+    // Each rebuild gets a copy of the source, so the render thread keeps updating the original
+    for (const Key &key: keys) {
+        PipelineSource       &source  = m_sources.at(key);
+        const VulkanPipeline *current = m_cache.at(key).get();
+        source.generation++;
+        ThreadPool::GetInstance().Enqueue([this, key, source, pipelineLayout = current->GetPipelineLayout(), id = current->GetId()]() {
+            Rebuild(key, source, pipelineLayout, id);
         });
     }
 }
@@ -4,11 +4,13 @@
 
 #include <SDL3/SDL.h>
 
+#include <include/CpuProfiler.h>
 #include <include/TextureLoader.h>
 #include <include/ThreadPool.h>
 #include <include/VulkanState.h>
 
 VulkanTexture TextureManager::CreateResource(const std::string &key, const SamplerConfig &config) {
+    PROFILE_ZONE("TextureManager::CreateResource");
     SDL_Log("Loading texture from file %s", key.c_str());
 
     int                  width  = 0;
@@ -19,6 +21,7 @@ VulkanTexture TextureManager::CreateResource(const std::string &key, const Sampl
 }
 
 void TextureManager::Init() {
+    PROFILE_ZONE("TextureManager::Init");
     std::vector<std::string> pngKeys = file_system::GetFilesWithExtension("../Assets", ".png");
     std::vector<std::string> jpgKeys = file_system::GetFilesWithExtension("../Assets", ".jpg");
 
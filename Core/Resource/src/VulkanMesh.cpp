@@ -1,39 +1,75 @@
 #include "include/VulkanMesh.h"
 
+#include <atomic>
+
 #include "include/VulkanState.h"
 
-VulkanMesh::VulkanMesh(std::string name, size_t vertexCount, size_t vertexSize, const void *data) {
+namespace {
+// Meshes are created on the thread pool
+std::atomic<uint32_t> nextId = 1;
+} // namespace
+
+VulkanMesh::VulkanMesh(std::string name, size_t vertexCount, size_t vertexSize, const void *data, const Bounds &bounds)
+    : m_bounds(bounds) {
     VkDeviceSize size = vertexCount * vertexSize;
     m_vertexSize      = vertexSize;
     VulkanBuffer stagingBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
     stagingBuffer.Upload(size, data);
 
     VulkanBuffer vertexBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    // Copy data from staging buffer to vertex buffer
-    VulkanState::GetInstance().ImmediateSubmit([size, &stagingBuffer, &vertexBuffer](VkCommandBuffer cmdBuf) {
-        VkBufferCopy copy{.srcOffset = 0, .dstOffset = 0, .size = size};
-        vkCmdCopyBuffer(cmdBuf, stagingBuffer.GetBuffer(), vertexBuffer.GetBuffer(), 1, &copy);
-    });
+    // Copy data from staging buffer to vertex buffer, on the transfer queue when there is one
+    VkBufferMemoryBarrier barrier{
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .pNext               = nullptr,
+        .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask       = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer              = vertexBuffer.GetBuffer(),
+        .offset              = 0,
+        .size                = VK_WHOLE_SIZE,
+    };
+    VulkanState::GetInstance().UploadSubmit(
+        [size, &stagingBuffer, &vertexBuffer](VkCommandBuffer cmdBuf) {
+            VkBufferCopy copy{.srcOffset = 0, .dstOffset = 0, .size = size};
+            vkCmdCopyBuffer(cmdBuf, stagingBuffer.GetBuffer(), vertexBuffer.GetBuffer(), 1, &copy);
+        },
+        {barrier},
+        {},
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+    );
     m_vertexBuffer = std::move(vertexBuffer);
     m_vertexCount  = vertexCount;
+    m_id           = nextId++;
 
     m_name = name;
 }
 
 void VulkanMesh::Swap(VulkanMesh &other) noexcept {
     std::swap(m_vertexBuffer, other.m_vertexBuffer);
+    std::swap(m_id, other.m_id);
     std::swap(m_vertexCount, other.m_vertexCount);
     std::swap(m_name, other.m_name);
+    std::swap(m_bounds, other.m_bounds);
 }
 
 void VulkanMesh::Destroy() {
     m_vertexBuffer = {};
-    m_vertexCount = 0;
+    m_id           = 0;
+    m_vertexCount  = 0;
 }
 
 void VulkanMesh::BindAndDraw() const {
+    Bind();
+    Draw(1, 0);
+}
+
+void VulkanMesh::Bind() const {
     const VkDeviceSize offset = 0;
 
     vkCmdBindVertexBuffers(VulkanState::GetInstance().GetCommandBuffer(), 0, 1, &m_vertexBuffer.GetBuffer(), &offset);
-    vkCmdDraw(VulkanState::GetInstance().GetCommandBuffer(), m_vertexCount, 1, 0, 0);
+}
+
+void VulkanMesh::Draw(uint32_t instanceCount, uint32_t firstInstance) const {
+    vkCmdDraw(VulkanState::GetInstance().GetCommandBuffer(), m_vertexCount, instanceCount, 0, firstInstance);
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include "include/VulkanObject.h"
 
-#include <include/Descriptor.h>
 #include <include/VulkanMaterial.h>
 #include <include/VulkanMesh.h>
 #include <include/VulkanState.h>
@@ -20,11 +19,7 @@ void VulkanObject::Destroy() {
     m_material = nullptr;
 }
 
-void VulkanObject::BindAndDraw(VkPipelineLayout layout) const {
-    m_material->Bind(layout, descriptor::TEXTURE_SET);
-    m_mesh->BindAndDraw();
-}
-
-void VulkanObject::BindAndDrawMesh(VkPipelineLayout layout) const {
-    m_mesh->BindAndDraw();
+void VulkanObject::BindAndDrawMesh(uint32_t instanceCount, uint32_t firstInstance) const {
+    m_mesh->Bind();
+    m_mesh->Draw(instanceCount, firstInstance);
 }
@@ -59,15 +59,3 @@ void VulkanPrefab::UpdateTransformation() {
     m_transformation = glm::translate(glm::mat4(1.0f), m_location) * glm::mat4_cast(m_rotation) * glm::scale(glm::mat4(1.0f), m_scale);
 }
 
-
-
-void VulkanPrefab::BindAndDraw(VkPipelineLayout pipeline) const {
-    vkCmdPushConstants(VulkanState::GetInstance().GetCommandBuffer(), pipeline, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(m_transformation), &m_transformation);
-
-    m_object->BindAndDraw(pipeline);
-}
-
-void VulkanPrefab::BindAndDrawMesh(VkPipelineLayout pipeline) const {
-    vkCmdPushConstants(VulkanState::GetInstance().GetCommandBuffer(), pipeline, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(m_transformation), &m_transformation);
-
-    m_object->BindAndDrawMesh(pipeline);}
\ No newline at end of file
@@ -10,12 +10,13 @@
 
 VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, size_t formatSize, const void *data, const SamplerConfig &config) {
     CreateImage(width, height, format, formatSize, data);
-    CreateSampler(config);
+    m_samplerConfig = config;
+    m_sampler       = SamplerCache::GetInstance().Acquire(m_samplerConfig);
 }
 
 void VulkanTexture::Destroy() {
     if (m_sampler != VK_NULL_HANDLE) {
-        vkDestroySampler(VulkanState::GetInstance().GetDevice(), m_sampler, nullptr);
+        SamplerCache::GetInstance().Release(m_samplerConfig);
         m_image = {};
     }
     m_sampler = VK_NULL_HANDLE;
@@ -23,6 +24,7 @@ void VulkanTexture::Destroy() {
 
 void VulkanTexture::Swap(VulkanTexture &other) noexcept {
     std::swap(m_image, other.m_image);
+    std::swap(m_samplerConfig, other.m_samplerConfig);
     std::swap(m_sampler, other.m_sampler);
 }
 
@@ -49,57 +51,50 @@ void VulkanTexture::CreateImage(uint32_t width, uint32_t height, VkFormat format
     VulkanBuffer stagingBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
     stagingBuffer.Upload(size, data);
 
-    VulkanState::GetInstance().ImmediateSubmit([&](VkCommandBuffer cmdBuf) {
-        // Layout transition
-        vk_util::CmdImageLayoutTransition(
-            cmdBuf,
-            m_image.GetImage(),
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_ASPECT_COLOR_BIT,
-            0,
-            VK_ACCESS_TRANSFER_WRITE_BIT
-        );
-
-        VkBufferImageCopy copy{
-            .bufferOffset      = 0,
-            .bufferRowLength   = 0,
-            .bufferImageHeight = 0,
-            .imageSubresource  = vk_util::GetImageSubresourceLayers(VK_IMAGE_ASPECT_COLOR_BIT),
-            .imageOffset       = 0,
-            .imageExtent       = extent
-        };
-
-        vkCmdCopyBufferToImage(cmdBuf, stagingBuffer.GetBuffer(), m_image.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
-
-        GenerateMipmaps(cmdBuf, m_image.GetImage(), width, height, format, mipLevels);
-    });
-}
-
-void VulkanTexture::CreateSampler(SamplerConfig config) {
-    VkSamplerCreateInfo infoSampler{
-        .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-        .pNext                   = nullptr,
-        .flags                   = 0,
-        .magFilter               = config.filter,
-        .minFilter               = config.filter,
-        .mipmapMode              = config.mipmapMode,
-        .addressModeU            = config.addressMode,
-        .addressModeV            = config.addressMode,
-        .addressModeW            = config.addressMode,
-        .mipLodBias              = 0.0f,
-        .anisotropyEnable        = config.anisotropyEnable,
-        .maxAnisotropy           = config.maxAnisotropy,
-        .compareEnable           = config.compareEnable,
-        .compareOp               = config.compareOp,
-        .minLod                  = config.minLod,
-        .maxLod                  = config.maxLod,
-        .borderColor             = config.borderColor,
-        .unnormalizedCoordinates = VK_FALSE, // Always normalized
-
+    // Copies can go to the transfer queue, blits need the graphics one
+    VkImageMemoryBarrier barrier{
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext               = nullptr,
+        .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = m_image.GetImage(),
+        .subresourceRange    = vk_util::GetSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels),
     };
-
-    DEBUG_VK_ASSERT(vkCreateSampler(VulkanState::GetInstance().GetDevice(), &infoSampler, nullptr, &m_sampler));
+    VulkanState::GetInstance().UploadSubmit(
+        [&](VkCommandBuffer cmdBuf) {
+            // Every level is a blit destination later on
+            vk_util::CmdImageLayoutTransition(
+                cmdBuf,
+                m_image.GetImage(),
+                VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0,
+                VK_ACCESS_TRANSFER_WRITE_BIT,
+                0,
+                mipLevels
+            );
+
+            VkBufferImageCopy copy{
+                .bufferOffset      = 0,
+                .bufferRowLength   = 0,
+                .bufferImageHeight = 0,
+                .imageSubresource  = vk_util::GetImageSubresourceLayers(VK_IMAGE_ASPECT_COLOR_BIT),
+                .imageOffset       = 0,
+                .imageExtent       = extent
+            };
+
+            vkCmdCopyBufferToImage(cmdBuf, stagingBuffer.GetBuffer(), m_image.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+        },
+        {},
+        {barrier},
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        [&](VkCommandBuffer cmdBuf) { GenerateMipmaps(cmdBuf, m_image.GetImage(), width, height, format, mipLevels); }
+    );
 }
 
 void VulkanTexture::GenerateMipmaps(VkCommandBuffer cmdBuf, VkImage image, uint32_t width, uint32_t height, VkFormat format, uint32_t mipLevels) {
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+// Local space bounding volume of a mesh, an AABB plus the sphere around it
+struct Bounds {
+    glm::vec3 min    = glm::vec3(0.0f);
+    glm::vec3 max    = glm::vec3(0.0f);
+    glm::vec3 center = glm::vec3(0.0f);
+    float     radius = 0.0f;
+
+    // Positions are read with a stride so interleaved vertex data can be passed directly
+    static Bounds FromPositions(const void *data, size_t count, size_t stride);
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class SceneStore;
+
+inline constexpr size_t FRUSTUM_PLANE_COUNT = 6;
+
+// Planes as (normal, distance) with normals pointing inside
+struct Frustum {
+    std::array<glm::vec4, FRUSTUM_PLANE_COUNT> planes;
+
+    // Expects a [0, 1] clip space depth range
+    static Frustum FromMatrix(const glm::mat4 &viewProjection);
+};
+
+namespace culling {
+// Appends the indices in [first, first + count) whose bounding spheres intersect the frustum
+void CullSpheres(const Frustum &frustum, const SceneStore &scene, uint32_t first, uint32_t count, std::vector<uint32_t> &visible);
+} // namespace culling
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct ScenePrefab {
+    std::string object; // Object json
+    glm::vec3   location{0.0f};
+    bool        front = false; // Forward shaded after the deferred passes
+};
+
+// The prefabs a renderer loads on creation
+struct SceneDescription {
+    std::string              name = "default";
+    std::vector<ScenePrefab> prefabs;
+
+    // The showcase scene of the app
+    static SceneDescription Default();
+
+    // {"name": "...", "instances": [{"object": "...", "location": [x, y, z], "count": N, "spacing": S, "front": false}]}
+    // Every field but the object is optional, the count instances of an entry sit on a square grid centered on its location
+    static SceneDescription FromFile(const std::string &file);
+};
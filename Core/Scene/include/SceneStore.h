@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Bounds.h"
+
+// Structure-of-arrays storage of instance transforms and world space bounding spheres,
+// laid out so culling can stream over contiguous floats
+class SceneStore {
+public:
+    SceneStore() = default;
+
+    uint32_t Add(const glm::mat4 &world, const Bounds &localBounds);
+
+    // Returns whether the transform changed, an instance that moved once counts as dynamic from then on
+    bool SetWorldMatrix(uint32_t index, const glm::mat4 &world);
+
+    void Clear();
+
+    [[nodiscard]] uint32_t GetCount() const { return static_cast<uint32_t>(m_worldMatrices.size()); }
+
+    [[nodiscard]] const glm::mat4 &GetWorldMatrix(uint32_t index) const { return m_worldMatrices[index]; }
+
+    [[nodiscard]] const std::vector<glm::mat4> &GetWorldMatrices() const { return m_worldMatrices; }
+
+    [[nodiscard]] bool IsDynamic(uint32_t index) const { return m_dynamic[index] != 0; }
+
+    [[nodiscard]] const float *GetCentersX() const { return m_centersX.data(); }
+
+    [[nodiscard]] const float *GetCentersY() const { return m_centersY.data(); }
+
+    [[nodiscard]] const float *GetCentersZ() const { return m_centersZ.data(); }
+
+    [[nodiscard]] const float *GetRadii() const { return m_radii.data(); }
+
+private:
+    std::vector<glm::mat4> m_worldMatrices;
+    std::vector<Bounds>    m_localBounds;
+    std::vector<uint8_t>   m_dynamic;
+
+    // World space bounding spheres
+    std::vector<float> m_centersX;
+    std::vector<float> m_centersY;
+    std::vector<float> m_centersZ;
+    std::vector<float> m_radii;
+
+    void UpdateSphere(uint32_t index);
+};
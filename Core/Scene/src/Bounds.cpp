@@ -0,0 +1,39 @@
+#include "include/Bounds.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+glm::vec3 ReadPosition(const void *data, size_t index, size_t stride) {
+    glm::vec3 position;
+    std::memcpy(&position, static_cast<const std::byte *>(data) + index * stride, sizeof(glm::vec3));
+    return position;
+}
+} // namespace
+
+Bounds Bounds::FromPositions(const void *data, size_t count, size_t stride) {
+    Bounds bounds;
+    if (data == nullptr || count == 0) {
+        return bounds;
+    }
+
+    bounds.min = glm::vec3(std::numeric_limits<float>::max());
+    bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < count; i++) {
+        const glm::vec3 position = ReadPosition(data, i, stride);
+        bounds.min               = glm::min(bounds.min, position);
+        bounds.max               = glm::max(bounds.max, position);
+    }
+
+    // Sphere around the box center, tightened against the actual vertices
+    bounds.center      = (bounds.min + bounds.max) * 0.5f;
+    float radiusSquare = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        const glm::vec3 offset = ReadPosition(data, i, stride) - bounds.center;
+        radiusSquare           = glm::max(radiusSquare, glm::dot(offset, offset));
+    }
+    bounds.radius = std::sqrt(radiusSquare);
+
+    return bounds;
+}
@@ -0,0 +1,126 @@
+#include "include/Frustum.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+    #include <immintrin.h>
+    #define VREZ_CULL_AVX2
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    #include <arm_neon.h>
+    #define VREZ_CULL_NEON
+#endif
+
+#include <bit>
+
+#include "include/SceneStore.h"
+
+namespace {
+constexpr uint32_t CULL_BATCH_SIZE = 8;
+
+glm::vec4 GetRow(const glm::mat4 &matrix, int row) { return {matrix[0][row], matrix[1][row], matrix[2][row], matrix[3][row]}; }
+
+glm::vec4 NormalizePlane(const glm::vec4 &plane) { return plane / glm::length(glm::vec3(plane)); }
+
+bool IsSphereVisible(const Frustum &frustum, float x, float y, float z, float radius) {
+    for (const auto &plane: frustum.planes) {
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tests CULL_BATCH_SIZE spheres starting at index and returns one bit per visible sphere
+uint32_t CullBatch(const Frustum &frustum, const float *xs, const float *ys, const float *zs, const float *radii, uint32_t index) {
+#if defined(VREZ_CULL_AVX2)
+    const __m256 x      = _mm256_loadu_ps(xs + index);
+    const __m256 y      = _mm256_loadu_ps(ys + index);
+    const __m256 z      = _mm256_loadu_ps(zs + index);
+    const __m256 radius = _mm256_loadu_ps(radii + index);
+    const __m256 zero   = _mm256_setzero_ps();
+
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (const auto &plane: frustum.planes) {
+        __m256 distance = _mm256_fmadd_ps(_mm256_set1_ps(plane.x), x, _mm256_set1_ps(plane.w));
+        distance        = _mm256_fmadd_ps(_mm256_set1_ps(plane.y), y, distance);
+        distance        = _mm256_fmadd_ps(_mm256_set1_ps(plane.z), z, distance);
+        inside          = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+    }
+    return static_cast<uint32_t>(_mm256_movemask_ps(inside));
+#elif defined(VREZ_CULL_NEON)
+    static const uint32_t laneBits[4] = {1, 2, 4, 8};
+    const uint32x4_t      bits        = vld1q_u32(laneBits);
+
+    uint32_t mask = 0;
+    // Two 4-wide halves per batch
+    for (uint32_t half = 0; half < CULL_BATCH_SIZE; half += 4) {
+        const float32x4_t x      = vld1q_f32(xs + index + half);
+        const float32x4_t y      = vld1q_f32(ys + index + half);
+        const float32x4_t z      = vld1q_f32(zs + index + half);
+        const float32x4_t radius = vld1q_f32(radii + index + half);
+
+        uint32x4_t inside = vdupq_n_u32(0xFFFFFFFF);
+        for (const auto &plane: frustum.planes) {
+            float32x4_t distance = vfmaq_n_f32(vdupq_n_f32(plane.w), x, plane.x);
+            distance             = vfmaq_n_f32(distance, y, plane.y);
+            distance             = vfmaq_n_f32(distance, z, plane.z);
+            inside               = vandq_u32(inside, vcgeq_f32(vaddq_f32(distance, radius), vdupq_n_f32(0.0f)));
+        }
+        mask |= vaddvq_u32(vandq_u32(inside, bits)) << half;
+    }
+    return mask;
+#else
+    uint32_t mask = 0;
+    for (uint32_t lane = 0; lane < CULL_BATCH_SIZE; lane++) {
+        const uint32_t i = index + lane;
+        mask |= static_cast<uint32_t>(IsSphereVisible(frustum, xs[i], ys[i], zs[i], radii[i])) << lane;
+    }
+    return mask;
+#endif
+}
+} // namespace
+
+Frustum Frustum::FromMatrix(const glm::mat4 &viewProjection) {
+    const glm::vec4 row0 = GetRow(viewProjection, 0);
+    const glm::vec4 row1 = GetRow(viewProjection, 1);
+    const glm::vec4 row2 = GetRow(viewProjection, 2);
+    const glm::vec4 row3 = GetRow(viewProjection, 3);
+
+    Frustum frustum;
+    frustum.planes[0] = NormalizePlane(row3 + row0); // Left
+    frustum.planes[1] = NormalizePlane(row3 - row0); // Right
+    frustum.planes[2] = NormalizePlane(row3 + row1); // Bottom
+    frustum.planes[3] = NormalizePlane(row3 - row1); // Top
+    frustum.planes[4] = NormalizePlane(row2);        // Near
+    frustum.planes[5] = NormalizePlane(row3 - row2); // Far
+
+    return frustum;
+}
+
+void culling::CullSpheres(const Frustum &frustum, const SceneStore &scene, uint32_t first, uint32_t count, std::vector<uint32_t> &visible) {
+    const float *xs    = scene.GetCentersX();
+    const float *ys    = scene.GetCentersY();
+    const float *zs    = scene.GetCentersZ();
+    const float *radii = scene.GetRadii();
+
+    // Write the compacted indices in place, then trim
+    const size_t offset = visible.size();
+    visible.resize(offset + count);
+    uint32_t *out = visible.data() + offset;
+
+    const uint32_t end = first + count;
+    uint32_t       i   = first;
+    for (; i + CULL_BATCH_SIZE <= end; i += CULL_BATCH_SIZE) {
+        uint32_t mask = CullBatch(frustum, xs, ys, zs, radii, i);
+        while (mask != 0) {
+            *out++ = i + static_cast<uint32_t>(std::countr_zero(mask));
+            mask &= mask - 1;
+        }
+    }
+
+    for (; i < end; i++) {
+        if (IsSphereVisible(frustum, xs[i], ys[i], zs[i], radii[i])) {
+            *out++ = i;
+        }
+    }
+
+    visible.resize(static_cast<size_t>(out - visible.data()));
+}
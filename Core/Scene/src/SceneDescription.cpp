@@ -0,0 +1,82 @@
+#include "include/SceneDescription.h"
+
+#include <cmath>
+
+#include <SDL3/SDL_log.h>
+
+#include <Debug.h>
+
+#include <include/JsonFile.h>
+
+namespace {
+constexpr double DEFAULT_SPACING = 0.3;
+
+glm::vec3 GetLocation(simdjson::dom::object entry) {
+    simdjson::dom::array location;
+    if (entry["location"].get(location) != simdjson::SUCCESS) {
+        return glm::vec3(0.0f);
+    }
+    DEBUG_ASSERT_LOG(location.size() == 3, "Scene locations expect three components");
+
+    glm::vec3 result(0.0f);
+    int       axis = 0;
+    for (const simdjson::dom::element value: location) {
+        double component = 0.0;
+        DEBUG_ASSERT_LOG(value.get(component) == simdjson::SUCCESS, "Scene locations expect numbers");
+        result[axis++] = static_cast<float>(component);
+    }
+    return result;
+}
+} // namespace
+
+SceneDescription SceneDescription::Default() {
+    return {
+        .name    = "default",
+        .prefabs = {
+                    {.object = "../Assets/Models/BoomBox/BoomBox.json", .location = glm::vec3(0.0f, 0.1f, 0.0f)},
+                    {.object = "../Assets/Models/Chessboard/Chessboard.json"},
+                    {.object = "../Assets/Models/Castle/Castle.json"},
+                    {.object = "../Assets/Models/Castle/Castle.json", .location = glm::vec3(0.35f, 0.0f, 0.0f), .front = true},
+                    },
+    };
+}
+
+SceneDescription SceneDescription::FromFile(const std::string &file) {
+    file_system::JsonFile json(file);
+
+    SceneDescription scene;
+    scene.name = json.GetString("name", file);
+
+    for (const simdjson::dom::element element: json.GetArray("instances")) {
+        simdjson::dom::object entry;
+        DEBUG_ASSERT_LOG(element.get(entry) == simdjson::SUCCESS, ("Scene instances of " + file + " must be objects").c_str());
+
+        std::string_view object;
+        DEBUG_ASSERT_LOG(entry["object"].get(object) == simdjson::SUCCESS, ("Scene instance without an object in " + file).c_str());
+
+        uint64_t count   = 1;
+        double   spacing = DEFAULT_SPACING;
+        bool     front   = false;
+        (void) entry["count"].get(count);
+        (void) entry["spacing"].get(spacing);
+        (void) entry["front"].get(front);
+
+        // Row major square grid, the last row may be partial
+        const glm::vec3 center  = GetLocation(entry);
+        const auto      columns = static_cast<uint64_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+        const auto      rows    = (count + columns - 1) / columns;
+        const glm::vec3 origin  = center - glm::vec3(static_cast<float>(columns - 1), 0.0f, static_cast<float>(rows - 1)) * 0.5f *
+                                                  static_cast<float>(spacing);
+        for (uint64_t i = 0; i < count; i++) {
+            scene.prefabs.push_back({
+                .object   = std::string(object),
+                .location = origin + glm::vec3(static_cast<float>(i % columns), 0.0f, static_cast<float>(i / columns)) * static_cast<float>(spacing),
+                .front    = front,
+            });
+        }
+    }
+    DEBUG_ASSERT_LOG(!scene.prefabs.empty(), (file + " has no instances").c_str());
+
+    SDL_Log("Loaded scene %s with %zu instances", scene.name.c_str(), scene.prefabs.size());
+    return scene;
+}
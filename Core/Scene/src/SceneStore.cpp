@@ -0,0 +1,61 @@
+#include "include/SceneStore.h"
+
+#include <cmath>
+
+#include <Debug.h>
+
+uint32_t SceneStore::Add(const glm::mat4 &world, const Bounds &localBounds) {
+    const auto index = static_cast<uint32_t>(m_worldMatrices.size());
+
+    m_worldMatrices.push_back(world);
+    m_localBounds.push_back(localBounds);
+    m_dynamic.push_back(0);
+    m_centersX.push_back(0.0f);
+    m_centersY.push_back(0.0f);
+    m_centersZ.push_back(0.0f);
+    m_radii.push_back(0.0f);
+
+    UpdateSphere(index);
+    return index;
+}
+
+bool SceneStore::SetWorldMatrix(uint32_t index, const glm::mat4 &world) {
+    DEBUG_ASSERT(index < m_worldMatrices.size());
+
+    if (m_worldMatrices[index] == world) {
+        return false;
+    }
+
+    m_worldMatrices[index] = world;
+    m_dynamic[index]       = 1;
+    UpdateSphere(index);
+    return true;
+}
+
+void SceneStore::Clear() {
+    m_worldMatrices.clear();
+    m_localBounds.clear();
+    m_dynamic.clear();
+    m_centersX.clear();
+    m_centersY.clear();
+    m_centersZ.clear();
+    m_radii.clear();
+}
+
+void SceneStore::UpdateSphere(uint32_t index) {
+    const glm::mat4 &world  = m_worldMatrices[index];
+    const Bounds    &bounds = m_localBounds[index];
+
+    const glm::vec3 center = glm::vec3(world * glm::vec4(bounds.center, 1.0f));
+
+    // Conservative radius under non-uniform scale
+    const float scale = std::sqrt(glm::max(
+        glm::max(glm::dot(glm::vec3(world[0]), glm::vec3(world[0])), glm::dot(glm::vec3(world[1]), glm::vec3(world[1]))),
+        glm::dot(glm::vec3(world[2]), glm::vec3(world[2]))
+    ));
+
+    m_centersX[index] = center.x;
+    m_centersY[index] = center.y;
+    m_centersZ[index] = center.z;
+    m_radii[index]    = bounds.radius * scale;
+}
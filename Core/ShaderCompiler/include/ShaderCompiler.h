@@ -1,7 +1,7 @@
 #pragma once
 
 #include <map>
-#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -10,12 +10,13 @@
 
 #include <glslang/Public/ShaderLang.h>
 
-struct ShaderIncluder;
-
 class ShaderCompiler {
 public:
     static constexpr const char* SHADER_HEADERS_DIR = "../Assets/Shaders/Headers/";
 
+    // Descriptor count of runtime arrays, which are bound partially and updated after bind
+    static constexpr uint32_t RUNTIME_ARRAY_SIZE = 4096;
+
     ShaderCompiler() = delete;
 
     explicit ShaderCompiler(const std::vector<std::string> &dirs);
@@ -36,8 +37,21 @@ public:
 
     [[nodiscard]] std::vector<VkPushConstantRange> GetPushConstantRanges() const { return m_pushConstantRanges; }
 
+    // False when a stage failed to parse or link, the errors are logged and nothing is reflected
+    [[nodiscard]] bool IsValid() const { return m_valid; }
+
+    // Headers included by any stage, directly or through other headers
+    [[nodiscard]] const std::set<std::string> &GetIncludes() const { return m_includes; }
+
+    // Headers are read once and shared by every compile, a changed one has to be dropped before recompiling
+    static void InvalidateHeader(const std::string &header);
+
 private:
     std::map<uint32_t, std::vector<VkDescriptorSetLayoutBinding>> m_bindingsPerSet;
+    std::map<uint32_t, std::vector<VkDescriptorBindingFlags>>     m_bindingFlagsPerSet;
+
+    // Chained into the layout infos, reserved up front so the pointers stay valid
+    std::vector<VkDescriptorSetLayoutBindingFlagsCreateInfo> m_bindingFlagsInfos;
 
     std::vector<VkDescriptorSetLayoutCreateInfo> m_descriptorSetLayoutInfos;
     std::vector<VkPushConstantRange>             m_pushConstantRanges;
@@ -45,9 +59,10 @@ private:
     std::map<VkShaderStageFlagBits, std::vector<uint32_t>> m_spirvs;
     std::vector<SpvReflectShaderModule>                    m_shaderModules;
 
-    static std::shared_ptr<ShaderIncluder> m_includer;
+    std::set<std::string> m_includes;
+    bool                  m_valid = true;
 
-    void Compile(const std::string &dir);
+    bool Compile(const std::string &dir);
 
     void GenerateReflectData();
 
@@ -1,5 +1,7 @@
 #include "include/ShaderCompiler.h"
 
+#include <mutex>
+
 #include <glslang/Public/ShaderLang.h>
 
 #include <SDL3/SDL_log.h>
@@ -9,40 +11,68 @@
 #include <Debug.h>
 #include <include/FileSystem.h>
 
-std::shared_ptr<ShaderIncluder> ShaderCompiler::m_includer = nullptr;
+namespace {
+// Compiles run on the thread pool, so the cache is shared between threads
+struct ShaderHeaderCache {
+    std::mutex                         mutex;
+    std::map<std::string, std::string> headers;
+};
 
+ShaderHeaderCache &GetHeaderCache() {
+    static ShaderHeaderCache cache;
+    return cache;
+}
+} // namespace
+
+// Resolves the includes of one compile and records them
 struct ShaderIncluder : glslang::TShader::Includer {
 public:
-    ShaderIncluder()
-        : m_dir(ShaderCompiler::SHADER_HEADERS_DIR) {}
+    explicit ShaderIncluder(std::set<std::string> &includes)
+        : m_dir(ShaderCompiler::SHADER_HEADERS_DIR)
+        , m_includes(includes) {}
 
     IncludeResult *includeLocal(const char *, const char *, size_t) override { return nullptr; }
 
-    IncludeResult *includeSystem(const char *header, const char *, size_t) { return Include(header); }
+    IncludeResult *includeSystem(const char *header, const char *, size_t) override { return Include(header); }
 
-    void releaseInclude(IncludeResult *include) override { delete include; }
+    void releaseInclude(IncludeResult *include) override {
+        if (include != nullptr) {
+            delete static_cast<std::string *>(include->userData);
+        }
+        delete include;
+    }
 
 private:
-    std::string                        m_dir;
-    std::map<std::string, std::string> m_headers;
+    std::string            m_dir;
+    std::set<std::string> &m_includes;
 
     IncludeResult *Include(const std::string &header) {
-        auto pair = m_headers.find(header);
-        if (pair == m_headers.end()) {
-            SDL_Log("Loading shader header %s", header.c_str());
-            pair = m_headers.emplace(header, file_system::Read(m_dir + header)).first;
+        m_includes.insert(header);
+
+        ShaderHeaderCache &cache  = GetHeaderCache();
+        std::string       *source = nullptr;
+        {
+            std::scoped_lock<std::mutex> lock(cache.mutex);
+            auto                         pair = cache.headers.find(header);
+            if (pair == cache.headers.end()) {
+                SDL_Log("Loading shader header %s", header.c_str());
+                pair = cache.headers.emplace(header, file_system::Read(m_dir + header)).first;
+            }
+
+            // Copied, the cached source may be invalidated while this compile still parses it
+            source = new std::string(pair->second);
         }
 
-        return new IncludeResult(header, pair->second.c_str(), pair->second.length(), nullptr);
+        return new IncludeResult(header, source->c_str(), source->length(), source);
     }
 };
 
 ShaderCompiler::ShaderCompiler(const std::vector<std::string> &dirs) {
-    if (!m_includer) {
-        m_includer = std::make_shared<ShaderIncluder>();
-    }
     for (const auto &dir: dirs) {
-        Compile(dir);
+        if (!Compile(dir)) {
+            m_valid = false;
+            return;
+        }
     }
 
     GenerateReflectData();
@@ -53,10 +83,11 @@ ShaderCompiler::ShaderCompiler(const std::vector<std::string> &dirs) {
 ShaderCompiler::~ShaderCompiler() {
     m_pushConstantRanges.clear();
     m_descriptorSetLayoutInfos.clear();
+    m_bindingFlagsInfos.clear();
     m_shaderModules.clear();
 }
 
-void ShaderCompiler::Compile(const std::string &dir) {
+bool ShaderCompiler::Compile(const std::string &dir) {
     TBuiltInResource DefaultTBuiltInResource{
         .maxLights                                 = 32,
         .maxClipPlanes                             = 6,
@@ -169,9 +200,10 @@ void ShaderCompiler::Compile(const std::string &dir) {
     shader.setEnvTarget(glslang::EshTargetSpv, glslang::EShTargetSpv_1_3);
     shader.setEntryPoint("main");
     SDL_Log("Start compiling %s...", dir.c_str());
-    if (!shader.parse(&DefaultTBuiltInResource, 100, false, EShMsgDefault, *m_includer)) {
+    ShaderIncluder includer(m_includes);
+    if (!shader.parse(&DefaultTBuiltInResource, 100, false, EShMsgDefault, includer)) {
         SDL_Log("GLSL Parsing Failed: %s", shader.getInfoLog());
-        exit(EXIT_FAILURE);
+        return false;
     }
 
     glslang::TProgram program;
@@ -179,13 +211,20 @@ void ShaderCompiler::Compile(const std::string &dir) {
 
     if (!program.link(EShMsgDefault)) {
         SDL_Log("Linking Failed: %s", shader.getInfoLog());
-        exit(EXIT_FAILURE);
+        return false;
     }
 
     // Compile to spirv code
     std::vector<uint32_t> spirv;
     glslang::GlslangToSpv(*program.getIntermediate(shaderType), spirv);
     m_spirvs[shaderStage] = spirv;
+    return true;
+}
+
+void ShaderCompiler::InvalidateHeader(const std::string &header) {
+    ShaderHeaderCache           &cache = GetHeaderCache();
+    std::scoped_lock<std::mutex> lock(cache.mutex);
+    cache.headers.erase(header);
 }
 
 void ShaderCompiler::GenerateReflectData() {
@@ -252,8 +291,9 @@ void ShaderCompiler::ExtractDescriptorSets() {
 
             // If the set is new
             if (pair == m_bindingsPerSet.end()) {
-                m_bindingsPerSet[setNum] = std::vector<VkDescriptorSetLayoutBinding>{};
-                setStages[setNum]        = 0;
+                m_bindingsPerSet[setNum]     = std::vector<VkDescriptorSetLayoutBinding>{};
+                m_bindingFlagsPerSet[setNum] = std::vector<VkDescriptorBindingFlags>{};
+                setStages[setNum]            = 0;
             }
             setStages[setNum] |= module.shader_stage;
 
@@ -269,6 +309,13 @@ void ShaderCompiler::ExtractDescriptorSets() {
                 }
                 binding.stageFlags = module.shader_stage;
 
+                // Runtime arrays reflect a dimension of 0
+                VkDescriptorBindingFlags flags = 0;
+                if (binding.descriptorCount == 0) {
+                    binding.descriptorCount = RUNTIME_ARRAY_SIZE;
+                    flags                   = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+                }
+
                 // Check if the binding already exist
                 bool exists = false;
                 for (auto &b: m_bindingsPerSet[setNum]) {
@@ -279,11 +326,13 @@ void ShaderCompiler::ExtractDescriptorSets() {
                 }
                 if (!exists) {
                     m_bindingsPerSet[setNum].push_back(std::move(binding));
+                    m_bindingFlagsPerSet[setNum].push_back(flags);
                 }
             }
         }
     }
 
+    m_bindingFlagsInfos.reserve(m_bindingsPerSet.size());
     for (auto &bindings: m_bindingsPerSet) {
         for (auto &b: bindings.second) {
             b.stageFlags = setStages[bindings.first];
@@ -296,6 +345,21 @@ void ShaderCompiler::ExtractDescriptorSets() {
             .pBindings    = bindings.second.data()
         };
 
+        const auto &flags = m_bindingFlagsPerSet[bindings.first];
+        for (const auto &f: flags) {
+            if (f & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) {
+                m_bindingFlagsInfos.push_back({
+                    .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+                    .pNext         = nullptr,
+                    .bindingCount  = static_cast<uint32_t>(flags.size()),
+                    .pBindingFlags = flags.data(),
+                });
+                infoLayout.pNext = &m_bindingFlagsInfos.back();
+                infoLayout.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+                break;
+            }
+        }
+
         m_descriptorSetLayoutInfos.push_back(std::move(infoLayout));
     }
 }
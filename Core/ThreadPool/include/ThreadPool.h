@@ -15,8 +15,12 @@ public:
     void WaitIdle();
 
 protected:
+    // One worker per hardware thread
     ThreadPool();
 
+    // Only sized pools of benchmarks derive to call this, the engine shares the singleton
+    explicit ThreadPool(size_t threadCount);
+
     ~ThreadPool();
 
 private:
@@ -1,13 +1,15 @@
 #include "include/ThreadPool.h"
 
+#include <algorithm>
+
 #include <Debug.h>
 
-ThreadPool::ThreadPool() {
-    size_t threadCount = std::thread::hardware_concurrency();
+#include <include/CpuProfiler.h>
 
-    if (threadCount == 0) {
-        threadCount = 1;
-    }
+ThreadPool::ThreadPool() : ThreadPool(std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    DEBUG_ASSERT(threadCount > 0);
 
     m_workers.reserve(threadCount);
 
@@ -32,6 +34,8 @@ void ThreadPool::Enqueue(std::function<void()> &&func) {
 }
 
 void ThreadPool::Worker() {
+    PROFILE_THREAD("Worker");
+
     while (true) {
         std::function<void()> job;
         {
@@ -51,9 +55,12 @@ void ThreadPool::Worker() {
             m_tasks.pop();
         }
 
-        job();
+        {
+            PROFILE_ZONE("ThreadPool::Task");
+            job();
+        }
 
-        m_pendingTasks.fetch_sub(1, std::memory_order::memory_order_acq_rel);
+        m_pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
         if (m_pendingTasks.load(std::memory_order_relaxed) == 0) {
             m_idleCv.notify_all();
         }
@@ -4,6 +4,9 @@
 
 enum class LightType : uint32_t;
 class VulkanPrefab;
+struct RenderSettings;
+class DrawList;
+class DynamicResolution;
 
 class UI {
 public:
@@ -19,6 +22,11 @@ public:
     void TransformationWindow(VulkanPrefab &instance, bool &uniformScale, size_t id);
     void CameraWindow();
     void LightsWindow();
+    void RenderSettingsWindow(RenderSettings &settings, const DynamicResolution &dynamicResolution);
+    void DrawStatsWindow(const DrawList &drawList);
+    void GpuProfilerWindow();
+    void CpuProfilerWindow();
+    void FramePacingWindow();
 
 private:
     int32_t LightSection(size_t idx);
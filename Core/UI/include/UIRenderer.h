@@ -5,9 +5,14 @@
 
 #include <vulkan/vulkan.h>
 
+#include <include/VulkanImage.h>
+
 #include "UI.h"
 
 class VulkanPrefab;
+struct RenderSettings;
+class DrawList;
+class DynamicResolution;
 
 class UIRenderer{
 public:
@@ -19,12 +24,24 @@ public:
     UIRenderer& operator=(const UIRenderer&) = delete;
     UIRenderer& operator=(UIRenderer&&) = delete;
 
+    // Draws the UI into the overlay and leaves it in shader read only layout for the post chain to composite
+    // Headless, the overlay is only cleared
     void Render();
 
     void Present();
 
+    // After the swapchain is recreated, which waits for the last frame's graphics and compute work to retire
+    // The overlay is only reallocated once the window outgrows it or leaves most of it unused
+    void Resize();
+
     void AddPrefabWindow(VulkanPrefab& prefab, size_t prefabIndex);
 
+    void AddRenderSettingsWindow(RenderSettings &settings, const DynamicResolution &dynamicResolution);
+
+    void AddDrawStatsWindow(const DrawList &drawList);
+
+    [[nodiscard]] const VulkanImage &GetOverlay() const { return m_overlay; }
+
 private:
     UI                                m_ui;
     std::deque<std::function<void()>> m_uiQueue;
@@ -33,7 +50,11 @@ private:
 
     VkDescriptorPool m_imguiDescriptorPool;
 
+    VulkanImage m_overlay; // Premultiplied alpha
+
     void Enqueue(std::function<void()> &&func) { m_uiQueue.push_back(func); }
 
     void CreateDescriptorPool();
+
+    void CreateOverlay(VkExtent2D extent);
 };
\ No newline at end of file
@@ -1,12 +1,25 @@
 #include "include/UI.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "imgui.h"
 
+#include <SDL3/SDL_log.h>
+
 #include <include/VulkanPrefab.h>
 
 #include <include/Window.h>
 #include <include/Camera.h>
+#include <include/CpuProfiler.h>
+#include <include/DrawList.h>
+#include <include/DynamicResolution.h>
+#include <include/FramePacer.h>
+#include <include/GpuProfiler.h>
 #include <include/LightManager.h>
+#include <include/RenderSettings.h>
+#include <include/SamplerCache.h>
+#include <include/VulkanState.h>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -117,16 +130,22 @@ void UI::CameraWindow() {
 }
 
 void UI::LightsWindow() {
-    bool addPoint       = false;
+    bool addPoint      = false;
+    bool addPointBatch = false;
 
     int removeLightIndex = -1;
 
-    ImGui::Begin("Lights(Max 16)");
+    size_t lightCount = LightManager::GetInstance().GetLightCount();
+
+    ImGui::Begin("Lights");
+    ImGui::Text("%zu / %zu", lightCount, MAX_LIGHT_COUNT);
     if (ImGui::Button("Add Point")) {
         addPoint = true;
     }
-
-    size_t lightCount = LightManager::GetInstance().GetLightCount();
+    ImGui::SameLine();
+    if (ImGui::Button("Add 256 Points")) {
+        addPointBatch = true;
+    }
 
     if (lightCount > 0) {
         for (size_t i = 0; i < lightCount; i++) {
@@ -147,6 +166,10 @@ void UI::LightsWindow() {
     if (addPoint) {
         LightManager::GetInstance().AddLight(LightType::Point);
     }
+    if (addPointBatch) {
+        // Small lights spread over the scene to stress the clustering
+        LightManager::GetInstance().AddPointLights(256, glm::vec3(-0.5f, 0.02f, -0.5f), glm::vec3(0.5f, 0.3f, 0.5f), 0.15f);
+    }
     if (removeLightIndex > -1) {
         LightManager::GetInstance().RemoveLight(removeLightIndex);
     }
@@ -192,3 +215,234 @@ int32_t UI::LightSection(size_t idx) {
 
     return -1;
 }
+
+void UI::RenderSettingsWindow(RenderSettings &settings, const DynamicResolution &dynamicResolution) {
+    ImGui::Begin("Renderer");
+    ImGui::Checkbox("GPU Culling", &settings.gpuCulling);
+    ImGui::BeginDisabled(!settings.gpuCulling);
+    ImGui::Checkbox("Occlusion Culling", &settings.occlusionCulling);
+    ImGui::EndDisabled();
+    // GPU culled shadows are drawn in one piece, only the skip of unchanged frames applies
+    ImGui::BeginDisabled(settings.gpuCulling);
+    ImGui::Checkbox("Shadow Caching", &settings.shadowCaching);
+    ImGui::EndDisabled();
+
+    ImGui::SeparatorText("Post-Processing");
+    ImGui::Checkbox("Bloom", &settings.bloom);
+    ImGui::BeginDisabled(!settings.bloom);
+    ImGui::SliderFloat("Bloom Threshold", &settings.bloomThreshold, 0.0f, 10.0f);
+    ImGui::SliderFloat("Bloom Intensity", &settings.bloomIntensity, 0.0f, 1.0f);
+    ImGui::EndDisabled();
+    ImGui::SliderFloat("Exposure", &settings.exposure, 0.1f, 10.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+    ImGui::Checkbox("FXAA", &settings.fxaa);
+    ImGui::BeginDisabled(!VulkanState::GetInstance().HasAsyncCompute());
+    ImGui::Checkbox("Async Compute", &settings.asyncCompute);
+    ImGui::EndDisabled();
+
+    ImGui::SeparatorText("Dynamic Resolution");
+    ImGui::BeginDisabled(!dynamicResolution.IsSupported());
+    ImGui::Checkbox("Enabled", &settings.dynamicResolution);
+    ImGui::EndDisabled();
+    ImGui::BeginDisabled(!settings.dynamicResolution);
+    ImGui::SliderFloat("Target (ms)", &settings.targetFrameTime, 4.0f, 50.0f, "%.1f");
+    ImGui::SliderFloat("Min Scale", &settings.minRenderScale, 0.25f, 1.0f, "%.2f");
+    ImGui::EndDisabled();
+    ImGui::SliderFloat("Sharpness", &settings.upscaleSharpness, 0.0f, 1.0f, "%.2f");
+    const VkExtent2D &extent = dynamicResolution.GetRenderExtent();
+    ImGui::Text("GPU: %.2f ms, %ux%u (%.0f%%)", dynamicResolution.GetGpuTime(), extent.width, extent.height, dynamicResolution.GetScale() * 100.0f);
+    ImGui::End();
+}
+
+void UI::DrawStatsWindow(const DrawList &drawList) {
+    constexpr const char *passNames[DRAW_PASS_COUNT] = {"Shadow", "Static Shadow", "Point Shadow", "G-Buffer", "Forward"};
+
+    ImGui::Begin("Draw Stats");
+    ImGui::Text("Packets: %zu", drawList.GetPacketCount());
+    ImGui::Text("Samplers: %zu", SamplerCache::GetInstance().GetSamplerCount());
+    ImGui::Text("Descriptor Pools: %zu", VulkanState::GetInstance().GetDescriptorAllocator().GetPoolCount());
+    if (ImGui::BeginTable("Passes", 4)) {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("Draws");
+        ImGui::TableSetupColumn("Mesh Binds");
+        ImGui::TableSetupColumn("Binds Saved");
+        ImGui::TableHeadersRow();
+
+        for (size_t i = 0; i < DRAW_PASS_COUNT; i++) {
+            const DrawStats &stats = drawList.GetStats(static_cast<DrawPass>(i));
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(passNames[i]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", stats.draws);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", stats.meshBinds);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", stats.savedBinds);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+
+void UI::GpuProfilerWindow() {
+    const GpuProfiler &profiler = GpuProfiler::GetInstance();
+
+    ImGui::Begin("GPU Profiler");
+    if (!profiler.IsSupported()) {
+        ImGui::Text("Timestamps unsupported");
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::BeginTable("Zones", 9)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Last (ms)");
+        ImGui::TableSetupColumn("Avg (ms)");
+        ImGui::TableSetupColumn("P50");
+        ImGui::TableSetupColumn("P95");
+        ImGui::TableSetupColumn("P99");
+        ImGui::TableSetupColumn("Primitives");
+        ImGui::TableSetupColumn("Fragments");
+        ImGui::TableSetupColumn("Compute");
+        ImGui::TableHeadersRow();
+
+        for (const GpuZoneStats &zone: profiler.GetZones()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(zone.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.GetLast());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.GetAverage());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.GetPercentile(0.5f));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.GetPercentile(0.95f));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.GetPercentile(0.99f));
+
+            for (PipelineStatistic statistic:
+                 {PipelineStatistic::ClippingPrimitives, PipelineStatistic::FragmentInvocations, PipelineStatistic::ComputeInvocations}) {
+                ImGui::TableNextColumn();
+                if (zone.hasStatistics) {
+                    ImGui::Text("%llu", static_cast<unsigned long long>(zone.statistics[static_cast<size_t>(statistic)]));
+                } else {
+                    ImGui::TextUnformatted("-");
+                }
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Export CSV")) {
+        if (!profiler.ExportCsv("gpu_profile.csv")) {
+            SDL_Log("Failed to export gpu_profile.csv");
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export JSON")) {
+        if (!profiler.ExportJson("gpu_profile.json")) {
+            SDL_Log("Failed to export gpu_profile.json");
+        }
+    }
+    ImGui::End();
+}
+
+void UI::CpuProfilerWindow() {
+    constexpr float ROW_HEIGHT = 18.0f;
+
+    const CpuProfiler &profiler = CpuProfiler::GetInstance();
+
+    ImGui::Begin("CPU Profiler");
+    if (!CpuProfiler::IsEnabled()) {
+        ImGui::Text("Built without VREZ_ENABLE_PROFILER");
+        ImGui::End();
+        return;
+    }
+
+    const uint64_t frameStart = profiler.GetFrameStart();
+    const uint64_t frameEnd   = profiler.GetFrameEnd();
+    ImGui::Text("Frame: %.3f ms", profiler.ToMilliseconds(frameEnd - frameStart));
+    ImGui::SameLine();
+    if (ImGui::Button("Export Trace")) {
+        if (!profiler.ExportChromeTrace("cpu_trace.json")) {
+            SDL_Log("Failed to export cpu_trace.json");
+        }
+    }
+    if (frameEnd <= frameStart) {
+        ImGui::End();
+        return;
+    }
+
+    // Flame view of the last frame, one lane per thread with zones stacked by depth
+    ImDrawList  *drawList = ImGui::GetWindowDrawList();
+    const float  width    = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+    const double scale    = width / static_cast<double>(frameEnd - frameStart);
+    for (const CpuThreadEvents &thread: profiler.Capture(frameStart, frameEnd)) {
+        if (thread.events.empty()) {
+            continue;
+        }
+
+        uint32_t maxDepth = 0;
+        for (const CpuZoneEvent &event: thread.events) {
+            maxDepth = std::max(maxDepth, event.depth);
+        }
+
+        ImGui::TextUnformatted(thread.name.c_str());
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::Dummy(ImVec2(width, ROW_HEIGHT * static_cast<float>(maxDepth + 1)));
+
+        for (const CpuZoneEvent &event: thread.events) {
+            const uint64_t start = std::max(event.start, frameStart);
+            const uint64_t end   = std::min(event.end, frameEnd);
+            const ImVec2   min(origin.x + static_cast<float>((start - frameStart) * scale), origin.y + ROW_HEIGHT * static_cast<float>(event.depth));
+            const ImVec2   max(std::max(origin.x + static_cast<float>((end - frameStart) * scale), min.x + 1.0f), min.y + ROW_HEIGHT - 1.0f);
+
+            // Color from the name's address, stable for a zone across frames
+            const auto  hash  = static_cast<uint32_t>(std::hash<const void *>{}(event.name));
+            const ImU32 color = IM_COL32(80 + hash % 128, 80 + (hash >> 8) % 128, 80 + (hash >> 16) % 128, 255);
+            drawList->AddRectFilled(min, max, color);
+
+            const ImVec2 textSize = ImGui::CalcTextSize(event.name);
+            if (textSize.x < max.x - min.x - 4.0f) {
+                drawList->AddText(ImVec2(min.x + 2.0f, min.y + (ROW_HEIGHT - textSize.y) * 0.5f), IM_COL32_WHITE, event.name);
+            }
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s: %.3f ms", event.name, profiler.ToMilliseconds(event.end - event.start));
+            }
+        }
+    }
+    ImGui::End();
+}
+
+void UI::FramePacingWindow() {
+    FramePacer        &pacer = FramePacer::GetInstance();
+    const VulkanState &state = VulkanState::GetInstance();
+
+    ImGui::Begin("Frame Pacing");
+    ImGui::Text("%s, %u swapchain images", PresentSettings::GetPresentModeName(state.GetPresentMode()), state.GetSwapchainImageCount());
+
+    float frameLimit = pacer.GetFrameLimit();
+    if (ImGui::SliderFloat("FPS Limit", &frameLimit, 0.0f, 480.0f, frameLimit > 0.0f ? "%.0f" : "Off")) {
+        pacer.SetFrameLimit(frameLimit);
+    }
+    bool lowLatency = pacer.IsLowLatency();
+    if (ImGui::Checkbox("Low Latency", &lowLatency)) {
+        pacer.SetLowLatency(lowLatency);
+    }
+
+    ImGui::SeparatorText("Input Latency");
+    const LatencyHistory &submit = pacer.GetInputToSubmit();
+    ImGui::Text("To submit: %.2f ms (avg %.2f ms)", submit.GetLast(), submit.GetAverage());
+    if (state.HasPresentWait()) {
+        const LatencyHistory &present = pacer.GetInputToPresent();
+        ImGui::Text("To display: %.2f ms (avg %.2f ms)", present.GetLast(), present.GetAverage());
+        // Oldest sample first once the ring is full
+        const size_t offset = present.sampleCount == LATENCY_HISTORY ? present.next : 0;
+        ImGui::PlotLines("##Latency", present.samples.data(), static_cast<int>(present.sampleCount), static_cast<int>(offset));
+    } else {
+        ImGui::TextUnformatted("To display: unavailable without present wait");
+    }
+    ImGui::End();
+}
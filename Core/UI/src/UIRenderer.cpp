@@ -10,6 +10,12 @@
 
 UIRenderer::UIRenderer() {
     CreateDescriptorPool();
+    CreateOverlay({VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight()});
+
+    // Headless runs keep an empty overlay so the post chain composites nothing
+    if (VulkanState::GetInstance().IsHeadless()) {
+        return;
+    }
 
     ImGui::CreateContext();
     ImGui_ImplSDL3_InitForVulkan(Window::GetInstance().GetSDLWindow());
@@ -34,7 +40,7 @@ UIRenderer::UIRenderer() {
         .Instance                    = VulkanState::GetInstance().GetVkInstance(),
         .PhysicalDevice              = VulkanState::GetInstance().GetPhysicalDevice(),
         .Device                      = VulkanState::GetInstance().GetDevice(),
-        .QueueFamily                 = 0,
+        .QueueFamily                 = VulkanState::GetInstance().GetGraphicsFamily(),
         .Queue                       = VulkanState::GetInstance().GetQueue(),
         .DescriptorPool              = m_imguiDescriptorPool,
         .RenderPass                  = VK_NULL_HANDLE,
@@ -50,6 +56,9 @@ UIRenderer::UIRenderer() {
 
     Enqueue([this]() { m_ui.CameraWindow(); });
     Enqueue([this]() { m_ui.LightsWindow(); });
+    Enqueue([this]() { m_ui.GpuProfilerWindow(); });
+    Enqueue([this]() { m_ui.CpuProfilerWindow(); });
+    Enqueue([this]() { m_ui.FramePacingWindow(); });
 }
 
 UIRenderer::~UIRenderer() {
@@ -59,26 +68,27 @@ UIRenderer::~UIRenderer() {
 }
 
 void UIRenderer::Render() {
-    // Layout transition for imgui draw
+    // Layout transition for imgui draw, last frame's overlay is discarded
     vk_util::CmdImageLayoutTransition(
         VulkanState::GetInstance().GetCommandBuffer(),
-        VulkanState::GetInstance().GetPresentImage(),
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        m_overlay.GetImage(),
+        VK_IMAGE_LAYOUT_UNDEFINED,
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
         VK_IMAGE_ASPECT_COLOR_BIT,
-        VK_ACCESS_TRANSFER_WRITE_BIT,
-        VK_ACCESS_TRANSFER_WRITE_BIT
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
     );
 
     VkRect2D renderAreas{
         .offset = {0,                                     0                                     },
         .extent = {VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight()}
     };
+    VkClearValue              clearValue{.color = {0.0f, 0.0f, 0.0f, 0.0f}};
     VkRenderingAttachmentInfo infoColorAttachment = vk_util::GetRenderingAttachmentInfo(
-        VulkanState::GetInstance().GetPresentImageView(),
+        m_overlay.GetImageView(),
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        nullptr,
-        VK_ATTACHMENT_LOAD_OP_LOAD,
+        &clearValue,
+        VK_ATTACHMENT_LOAD_OP_CLEAR,
         VK_ATTACHMENT_STORE_OP_STORE,
         VK_RESOLVE_MODE_NONE,
         VK_NULL_HANDLE,
@@ -89,9 +99,39 @@ void UIRenderer::Render() {
 
     vkCmdBeginRendering(VulkanState::GetInstance().GetCommandBuffer(), &infoRendering);
 
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), VulkanState::GetInstance().GetCommandBuffer());
+    if (!VulkanState::GetInstance().IsHeadless()) {
+        ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), VulkanState::GetInstance().GetCommandBuffer());
+    }
 
     vkCmdEndRendering(VulkanState::GetInstance().GetCommandBuffer());
+
+    vk_util::CmdImageLayoutTransition(
+        VulkanState::GetInstance().GetCommandBuffer(),
+        m_overlay.GetImage(),
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT
+    );
+}
+
+void UIRenderer::Resize() {
+    const VkExtent2D current{m_overlay.GetExtent().width, m_overlay.GetExtent().height};
+    const VkExtent2D target = vk_util::GetTargetExtent(current, {VulkanState::GetInstance().GetWidth(), VulkanState::GetInstance().GetHeight()});
+    if (target.width != current.width || target.height != current.height) {
+        CreateOverlay(target);
+    }
+}
+
+void UIRenderer::CreateOverlay(VkExtent2D extent) {
+    VulkanImage overlay(
+        VK_FORMAT_R16G16B16A16_SFLOAT,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        {extent.width, extent.height, 1},
+        VK_IMAGE_ASPECT_COLOR_BIT
+    );
+    m_overlay = std::move(overlay);
 }
 
 void UIRenderer::AddPrefabWindow(VulkanPrefab &prefab, size_t prefabIndex) {
@@ -103,6 +143,14 @@ void UIRenderer::AddPrefabWindow(VulkanPrefab &prefab, size_t prefabIndex) {
     });
 }
 
+void UIRenderer::AddRenderSettingsWindow(RenderSettings &settings, const DynamicResolution &dynamicResolution) {
+    Enqueue([this, &settings, &dynamicResolution]() { m_ui.RenderSettingsWindow(settings, dynamicResolution); });
+}
+
+void UIRenderer::AddDrawStatsWindow(const DrawList &drawList) {
+    Enqueue([this, &drawList]() { m_ui.DrawStatsWindow(drawList); });
+}
+
 void UIRenderer::Present() {
     for (auto it = m_uiQueue.begin(); it != m_uiQueue.end(); ++it) {
         (*it)();
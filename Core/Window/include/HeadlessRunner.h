@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+struct HeadlessConfig {
+    uint32_t    width        = 1600;
+    uint32_t    height       = 900;
+    uint32_t    frameCount   = 300;
+    uint32_t    warmupFrames = 30; // Rendered before timings are kept, while caches and the shadow atlas settle
+    std::string cameraPath   = "orbit";
+    std::string timingsFile  = "headless_timings.csv";
+    std::string imageFile; // PPM of the final frame, skipped when empty
+
+    // Parses --headless [--frames N] [--warmup N] [--size WxH] [--camera PATH] [--timings FILE] [--dump FILE]
+    // Empty when --headless is missing
+    static std::optional<HeadlessConfig> FromArgs(int argc, char *argv[]);
+};
+
+// Renders a fixed number of frames along a scripted camera path without a window, for benchmarks and CI
+// Expects VulkanState to be initialized headless and the asset managers to be loaded
+class HeadlessRunner {
+public:
+    HeadlessRunner() = delete;
+
+    explicit HeadlessRunner(HeadlessConfig config);
+
+    ~HeadlessRunner() = default;
+
+    HeadlessRunner(const HeadlessRunner &)            = delete;
+    HeadlessRunner(HeadlessRunner &&)                 = delete;
+    HeadlessRunner &operator=(const HeadlessRunner &) = delete;
+    HeadlessRunner &operator=(HeadlessRunner &&)      = delete;
+
+    // Returns false when the timings or the image could not be written
+    bool Run();
+
+private:
+    HeadlessConfig m_config;
+
+    [[nodiscard]] bool DumpImage() const;
+};
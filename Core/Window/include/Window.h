@@ -32,7 +32,8 @@ private:
 
     uint32_t m_lastTime;
 
-    bool m_running = false;
+    bool m_running   = false;
+    bool m_minimized = false; // Rendering stops until the window is restored
 
     bool  m_cameraMode = false;
     bool  m_firstMouse = true;
@@ -0,0 +1,195 @@
+#include "include/HeadlessRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#include <SDL3/SDL_log.h>
+#include <glm/gtc/packing.hpp>
+
+#include <Debug.h>
+
+#include <include/CameraPath.h>
+#include <include/CpuProfiler.h>
+#include <include/GpuProfiler.h>
+#include <include/PbrRenderer.h>
+#include <include/UIRenderer.h>
+#include <include/VulkanBuffer.h>
+#include <include/VulkanState.h>
+#include <include/VulkanUtil.h>
+
+std::optional<HeadlessConfig> HeadlessConfig::FromArgs(int argc, char *argv[]) {
+    HeadlessConfig config;
+    bool           headless = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg   = argv[i];
+        const char       *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (arg == "--headless") {
+            headless = true;
+            continue;
+        }
+        // Window only, parsed by PresentSettings
+        if (arg == "--low-latency") {
+            continue;
+        }
+        DEBUG_ASSERT_LOG(value != nullptr, (arg + " expects a value").c_str());
+        i++;
+
+        if (arg == "--frames") {
+            config.frameCount = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--warmup") {
+            config.warmupFrames = static_cast<uint32_t>(std::stoul(value));
+        } else if (arg == "--size") {
+            DEBUG_ASSERT_LOG(std::sscanf(value, "%ux%u", &config.width, &config.height) == 2, "--size expects WIDTHxHEIGHT");
+        } else if (arg == "--camera") {
+            config.cameraPath = value;
+        } else if (arg == "--timings") {
+            config.timingsFile = value;
+        } else if (arg == "--dump") {
+            config.imageFile = value;
+        } else if (arg == "--present" || arg == "--swapchain-images" || arg == "--fps-limit") {
+            continue;
+        } else {
+            DEBUG_ASSERT_LOG(false, ("Unknown argument " + arg).c_str());
+        }
+    }
+
+    if (!headless) {
+        return std::nullopt;
+    }
+    DEBUG_ASSERT_LOG(config.frameCount > 0 && config.width > 0 && config.height > 0, "Headless runs need frames and a size");
+    return config;
+}
+
+HeadlessRunner::HeadlessRunner(HeadlessConfig config) : m_config(std::move(config)) {}
+
+bool HeadlessRunner::Run() {
+    SDL_Log("Headless run of %u frames at %ux%u", m_config.frameCount, m_config.width, m_config.height);
+
+    UIRenderer  uiRenderer;
+    PbrRenderer pbrRenderer(uiRenderer);
+
+    const CameraPath path = CameraPath::Load(m_config.cameraPath);
+
+    // Frames are spread evenly over the path, so the views do not depend on how fast the machine is
+    // The extra frames at the end only read back the GPU timings of the last measured frames
+    const uint32_t     measuredEnd = m_config.warmupFrames + m_config.frameCount;
+    const uint32_t     totalFrames = measuredEnd + GPU_PROFILER_FRAME_LATENCY;
+    std::vector<float> frameTimes(m_config.frameCount, 0.0f);
+    std::vector<float> gpuTimes(m_config.frameCount, 0.0f);
+
+    for (uint32_t frame = 0; frame < totalFrames; frame++) {
+        PROFILE_FRAME();
+        PROFILE_ZONE("HeadlessRunner::Frame");
+
+        const uint32_t pathFrame = std::clamp(frame, m_config.warmupFrames, measuredEnd - 1) - m_config.warmupFrames;
+        const float    ratio     = m_config.frameCount > 1 ? static_cast<float>(pathFrame) / static_cast<float>(m_config.frameCount - 1) : 0.0f;
+        path.Apply(ratio * path.GetDuration());
+
+        const auto start = std::chrono::steady_clock::now();
+
+        VulkanState::GetInstance().BeginFrame();
+        GpuProfiler::GetInstance().BeginFrame();
+        if (frame >= m_config.warmupFrames + GPU_PROFILER_FRAME_LATENCY) {
+            gpuTimes[frame - GPU_PROFILER_FRAME_LATENCY - m_config.warmupFrames] = GpuProfiler::GetInstance().GetFrameTime();
+        }
+
+        pbrRenderer.Render();
+        uiRenderer.Render();
+        pbrRenderer.PostProcess();
+
+        VulkanState::GetInstance().EndFrame();
+
+        // Includes the wait on the previous frame, so this is the frame to frame time
+        if (frame >= m_config.warmupFrames && frame < measuredEnd) {
+            frameTimes[frame - m_config.warmupFrames] = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    VulkanState::GetInstance().WaitForLastFrame();
+
+    const auto count = static_cast<float>(m_config.frameCount);
+    SDL_Log(
+        "Headless run done, average frame %.3f ms, average GPU %.3f ms",
+        std::accumulate(frameTimes.begin(), frameTimes.end(), 0.0f) / count,
+        std::accumulate(gpuTimes.begin(), gpuTimes.end(), 0.0f) / count
+    );
+
+    bool succeeded = true;
+    {
+        std::ofstream file(m_config.timingsFile);
+        if (file) {
+            file << "frame,frame_ms,gpu_ms\n";
+            for (uint32_t i = 0; i < m_config.frameCount; i++) {
+                file << i << ',' << frameTimes[i] << ',' << gpuTimes[i] << '\n';
+            }
+            SDL_Log("Frame timings written to %s", m_config.timingsFile.c_str());
+        } else {
+            SDL_Log("Failed to open %s", m_config.timingsFile.c_str());
+            succeeded = false;
+        }
+    }
+
+    if (!m_config.imageFile.empty()) {
+        succeeded = DumpImage() && succeeded;
+    }
+    return succeeded;
+}
+
+bool HeadlessRunner::DumpImage() const {
+    constexpr size_t CHANNEL_COUNT = 4;
+
+    const uint32_t width  = VulkanState::GetInstance().GetWidth();
+    const uint32_t height = VulkanState::GetInstance().GetHeight();
+    const size_t   size   = sizeof(uint16_t) * CHANNEL_COUNT * width * height;
+
+    // The post chain leaves the present image in transfer source layout when headless
+    VulkanBuffer readback(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    VulkanState::GetInstance().ImmediateSubmit([&](VkCommandBuffer cmdBuf) {
+        vk_util::CmdMemoryBarrier(
+            cmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT
+        );
+
+        VkBufferImageCopy region{
+            .bufferOffset      = 0,
+            .bufferRowLength   = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource  = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+            .imageOffset       = {0, 0, 0},
+            .imageExtent       = {width, height, 1},
+        };
+        vkCmdCopyImageToBuffer(
+            cmdBuf, VulkanState::GetInstance().GetPresentImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.GetBuffer(), 1, &region
+        );
+    });
+
+    std::vector<uint16_t> pixels(size / sizeof(uint16_t));
+    readback.Download(size, pixels.data());
+
+    std::ofstream file(m_config.imageFile, std::ios::binary);
+    if (!file) {
+        SDL_Log("Failed to open %s", m_config.imageFile.c_str());
+        return false;
+    }
+
+    // The chain already wrote sRGB encoded values, they only need quantizing
+    file << "P6\n" << width << ' ' << height << "\n255\n";
+    std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const uint16_t *pixel = &pixels[(static_cast<size_t>(y) * width + x) * CHANNEL_COUNT];
+            unsigned char  *rgb   = &row[static_cast<size_t>(x) * 3];
+            for (size_t c = 0; c < 3; c++) {
+                rgb[c] = static_cast<unsigned char>(std::clamp(glm::unpackHalf1x16(pixel[c]), 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+        file.write(reinterpret_cast<const char *>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+
+    SDL_Log("Final frame written to %s", m_config.imageFile.c_str());
+    return true;
+}
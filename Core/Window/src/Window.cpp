@@ -7,6 +7,9 @@
 #include <Debug.h>
 
 #include <include/Camera.h>
+#include <include/CpuProfiler.h>
+#include <include/FramePacer.h>
+#include <include/GpuProfiler.h>
 #include <include/LightManager.h>
 #include <include/PbrRenderer.h>
 #include <include/PipelineManager.h>
@@ -16,6 +19,9 @@
 namespace {
 constexpr int WINDOW_WIDTH  = 1600;
 constexpr int WINDOW_HEIGHT = 900;
+
+// Milliseconds, skipped frames wait this long for an event before retrying
+constexpr int SKIPPED_FRAME_WAIT = 100;
 } // namespace
 
 Window::Window() {
@@ -28,21 +34,37 @@ Window::~Window() {
 }
 
 void Window::CreateWindow() {
-    m_window = SDL_CreateWindow("VulkanApp", WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_VULKAN);
-
-    m_width  = WINDOW_WIDTH;
-    m_height = WINDOW_HEIGHT;
+    m_window = SDL_CreateWindow("VulkanApp", WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
     DEBUG_ASSERT(m_window);
+
+    // The swapchain is sized in pixels, which differ from window coordinates on high density displays
+    int width  = 0;
+    int height = 0;
+    SDL_GetWindowSizeInPixels(m_window, &width, &height);
+    m_width  = static_cast<uint32_t>(width);
+    m_height = static_cast<uint32_t>(height);
 }
 
 void Window::Run() {
-    SDL_Log("SDL Window(%dx%d) running", WINDOW_WIDTH, WINDOW_HEIGHT);
+    SDL_Log("SDL Window(%ux%u) running", m_width, m_height);
     m_running = true;
 
     UIRenderer  uiRenderer;
     PbrRenderer pbrRenderer(uiRenderer);
+    uint64_t    swapchainGeneration = VulkanState::GetInstance().GetSwapchainGeneration();
 
     while (m_running) {
+        PROFILE_FRAME();
+        PROFILE_ZONE("Window::Run");
+
+        // Nothing is drawn while minimized, so block until the next event instead of spinning
+        if (m_minimized) {
+            PROFILE_ZONE("Window::WaitMinimized");
+            SDL_WaitEvent(nullptr);
+        }
+
+        FramePacer::GetInstance().WaitForNextFrame();
+
         uint32_t  time = SDL_GetTicks();
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
@@ -50,6 +72,18 @@ void Window::Run() {
             case SDL_EVENT_QUIT:
                 m_running = false;
                 break;
+            case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+                m_width  = static_cast<uint32_t>(event.window.data1);
+                m_height = static_cast<uint32_t>(event.window.data2);
+                VulkanState::GetInstance().Resize(m_width, m_height);
+                break;
+            case SDL_EVENT_WINDOW_MINIMIZED:
+                m_minimized = true;
+                break;
+            case SDL_EVENT_WINDOW_RESTORED:
+            case SDL_EVENT_WINDOW_MAXIMIZED:
+                m_minimized = false;
+                break;
             default:
                 break;
             }
@@ -57,24 +91,53 @@ void Window::Run() {
             ProcessCamera(event, static_cast<float>(time - m_lastTime) / 1000.0f);
             ImGui_ImplSDL3_ProcessEvent(&event);
         }
-        // imgui new frame
-        ImGui_ImplVulkan_NewFrame();
-        ImGui_ImplSDL3_NewFrame();
-        ImGui::NewFrame();
+        m_lastTime = time;
+        if (m_minimized || !m_running) {
+            continue;
+        }
+
+        {
+            PROFILE_ZONE("ImGui");
+            // imgui new frame
+            ImGui_ImplVulkan_NewFrame();
+            ImGui_ImplSDL3_NewFrame();
+            ImGui::NewFrame();
+
+            uiRenderer.Present();
+            ImGui::Render();
+        }
 
-        uiRenderer.Present();
-        ImGui::Render();
+        // Between frames, so a frame records with one set of pipelines throughout
+        PipelineManager::GetInstance().Update();
 
-        VulkanState::GetInstance().BeginFrame();
+        {
+            PROFILE_ZONE("VulkanState::BeginFrame");
+            if (!VulkanState::GetInstance().BeginFrame()) {
+                // No surface to draw into, a zero sized window that is not reported minimized waits for events too
+                SDL_WaitEventTimeout(nullptr, SKIPPED_FRAME_WAIT);
+                continue;
+            }
+        }
+
+        // The swapchain was recreated after the last frame's graphics and compute work retired, so resizing can free its targets
+        if (swapchainGeneration != VulkanState::GetInstance().GetSwapchainGeneration()) {
+            swapchainGeneration = VulkanState::GetInstance().GetSwapchainGeneration();
+            uiRenderer.Resize();
+            pbrRenderer.Resize(uiRenderer.GetOverlay());
+        }
+        GpuProfiler::GetInstance().BeginFrame();
 
         pbrRenderer.Render();
         uiRenderer.Render();
+        pbrRenderer.PostProcess();
 
-        VulkanState::GetInstance().EndFrame();
-
-        m_lastTime = time;
+        {
+            PROFILE_ZONE("VulkanState::EndFrame");
+            VulkanState::GetInstance().EndFrame();
+        }
+        FramePacer::GetInstance().EndFrame();
     }
-    SDL_Log("SDL Window(%dx%d) quitting", WINDOW_WIDTH, WINDOW_HEIGHT);
+    SDL_Log("SDL Window(%ux%u) quitting", m_width, m_height);
 
     VulkanState::GetInstance().WaitIdle();
 
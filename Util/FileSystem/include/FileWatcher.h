@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace file_system {
+// Reports files written in the watched directories, subdirectories are watched separately
+// Uses inotify on Linux, elsewhere write times are compared every POLL_INTERVAL
+class FileWatcher {
+public:
+    FileWatcher() = default;
+
+    ~FileWatcher() { Stop(); }
+
+    FileWatcher(const FileWatcher &)            = delete;
+    FileWatcher(FileWatcher &&)                 = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+    FileWatcher &operator=(FileWatcher &&)      = delete;
+
+    // dir ends with a separator, reported paths are dir followed by the file name
+    void Watch(const std::string &dir);
+
+    void Stop();
+
+    // Never blocks, a file written several times since the last poll is reported once
+    [[nodiscard]] std::vector<std::string> Poll();
+
+private:
+#ifdef __linux__
+    int                        m_fd = -1;
+    std::map<int, std::string> m_dirs; // Watch descriptor to directory
+#else
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{500};
+
+    std::vector<std::string>                               m_dirs;
+    std::map<std::string, std::filesystem::file_time_type> m_writeTimes;
+    std::chrono::steady_clock::time_point                  m_nextScan;
+
+    void Scan(const std::string &dir, std::vector<std::string> &changed);
+#endif
+};
+} // namespace file_system
@@ -23,6 +23,10 @@ public:
     bool        GetBool(const std::string &key);
     bool        GetBool(const std::string &key, const bool defaultValue);
 
+    // Views stay valid for the lifetime of the file
+    simdjson::dom::array  GetArray(const std::string &key);
+    simdjson::dom::object GetObject(const std::string &key);
+
 private:
     simdjson::dom::parser  m_parser;
     simdjson::dom::element m_doc;
@@ -0,0 +1,109 @@
+#include "include/FileWatcher.h"
+
+#include <algorithm>
+
+#include <SDL3/SDL_log.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+void file_system::FileWatcher::Watch(const std::string &dir) {
+    if (m_fd < 0) {
+        m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_fd < 0) {
+            SDL_Log("Failed to initialize inotify, %s is not watched", dir.c_str());
+            return;
+        }
+    }
+
+    // Editors either write in place or rename a temporary file over the original
+    const int wd = inotify_add_watch(m_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        SDL_Log("Failed to watch %s", dir.c_str());
+        return;
+    }
+    m_dirs[wd] = dir;
+}
+
+void file_system::FileWatcher::Stop() {
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+    m_fd = -1;
+    m_dirs.clear();
+}
+
+std::vector<std::string> file_system::FileWatcher::Poll() {
+    std::vector<std::string> changed;
+    if (m_fd < 0) {
+        return changed;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    ssize_t                     length = 0;
+    while ((length = read(m_fd, buffer, sizeof(buffer))) > 0) {
+        for (const char *ptr = buffer; ptr < buffer + length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(ptr);
+            const auto  dir   = m_dirs.find(event->wd);
+            if (event->len > 0 && !(event->mask & IN_ISDIR) && dir != m_dirs.end()) {
+                changed.emplace_back(dir->second + event->name);
+            }
+            ptr += sizeof(inotify_event) + event->len;
+        }
+    }
+
+    std::ranges::sort(changed);
+    changed.erase(std::ranges::unique(changed).begin(), changed.end());
+    return changed;
+}
+#else
+void file_system::FileWatcher::Watch(const std::string &dir) {
+    // Files present now are the baseline, only later writes are reported
+    std::vector<std::string> ignored;
+    Scan(dir, ignored);
+    m_dirs.push_back(dir);
+}
+
+void file_system::FileWatcher::Stop() {
+    m_dirs.clear();
+    m_writeTimes.clear();
+}
+
+std::vector<std::string> file_system::FileWatcher::Poll() {
+    std::vector<std::string> changed;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < m_nextScan) {
+        return changed;
+    }
+    m_nextScan = now + POLL_INTERVAL;
+
+    for (const std::string &dir: m_dirs) {
+        Scan(dir, changed);
+    }
+    return changed;
+}
+
+void file_system::FileWatcher::Scan(const std::string &dir, std::vector<std::string> &changed) {
+    std::error_code error;
+    for (const auto &entry: std::filesystem::directory_iterator(dir, error)) {
+        if (!entry.is_regular_file(error)) {
+            continue;
+        }
+
+        const auto time = entry.last_write_time(error);
+        if (error) {
+            continue;
+        }
+
+        const auto [writeTime, inserted] = m_writeTimes.try_emplace(dir + entry.path().filename().string(), time);
+        if (!inserted && writeTime->second != time) {
+            writeTime->second = time;
+            changed.push_back(writeTime->first);
+        }
+    }
+}
+#endif
@@ -43,4 +43,11 @@ bool file_system::JsonFile::GetBool(const std::string &key) {
 
 bool file_system::JsonFile::GetBool(const std::string &key, const bool defaultValue) {
     return static_cast<bool>(GetField<bool>(key, defaultValue));
-}
\ No newline at end of file
+}
+simdjson::dom::array file_system::JsonFile::GetArray(const std::string &key) {
+    return GetCriticalField<simdjson::dom::array>(key);
+}
+
+simdjson::dom::object file_system::JsonFile::GetObject(const std::string &key) {
+    return GetCriticalField<simdjson::dom::object>(key);
+}
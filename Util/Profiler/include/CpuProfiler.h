@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <Singleton.h>
+
+// Set by the VREZ_ENABLE_PROFILER CMake option, zones compile to nothing when 0
+#ifndef VREZ_PROFILER_ENABLED
+#define VREZ_PROFILER_ENABLED 1
+#endif
+
+inline constexpr size_t CPU_ZONE_RING_SIZE = 8192; // Zones kept per thread, power of two
+
+struct CpuZoneEvent {
+    const char *name  = nullptr; // String literal, zones never copy their name
+    uint64_t    start = 0;       // Ticks
+    uint64_t    end   = 0;
+    uint32_t    depth = 0;
+};
+
+struct CpuThreadEvents {
+    std::string               name;
+    std::vector<CpuZoneEvent> events; // Oldest first
+};
+
+// Scoped zones recorded into one lock-free ring per thread, timestamps come from the TSC
+class CpuProfiler : public Singleton<CpuProfiler> {
+public:
+    // Anchors ticks to the steady clock, called on the main thread before any zone
+    void Init();
+
+    // Names the calling thread in captures, must come before its first zone
+    void RegisterThread(const char *name);
+
+    // Closes the previous frame of the main thread and refines the tick rate
+    void BeginFrame();
+
+    // Only the calling thread writes its ring, so recording takes no lock
+    void Record(const char *name, uint64_t start, uint64_t end, uint32_t depth);
+
+    // Zones of every thread overlapping [from, to], safe while threads keep recording
+    [[nodiscard]] std::vector<CpuThreadEvents> Capture(uint64_t from, uint64_t to) const;
+
+    // Start and end ticks of the last finished frame
+    [[nodiscard]] uint64_t GetFrameStart() const { return m_lastFrameStart; }
+
+    [[nodiscard]] uint64_t GetFrameEnd() const { return m_lastFrameEnd; }
+
+    [[nodiscard]] double ToMilliseconds(uint64_t ticks) const { return static_cast<double>(ticks) / m_ticksPerMicrosecond * 1e-3; }
+
+    // Chrome trace event format, opens in chrome://tracing and Perfetto
+    [[nodiscard]] bool ExportChromeTrace(const std::string &path) const;
+
+    [[nodiscard]] static constexpr bool IsEnabled() { return VREZ_PROFILER_ENABLED != 0; }
+
+    static uint64_t Now() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+protected:
+    CpuProfiler()  = default;
+    ~CpuProfiler() = default;
+
+private:
+    // A sequence number per slot makes reads of a slot being overwritten detectable
+    struct Slot {
+        std::atomic<uint64_t>     sequence{0}; // Odd while written, 2 * index + 2 once written
+        std::atomic<const char *> name{nullptr};
+        std::atomic<uint64_t>     start{0};
+        std::atomic<uint64_t>     end{0};
+        std::atomic<uint32_t>     depth{0};
+    };
+
+    struct ThreadRing {
+        std::string                          name;
+        std::array<Slot, CPU_ZONE_RING_SIZE> slots;
+        alignas(64) std::atomic<uint64_t>    head{0}; // Zones ever written
+    };
+
+    static thread_local ThreadRing *s_threadRing;
+
+    mutable std::mutex                       m_mutex; // Guards the ring list and names, never taken when recording
+    std::vector<std::unique_ptr<ThreadRing>> m_rings;
+
+    uint64_t                              m_baseTicks           = 0;
+    std::chrono::steady_clock::time_point m_baseTime;
+    double                                m_ticksPerMicrosecond = 1.0;
+    uint64_t                              m_frameStart          = 0;
+    uint64_t                              m_lastFrameStart      = 0;
+    uint64_t                              m_lastFrameEnd        = 0;
+
+    ThreadRing &GetThreadRing(const char *name);
+    void        Calibrate();
+};
+
+// Records the time spent in its scope
+class CpuZone {
+public:
+    explicit CpuZone(const char *name) : m_name(name), m_depth(s_depth++), m_start(CpuProfiler::Now()) {}
+
+    ~CpuZone() {
+        s_depth--;
+        CpuProfiler::GetInstance().Record(m_name, m_start, CpuProfiler::Now(), m_depth);
+    }
+
+    CpuZone(const CpuZone &)            = delete;
+    CpuZone(CpuZone &&)                 = delete;
+    CpuZone &operator=(const CpuZone &) = delete;
+    CpuZone &operator=(CpuZone &&)      = delete;
+
+private:
+    static inline thread_local uint32_t s_depth = 0;
+
+    const char *m_name  = nullptr;
+    uint32_t    m_depth = 0;
+    uint64_t    m_start = 0;
+};
+
+#if VREZ_PROFILER_ENABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) CpuZone PROFILE_CONCAT(cpuZone, __LINE__)(name)
+#define PROFILE_THREAD(name) CpuProfiler::GetInstance().RegisterThread(name)
+#define PROFILE_FRAME() CpuProfiler::GetInstance().BeginFrame()
+#else
+#define PROFILE_ZONE(name) ((void) 0)
+#define PROFILE_THREAD(name) ((void) 0)
+#define PROFILE_FRAME() ((void) 0)
+#endif
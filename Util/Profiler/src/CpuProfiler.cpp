@@ -0,0 +1,157 @@
+#include "include/CpuProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include <SDL3/SDL_log.h>
+
+namespace {
+constexpr uint64_t RING_MASK = CPU_ZONE_RING_SIZE - 1;
+static_assert((CPU_ZONE_RING_SIZE & RING_MASK) == 0, "CPU_ZONE_RING_SIZE must be a power of two");
+
+// The calibration window stops being refined once it is long enough to be exact
+constexpr double CALIBRATION_SECONDS = 10.0;
+
+void WriteEscaped(std::ofstream &file, const char *text) {
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            file << '\\';
+        }
+        file << *c;
+    }
+}
+} // namespace
+
+thread_local CpuProfiler::ThreadRing *CpuProfiler::s_threadRing = nullptr;
+
+void CpuProfiler::Init() {
+    m_baseTime   = std::chrono::steady_clock::now();
+    m_baseTicks  = Now();
+    m_frameStart = m_baseTicks;
+    RegisterThread("Main");
+}
+
+void CpuProfiler::RegisterThread(const char *name) {
+    ThreadRing &ring = GetThreadRing(name);
+
+    std::scoped_lock lock(m_mutex);
+    ring.name = name;
+}
+
+void CpuProfiler::BeginFrame() {
+    const uint64_t now = Now();
+    m_lastFrameStart   = m_frameStart;
+    m_lastFrameEnd     = now;
+    m_frameStart       = now;
+
+    Calibrate();
+}
+
+void CpuProfiler::Calibrate() {
+    const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_baseTime).count();
+    if (elapsed <= 0.0 || elapsed > CALIBRATION_SECONDS * 1e6) {
+        return;
+    }
+    m_ticksPerMicrosecond = static_cast<double>(Now() - m_baseTicks) / elapsed;
+}
+
+CpuProfiler::ThreadRing &CpuProfiler::GetThreadRing(const char *name) {
+    if (s_threadRing == nullptr) {
+        std::scoped_lock lock(m_mutex);
+        m_rings.push_back(std::make_unique<ThreadRing>());
+        m_rings.back()->name = name != nullptr ? name : "Thread " + std::to_string(m_rings.size() - 1);
+        s_threadRing         = m_rings.back().get();
+    }
+    return *s_threadRing;
+}
+
+void CpuProfiler::Record(const char *name, uint64_t start, uint64_t end, uint32_t depth) {
+    ThreadRing    &ring  = GetThreadRing(nullptr);
+    const uint64_t index = ring.head.load(std::memory_order_relaxed);
+    Slot          &slot  = ring.slots[index & RING_MASK];
+
+    // Seqlock write, on x86 every store and fence here compiles to a plain mov
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+std::vector<CpuThreadEvents> CpuProfiler::Capture(uint64_t from, uint64_t to) const {
+    std::scoped_lock lock(m_mutex);
+
+    std::vector<CpuThreadEvents> threads;
+    threads.reserve(m_rings.size());
+    for (const auto &ring: m_rings) {
+        CpuThreadEvents &thread = threads.emplace_back();
+        thread.name             = ring->name;
+
+        // Zones are written in order of their end, walk back until they end before the range
+        const uint64_t head  = ring->head.load(std::memory_order_acquire);
+        const uint64_t first = head > CPU_ZONE_RING_SIZE ? head - CPU_ZONE_RING_SIZE : 0;
+        for (uint64_t index = head; index > first; index--) {
+            const Slot &slot = ring->slots[(index - 1) & RING_MASK];
+
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * (index - 1) + 2) {
+                break; // Lapped by the writer, everything older is gone too
+            }
+            CpuZoneEvent event{
+                .name  = slot.name.load(std::memory_order_relaxed),
+                .start = slot.start.load(std::memory_order_relaxed),
+                .end   = slot.end.load(std::memory_order_relaxed),
+                .depth = slot.depth.load(std::memory_order_relaxed),
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+                break;
+            }
+
+            if (event.end < from) {
+                break;
+            }
+            if (event.start <= to) {
+                thread.events.push_back(event);
+            }
+        }
+        std::reverse(thread.events.begin(), thread.events.end());
+    }
+    return threads;
+}
+
+bool CpuProfiler::ExportChromeTrace(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file) {
+        SDL_Log("Failed to open %s", path.c_str());
+        return false;
+    }
+
+    const std::vector<CpuThreadEvents> threads = Capture(0, UINT64_MAX);
+
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+    for (size_t tid = 0; tid < threads.size(); tid++) {
+        file << (tid == 0 ? "\n" : ",\n") << R"(  {"name": "thread_name", "ph": "M", "pid": 1, "tid": )" << tid << R"(, "args": {"name": ")";
+        WriteEscaped(file, threads[tid].name.c_str());
+        file << "\"}}";
+
+        for (const CpuZoneEvent &event: threads[tid].events) {
+            // Timestamps in microseconds from Init
+            const double start    = static_cast<double>(event.start - std::min(event.start, m_baseTicks)) / m_ticksPerMicrosecond;
+            const double duration = static_cast<double>(event.end - event.start) / m_ticksPerMicrosecond;
+
+            file << ",\n  {\"name\": \"";
+            WriteEscaped(file, event.name);
+            file << R"(", "ph": "X", "pid": 1, "tid": )" << tid << ", \"ts\": " << start << ", \"dur\": " << duration << '}';
+        }
+    }
+    file << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+    SDL_Log("CPU trace written to %s", path.c_str());
+    return true;
+}
@@ -8,43 +8,74 @@
 
 #include <Debug.h>
 #include <include/Window.h>
+#include <include/HeadlessRunner.h>
 #include <include/ThreadPool.h>
 #include <include/TextureManager.h>
 #include <include/PipelineManager.h>
 #include <include/MeshManager.h>
 #include <include/MaterialRegistry.h>
+#include <include/BindlessTable.h>
 #include <include/ObjectRegistry.h>
+#include <include/GpuProfiler.h>
+#include <include/CpuProfiler.h>
+#include <include/FramePacer.h>
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    // Init SDL
-    DEBUG_ASSERT(SDL_Init(SDL_INIT_VIDEO));
-    atexit(SDL_Quit);
-    DEBUG_ASSERT(SDL_Vulkan_LoadLibrary(nullptr));
-    atexit(SDL_Vulkan_UnloadLibrary);
+    const std::optional<HeadlessConfig> headless = HeadlessConfig::FromArgs(argc, argv);
+
+    // Init SDL, headless runs have no display to open
+    if (!headless) {
+        DEBUG_ASSERT(SDL_Init(SDL_INIT_VIDEO));
+        atexit(SDL_Quit);
+        DEBUG_ASSERT(SDL_Vulkan_LoadLibrary(nullptr));
+        atexit(SDL_Vulkan_UnloadLibrary);
+    }
+
+    CpuProfiler::GetInstance().Init();
 
     // Initi glslang shader compiler
     glslang::InitializeProcess();
 
-    VulkanState::GetInstance().Init();
+    if (headless) {
+        VulkanState::GetInstance().InitHeadless(headless->width, headless->height);
+    } else {
+        const PresentSettings presentSettings = PresentSettings::FromArgs(argc, argv);
+        VulkanState::GetInstance().Init(presentSettings);
+        FramePacer::GetInstance().Init(presentSettings);
+    }
+    GpuProfiler::GetInstance().Init();
 
     PipelineManager::GetInstance().Init();
     MeshManager::GetInstance().Init();
     TextureManager::GetInstance().Init();
-    ThreadPool::GetInstance().WaitIdle();
+    {
+        PROFILE_ZONE("ThreadPool::WaitIdle");
+        ThreadPool::GetInstance().WaitIdle();
+    }
 
+    BindlessTable::GetInstance().Init();
     MaterialRegistry::GetInstance().Init();
     ObjectRegistry::GetInstance().Init();
 
-    Window::GetInstance().Run();
+    int result = EXIT_SUCCESS;
+    if (headless) {
+        HeadlessRunner runner(*headless);
+        result = runner.Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else {
+        Window::GetInstance().Run();
+    }
+
+    GpuProfiler::GetInstance().Destroy();
 
     ObjectRegistry::GetInstance().Destroy();
     MaterialRegistry::GetInstance().Destroy();
+    BindlessTable::GetInstance().Destroy();
     TextureManager::GetInstance().Destroy();
     MeshManager::GetInstance().Destroy();
     PipelineManager::GetInstance().Destroy();
 
     glslang::FinalizeProcess();
 
-    return 0;
+    return result;
 }